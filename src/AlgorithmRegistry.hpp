@@ -0,0 +1,167 @@
+/*
+ * Registry of pre-instantiated label setting algorithms that can be selected at runtime
+ * (e.g., by a command line flag). Each variant is a regular template instantiation with its
+ * own specialized inner loop; only the per-query entry points are dispatched virtually.
+ * This allows comparing several configurations on the same graph within a single process.
+ * LABEL_SETTING_ALGORITHM remains the compile-time default.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef ALGORITHM_REGISTRY_H_
+#define ALGORITHM_REGISTRY_H_
+
+#include "BiCritShortestPathAlgorithm.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include <new>
+
+#include "tbb/scalable_allocator.h"
+
+/** Thin type-erased interface of a label setting algorithm */
+class ShortestPathEngine {
+public:
+	virtual ~ShortestPathEngine() {}
+
+	virtual void run(const NodeID node) = 0;
+	virtual void run(const NodeID node, const NodeID target) = 0;
+	virtual void runGoalDirected(const NodeID node, const NodeID target) = 0;
+	virtual void setEpsilon(const double epsilon) = 0;
+	virtual void reset() = 0;
+	virtual void printStatistics() = 0;
+
+	virtual size_t size(const NodeID node) = 0;
+	/** False if the label sets cannot be iterated (BtreeParetoLabelSet) or contain sentinels (NodeHeapLabelSet) */
+	virtual bool iterable() const = 0;
+	/** Appends the labels of the given node to the vector. Requires iterable label sets */
+	virtual void labels(const NodeID node, std::vector<Label>& out) = 0;
+};
+
+template<typename algorithm_slot, bool iterable_label_sets=true>
+class EngineAdapter : public ShortestPathEngine {
+private:
+	algorithm_slot algo;
+
+	void appendLabels(const NodeID node, std::vector<Label>& out, std::true_type) {
+		out.insert(out.end(), algo.begin(node), algo.end(node));
+	}
+	void appendLabels(const NodeID, std::vector<Label>&, std::false_type) { }
+
+public:
+	template<typename... Args>
+	EngineAdapter(const Graph& graph, Args&&... args):
+		algo(graph, std::forward<Args>(args)...)
+	{}
+
+	/** The algorithm may have cache aligned members, which plain new ignores before C++17 */
+	static void* operator new(size_t size) {
+		void* const p = scalable_aligned_malloc(size, alignof(EngineAdapter));
+		if (p == NULL) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	static void operator delete(void* p) {
+		scalable_aligned_free(p);
+	}
+
+	void run(const NodeID node) override { algo.run(node); }
+	void run(const NodeID node, const NodeID target) override { algo.run(node, target); }
+	void runGoalDirected(const NodeID node, const NodeID target) override { algo.runGoalDirected(node, target); }
+	void setEpsilon(const double epsilon) override { algo.setEpsilon(epsilon); }
+	void reset() override { algo.reset(); }
+	void printStatistics() override { algo.printStatistics(); }
+
+	size_t size(const NodeID node) override { return algo.size(node); }
+	bool iterable() const override { return iterable_label_sets; }
+	void labels(const NodeID node, std::vector<Label>& out) override {
+		appendLabels(node, out, std::integral_constant<bool, iterable_label_sets>());
+	}
+};
+
+class AlgorithmRegistry {
+public:
+	typedef std::function<ShortestPathEngine*(const Graph&, unsigned short num_threads, bool use_worker_team)> Factory;
+
+	struct Variant {
+		std::string name;
+		std::string description;
+		Factory create;
+	};
+
+	/** All variants available in the current (sequential or parallel) build */
+	static const std::vector<Variant>& variants() {
+		static const std::vector<Variant> registry = createVariants();
+		return registry;
+	}
+
+	/** Returns nullptr if there is no variant of the given name */
+	static const Variant* find(const std::string& name) {
+		for (const Variant& variant : variants()) {
+			if (variant.name == name) {
+				return &variant;
+			}
+		}
+		return nullptr;
+	}
+
+	static std::unique_ptr<ShortestPathEngine> create(const std::string& name, const Graph& graph,
+			const unsigned short num_threads=my_default_thread_count, const bool use_worker_team=false) {
+		const Variant* variant = find(name);
+		return std::unique_ptr<ShortestPathEngine>(variant ? variant->create(graph, num_threads, use_worker_team) : nullptr);
+	}
+
+	static void printVariants(std::ostream& os) {
+		for (const Variant& variant : variants()) {
+			os << "#   " << variant.name << ": " << variant.description << std::endl;
+		}
+	}
+
+private:
+	template<typename algorithm_slot, bool iterable_label_sets=true>
+	static Variant sequential(const std::string& name, const std::string& description) {
+		return Variant{name, description, [](const Graph& graph, unsigned short, bool) -> ShortestPathEngine* {
+			return new EngineAdapter<algorithm_slot, iterable_label_sets>(graph);
+		}};
+	}
+
+	template<typename algorithm_slot, bool iterable_label_sets=true>
+	static Variant parallel(const std::string& name, const std::string& description) {
+		return Variant{name, description, [](const Graph& graph, unsigned short num_threads, bool use_worker_team) -> ShortestPathEngine* {
+			return new EngineAdapter<algorithm_slot, iterable_label_sets>(graph, num_threads, use_worker_team);
+		}};
+	}
+
+	static std::vector<Variant> createVariants() {
+		std::vector<Variant> registry;
+	#ifdef BTREE_PARETO_LABELSET
+		const bool btree_label_sets = true;
+	#else
+		const bool btree_label_sets = false;
+	#endif
+		const bool default_iterable = !btree_label_sets && !std::is_base_of<NodeHeapLabelSettingAlgorithm, LabelSettingAlgorithm>::value;
+		registry.push_back(parallel<LabelSettingAlgorithm, default_iterable>("default", "compile-time configuration: " STR(LABEL_SETTING_ALGORITHM)));
+	#ifdef PARALLEL_BUILD
+		registry.push_back(parallel<ParetoSearch<VectorParetoLabelSet<tbb::cache_aligned_allocator<Label>>>>("pareto-vector", "parallel ParetoSearch, vector label sets"));
+		registry.push_back(parallel<ParetoSearch<BtreeParetoLabelSet<tbb::cache_aligned_allocator<Label>>>, false>("pareto-btree", "parallel ParetoSearch, B-tree label sets"));
+		registry.push_back(parallel<ParetoSearch<VectorParetoLabelSet<tbb::cache_aligned_allocator<Label>>, ParallelBucketParetoQueue>>("pareto-vector-bucketpq", "parallel ParetoSearch, vector label sets, bucket queue (small integer weights)"));
+		registry.push_back(parallel<ParetoSearch<VectorParetoLabelSet<tbb::cache_aligned_allocator<Label>>, ParallelPartitionedParetoQueue>>("pareto-vector-partitionedpq", "parallel ParetoSearch, vector label sets, one B-tree queue per thread"));
+	#else
+		registry.push_back(sequential<ParetoSearch<VectorParetoLabelSet<std::allocator<Label>>, BTreeParetoQueue>>("pareto-vector", "ParetoSearch, vector label sets, B-tree queue"));
+		registry.push_back(sequential<ParetoSearch<BtreeParetoLabelSet<std::allocator<Label>>, BTreeParetoQueue>, false>("pareto-btree", "ParetoSearch, B-tree label sets, B-tree queue"));
+		registry.push_back(sequential<ParetoSearch<VectorParetoLabelSet<std::allocator<Label>>, VectorParetoQueue>>("pareto-vector-vectorpq", "ParetoSearch, vector label sets, vector queue"));
+		registry.push_back(sequential<ParetoSearch<BtreeParetoLabelSet<std::allocator<Label>>, VectorParetoQueue>, false>("pareto-btree-vectorpq", "ParetoSearch, B-tree label sets, vector queue"));
+		registry.push_back(sequential<ParetoSearch<VectorParetoLabelSet<std::allocator<Label>>, BucketParetoQueue>>("pareto-vector-bucketpq", "ParetoSearch, vector label sets, bucket queue (small integer weights)"));
+		registry.push_back(sequential<ParetoSearch<VectorParetoLabelSet<std::allocator<Label>>, PSTParetoQueue>>("pareto-vector-pstpq", "ParetoSearch, vector label sets, priority search tree queue"));
+	#endif
+		registry.push_back(sequential<SharedHeapLabelSettingAlgorithm>("sharedheap", "classic label setting, single heap of labels"));
+		registry.push_back(sequential<NodeHeapLabelSettingAlgorithm, false>("nodeheap", "classic label setting, heap of nodes"));
+		return registry;
+	}
+};
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ * Instance-aware selection of a registered algorithm variant (see AlgorithmRegistry.hpp).
+ * Cheap graph features (size, degree distribution, weight correlation) are computed once per
+ * graph. Per query, a short probing ParetoSearch from the source estimates how many labels the
+ * nodes will receive: Label sets grow with the distance to the source, so the labels per node
+ * within the probed region are scaled by the square root of the node count beyond it (planar-like
+ * road and grid graphs). As measured in timings/, the classic SharedHeap algorithm wins on
+ * instances with few labels per node (e.g., road1, correlated grids), the sequential ParetoSearch
+ * with B-tree label sets only pays off for very large label sets, and the parallel ParetoSearch
+ * needs enough labels per iteration to amortize its overhead (e.g., road2, uncorrelated grids).
+ * Nodes with an out-degree of at most two (chains in road graphs, rare in grids) only pass their
+ * labels on, so their relaxations are not counted as parallelizable work.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef ALGORITHM_SELECTOR_H_
+#define ALGORITHM_SELECTOR_H_
+
+#include "AlgorithmRegistry.hpp"
+
+#include <cmath>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <algorithm>
+
+struct GraphFeatures {
+	size_t nodes = 0;
+	size_t edges = 0;
+	size_t max_degree = 0;
+	double average_degree = 0;
+	double weight_correlation = 0; // pearson correlation of the two edge weights
+	std::vector<size_t> degree_count; // number of nodes per out-degree
+
+	void compute(const Graph& graph) {
+		nodes = graph.numberOfNodes();
+		edges = graph.numberOfEdges();
+		average_degree = nodes > 0 ? (double) edges / nodes : 0;
+
+		double sum_x = 0, sum_y = 0, sum_xx = 0, sum_yy = 0, sum_xy = 0;
+		FORALL_NODES(graph, node) {
+			const size_t degree = graph.numberOfEdges(node);
+			max_degree = std::max(max_degree, degree);
+			if (degree_count.size() <= degree) {
+				degree_count.resize(degree + 1);
+			}
+			degree_count[degree]++;
+
+			FORALL_EDGES(graph, node, eid) {
+				const Edge& edge = graph.getEdge(eid);
+				const double x = edge.first_weight;
+				const double y = edge.second_weight;
+				sum_x += x; sum_y += y;
+				sum_xx += x*x; sum_yy += y*y; sum_xy += x*y;
+			}
+		}
+		if (edges > 0) {
+			const double cov = sum_xy/edges - (sum_x/edges)*(sum_y/edges);
+			const double var_x = sum_xx/edges - (sum_x/edges)*(sum_x/edges);
+			const double var_y = sum_yy/edges - (sum_y/edges)*(sum_y/edges);
+			weight_correlation = var_x > 0 && var_y > 0 ? cov / std::sqrt(var_x * var_y) : 1;
+		}
+	}
+
+	/** Share of nodes with an out-degree of at most the given degree */
+	double degreeShare(const size_t degree) const {
+		size_t count = 0;
+		for (size_t i = 0; i <= degree && i < degree_count.size(); ++i) {
+			count += degree_count[i];
+		}
+		return nodes > 0 ? (double) count / nodes : 0;
+	}
+
+	std::string toString() const {
+		std::ostringstream out;
+		out << "nodes " << nodes << ", edges " << edges << ", degree avg " << average_degree << " max " << max_degree
+			<< " (<=2: " << degreeShare(2) * 100 << "%), weight correlation " << weight_correlation;
+		return out.str();
+	}
+};
+
+/** Outcome of the budget-limited probing search of a single query */
+struct ProbeFeatures {
+	size_t reached_nodes = 0;
+	size_t labels = 0;
+	size_t max_labels = 0; // largest label set
+	bool exhausted = false; // the search completed within the budget
+	double estimated_labels = 0; // extrapolated average label set size of the full search
+
+	double density() const { return reached_nodes > 0 ? (double) labels / reached_nodes : 0; }
+
+	std::string toString() const {
+		if (reached_nodes == 0) {
+			return "not probed";
+		}
+		std::ostringstream out;
+		out << "probe reached " << reached_nodes << " nodes, labels per node avg " << density() << " max " << max_labels
+			<< (exhausted ? ", complete" : ", extrapolated " + std::to_string(estimated_labels));
+		return out.str();
+	}
+};
+
+struct AlgorithmSelection {
+	const AlgorithmRegistry::Variant* variant;
+	unsigned short num_threads;
+	ProbeFeatures probe;
+
+	std::unique_ptr<ShortestPathEngine> create(const Graph& graph, const bool use_worker_team=false) const {
+		return std::unique_ptr<ShortestPathEngine>(variant->create(graph, num_threads, use_worker_team));
+	}
+
+	std::string toString() const {
+		std::ostringstream out;
+		out << variant->name << " (p " << num_threads << "), " << probe.toString();
+		return out.str();
+	}
+};
+
+class AlgorithmSelector {
+private:
+#ifdef PARALLEL_BUILD
+	typedef ParetoSearch<VectorParetoLabelSet<tbb::cache_aligned_allocator<Label>>> ProbeSearch;
+#else
+	typedef ParetoSearch<VectorParetoLabelSet<std::allocator<Label>>, VectorParetoQueue> ProbeSearch;
+#endif
+
+	const Graph& graph;
+	const unsigned short max_threads;
+	GraphFeatures graph_features;
+	std::unique_ptr<ProbeSearch> probe_search; // only created if a query needs probing
+	std::atomic<size_t> probe_checks;
+
+public:
+	AlgorithmSelector(const Graph& graph_, const unsigned short max_threads_=my_default_thread_count):
+		graph(graph_),
+	#ifdef PARALLEL_BUILD
+		max_threads(max_threads_),
+	#else
+		max_threads(std::min<unsigned short>(max_threads_, 1)), // all variants are sequential
+	#endif
+		probe_checks(0)
+	{
+		graph_features.compute(graph);
+	}
+
+	const GraphFeatures& features() const { return graph_features; }
+
+	/** Choose the variant for a query starting at the given source node */
+	AlgorithmSelection select(const NodeID source) {
+		AlgorithmSelection selection{AlgorithmRegistry::find("sharedheap"), 0, ProbeFeatures()};
+		if (graph_features.weight_correlation >= SELECTOR_CLASSIC_CORRELATION) {
+			return selection; // strongly correlated criteria: hardly any incomparable labels
+		}
+		selection.probe = probe(source);
+		const ProbeFeatures& p = selection.probe;
+		if (p.exhausted) {
+			return selection;
+		}
+		const bool large_label_sets = p.estimated_labels >= SELECTOR_BTREE_LABELSET_SIZE;
+		const double junction_share = 1 - graph_features.degreeShare(2);
+		const double estimated_relaxations = p.estimated_labels * graph_features.edges * junction_share;
+
+		if (max_threads > 1 && estimated_relaxations >= SELECTOR_PARALLEL_RELAXATIONS) {
+			selection.variant = AlgorithmRegistry::find(large_label_sets ? "pareto-btree" : "pareto-vector");
+			selection.num_threads = max_threads;
+		} else if (large_label_sets) {
+			// the sequential ParetoSearch only beats the classic algorithm on very large label sets
+			selection.variant = AlgorithmRegistry::find("pareto-btree");
+			#ifdef PARALLEL_BUILD
+				selection.num_threads = 1;
+			#endif
+		}
+		return selection;
+	}
+
+private:
+
+	ProbeFeatures probe(const NodeID source) {
+		if (!probe_search) {
+			#ifdef PARALLEL_BUILD
+				probe_search.reset(new ProbeSearch(graph, 1));
+			#else
+				probe_search.reset(new ProbeSearch(graph));
+			#endif
+		}
+		probe_checks = 0;
+		probe_search->runPruned(source, BudgetPruning(probe_checks, SELECTOR_PROBE_BUDGET));
+
+		ProbeFeatures features;
+		features.exhausted = probe_checks <= SELECTOR_PROBE_BUDGET;
+		FORALL_NODES(graph, node) {
+			const size_t size = probe_search->size(node);
+			if (size > 0) {
+				features.reached_nodes++;
+				features.labels += size;
+				features.max_labels = std::max(features.max_labels, size);
+			}
+		}
+		probe_search->reset();
+		if (features.reached_nodes > 0) {
+			features.estimated_labels = features.density() * std::sqrt((double) graph_features.nodes / features.reached_nodes);
+		}
+		return features;
+	}
+};
+
+#endif
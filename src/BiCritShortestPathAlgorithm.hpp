@@ -13,11 +13,14 @@
 #endif
 
 #ifdef PARALLEL_BUILD
+#define TBB_PREVIEW_TASK_ARENA 1 // task arenas are a preview feature of tbb 4.2
 #include "tbb/task_scheduler_init.h"
 #include "msp_pareto/ParetoSearch_parallel.hpp"
+#include "msp_pareto/ParetoSearchBatch.hpp"
 const unsigned short my_default_thread_count = tbb::task_scheduler_init::default_num_threads();
 #else
 #include "msp_pareto/ParetoSearch_sequential.hpp"
+#include "msp_pareto/BidirectionalParetoSearch.hpp"
 const unsigned short my_default_thread_count = 0;
 #endif
 
@@ -29,13 +32,13 @@ const unsigned short my_default_thread_count = 0;
 
 class LabelSettingAlgorithm : public LABEL_SETTING_ALGORITHM {
 public:
-	LabelSettingAlgorithm(const Graph& graph_, const unsigned short _num_threads=my_default_thread_count):
+	LabelSettingAlgorithm(const Graph& graph_, const unsigned short _num_threads=my_default_thread_count, const bool _use_worker_team=false):
 #ifdef PARALLEL_BUILD
-		LABEL_SETTING_ALGORITHM(graph_, _num_threads)
+		LABEL_SETTING_ALGORITHM(graph_, _num_threads, _use_worker_team)
 #else 
 		LABEL_SETTING_ALGORITHM(graph_)
 #endif
-	 {if(_num_threads == 0){} /* prevent unused variable warning */}
+	 {if(_num_threads == 0 && _use_worker_team){} /* prevent unused variable warning */}
 };
 
 #endif
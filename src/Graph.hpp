@@ -1,14 +1,60 @@
 #ifndef GRAPH_H_
 #define GRAPH_H_
 
+#include "options.hpp"
 #include "datastructures/graph/KGraph.hpp"
 #include "datastructures/graph/Edge.hpp"
 #include "datastructures/graph/GraphTypes.hpp"
 #include "datastructures/graph/GraphMacros.h"
 
-typedef utility::datastructure::IntegerBiWeightedEdge Edge;
+#include <iostream>
+#include <limits>
+#include <algorithm>
+
+typedef utility::datastructure::BiWeightedEdge<WEIGHT_TYPE> Edge;
 typedef utility::datastructure::KGraph<Edge> Graph;
 typedef typename Graph::NodeID NodeID;
 typedef typename Graph::EdgeID EdgeID;
 
+template<unsigned short D>
+struct MultiCriteriaGraphType {
+	typedef utility::datastructure::KGraph<utility::datastructure::MultiWeightedEdge<WEIGHT_TYPE, D>> type;
+};
+/** Bi-criteria graphs keep their two named edge weights */
+template<>
+struct MultiCriteriaGraphType<2> {
+	typedef Graph type;
+};
+template<unsigned short D>
+using MultiCriteriaGraph = typename MultiCriteriaGraphType<D>::type;
+
+/**
+ * Pareto optimal paths are simple, so their weights are bounded by the sum over all nodes of their
+ * largest outgoing edge weight (at most n times the largest edge weight). Warns and returns false
+ * if this bound does not fit WEIGHT_TYPE, as searches may then fail with std::overflow_error.
+ */
+inline bool checkWeightRange(const Graph& graph, std::ostream& out=std::cerr) {
+	typedef WEIGHT_TYPE weight_type;
+	const weight_type max = std::numeric_limits<weight_type>::max();
+	weight_type first_bound = 0;
+	weight_type second_bound = 0;
+
+	FORALL_NODES(graph, node) {
+		weight_type first = 0;
+		weight_type second = 0;
+		FORALL_EDGES(graph, node, eid) {
+			const Edge& edge = graph.getEdge(eid);
+			first = std::max<weight_type>(first, edge.first_weight);
+			second = std::max<weight_type>(second, edge.second_weight);
+		}
+		if (first > max - first_bound || second > max - second_bound) {
+			out << "# Warning: path weights may exceed " STR(WEIGHT_TYPE) ". Use a wider WEIGHT_TYPE" << std::endl;
+			return false;
+		}
+		first_bound += first;
+		second_bound += second;
+	}
+	return true;
+}
+
 #endif
\ No newline at end of file
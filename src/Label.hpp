@@ -1,6 +1,9 @@
 #include <iostream>
 #include <sstream>
 #include <limits>
+#include <cstdint>
+#include <cassert>
+#include <stdexcept>
 
 #include "Graph.hpp"
 
@@ -8,24 +11,57 @@
 #ifndef LABEL_HPP_
 #define LABEL_HPP_
 
-struct Label {
-	typedef unsigned int weight_type;
+/**
+ * Lexicographic order of two weights: Both are packed into one integer of twice the width and
+ * compared at once. The packed type is specialized per weight width.
+ */
+template<typename weight_type> struct PackedWeight { typedef void type; }; // no wider integer, compare one by one
+template<> struct PackedWeight<uint16_t> { typedef uint32_t type; };
+template<> struct PackedWeight<uint32_t> { typedef uint64_t type; };
+template<> struct PackedWeight<uint64_t> { typedef unsigned __int128 type; };
+
+template<typename weight_type, typename packed_type=typename PackedWeight<weight_type>::type>
+struct LexicographicOrder {
+	static inline packed_type pack(const weight_type first, const weight_type second) {
+		return (packed_type) first << (8 * sizeof(weight_type)) | second;
+	}
+	static inline bool less(const weight_type first1, const weight_type second1, const weight_type first2, const weight_type second2) {
+		return pack(first1, second1) < pack(first2, second2);
+	}
+};
+
+template<typename weight_type>
+struct LexicographicOrder<weight_type, void> {
+	static inline bool less(const weight_type first1, const weight_type second1, const weight_type first2, const weight_type second2) {
+		return first1 < first2 || (first1 == first2 && second1 < second2);
+	}
+};
+
+template<typename weight_type_slot>
+struct BiCriteriaLabel {
+	typedef weight_type_slot weight_type;
+	typedef typename PackedWeight<weight_type>::type packed_type;
 	weight_type first_weight;
 	weight_type second_weight;
 
-	inline Label(const weight_type& first_weight_=0, const weight_type& second_weight_=0)
+	inline BiCriteriaLabel(const weight_type& first_weight_=0, const weight_type& second_weight_=0)
 		: first_weight( first_weight_ ), second_weight( second_weight_ ) 
 	{}
 
-	inline uint64_t combinedWeight() const {
-		return (uint64_t) first_weight << 32 | second_weight;
+	/** Both weights packed into one integer of twice the width */
+	inline packed_type combinedWeight() const {
+		return LexicographicOrder<weight_type>::pack(first_weight, second_weight);
 	}
 
-	inline bool operator==(const Label& other) const {
+	inline bool lexLess(const BiCriteriaLabel& other) const {
+		return LexicographicOrder<weight_type>::less(first_weight, second_weight, other.first_weight, other.second_weight);
+	}
+
+	inline bool operator==(const BiCriteriaLabel& other) const {
 		return other.first_weight == first_weight && other.second_weight == second_weight;
 	}
 
-	inline bool operator!=(const Label& other) const {
+	inline bool operator!=(const BiCriteriaLabel& other) const {
 		return other.first_weight != first_weight || other.second_weight != second_weight;
 	}
 
@@ -35,12 +71,14 @@ struct Label {
 		return oss.str();
 	}
 
-	friend std::ostream& operator<<(std::ostream& os, const Label& data) {
+	friend std::ostream& operator<<(std::ostream& os, const BiCriteriaLabel& data) {
 		os << " (" << data.first_weight << "," << data.second_weight << ")";
 		return os;
 	}
 };
 
+typedef BiCriteriaLabel<WEIGHT_TYPE> Label;
+
 struct NodeLabel : public Label {
 	typedef utility::datastructure::NodeID NodeID;
 	NodeID node;
@@ -62,6 +100,38 @@ struct NodeLabel : public Label {
 const Label::weight_type MIN_WEIGHT = std::numeric_limits<Label::weight_type>::min();
 const Label::weight_type MAX_WEIGHT = std::numeric_limits<Label::weight_type>::max();
 
+/**
+ * The label scaled by (1+epsilon), saturated at MAX_WEIGHT. Every label that (weakly) dominates
+ * the scaled label epsilon-dominates the original one.
+ */
+inline Label epsilonScaled(const Label& label, const double epsilon) {
+	const double first = label.first_weight * (1.0 + epsilon);
+	const double second = label.second_weight * (1.0 + epsilon);
+	return Label(first >= MAX_WEIGHT ? MAX_WEIGHT : (Label::weight_type) first,
+		second >= MAX_WEIGHT ? MAX_WEIGHT : (Label::weight_type) second);
+}
+
+/**
+ * Sum of two path or edge weights. Weights are unsigned, so a sum smaller than a summand wrapped
+ * around WEIGHT_TYPE. As wrapped weights silently break all dominance checks, this is checked in
+ * release builds, too (see checkWeightRange).
+ */
+template<typename weight_type>
+inline weight_type checkedAdd(const weight_type a, const weight_type b) {
+	const weight_type sum = a + b;
+	if (__builtin_expect(sum < a, false)) {
+		throw std::overflow_error("path weights exceed " STR(WEIGHT_TYPE) ". Use a wider WEIGHT_TYPE");
+	}
+	return sum;
+}
+
+/** The label extended by the weights of an edge (or of another label). Throws std::overflow_error */
+template<typename weights_type>
+inline Label extended(const Label& label, const weights_type& weights) {
+	return Label(checkedAdd<Label::weight_type>(label.first_weight, weights.first_weight),
+		checkedAdd<Label::weight_type>(label.second_weight, weights.second_weight));
+}
+
 struct GroupNodeLabelsByNodeComperator {
 	inline bool operator() (const NodeLabel& i, const NodeLabel& j) const {
 		return i.node < j.node;
@@ -70,14 +140,14 @@ struct GroupNodeLabelsByNodeComperator {
 
 struct GroupLabelsByWeightComperator {
 	inline bool operator() (const Label& i, const Label& j) const {
-		return i.combinedWeight() < j.combinedWeight();
+		return i.lexLess(j);
 	}
 };
 
 template<typename op_type>
 struct GroupOperationsByWeightComperator {
 	inline bool operator() (const op_type& i, const op_type& j) const {
-	    return i.data.combinedWeight() < j.data.combinedWeight(); 
+	    return i.data.lexLess(j.data);
 	}
 };
 
@@ -0,0 +1,179 @@
+/*
+ * Labels with a compile-time number of criteria D >= 2. For D == 2, MultiCriteriaLabel and
+ * MultiCriteriaNodeLabel are the bi-criteria Label and NodeLabel, so that generic code runs on
+ * the specialized bi-criteria types. More criteria are stored in a std::array.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef MULTI_CRITERIA_LABEL_HPP_
+#define MULTI_CRITERIA_LABEL_HPP_
+
+#include "Label.hpp"
+
+#include <array>
+#include <algorithm>
+#include <cassert>
+
+template<unsigned short D>
+struct WeightVectorLabel {
+	static_assert(D >= 2, "A multi-criteria label needs at least two criteria");
+	static const unsigned short dimension = D;
+
+	typedef Label::weight_type weight_type;
+	std::array<weight_type, D> weights;
+
+	inline WeightVectorLabel() {
+		weights.fill(0);
+	}
+
+	inline WeightVectorLabel(const std::array<weight_type, D>& weights_)
+		: weights(weights_)
+	{}
+
+	inline weight_type& operator[](const size_t i) { return weights[i]; }
+	inline const weight_type& operator[](const size_t i) const { return weights[i]; }
+
+	inline bool operator==(const WeightVectorLabel& other) const {
+		return weights == other.weights;
+	}
+
+	inline bool operator!=(const WeightVectorLabel& other) const {
+		return weights != other.weights;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const WeightVectorLabel& data) {
+		os << " (";
+		for (unsigned short i = 0; i < D; ++i) {
+			os << (i > 0 ? "," : "") << data.weights[i];
+		}
+		os << ")";
+		return os;
+	}
+};
+
+template<unsigned short D>
+struct WeightVectorNodeLabel : public WeightVectorLabel<D> {
+	typedef utility::datastructure::NodeID NodeID;
+	NodeID node;
+
+	inline WeightVectorNodeLabel() : WeightVectorLabel<D>(), node(0) {}
+	inline WeightVectorNodeLabel(const NodeID& x, const WeightVectorLabel<D>& y)
+		: WeightVectorLabel<D>(y), node(x)
+	{}
+
+	friend std::ostream& operator<<(std::ostream& os, const WeightVectorNodeLabel& data) {
+		os << " (" << data.node << ":" << static_cast<const WeightVectorLabel<D>&>(data) << ")";
+		return os;
+	}
+};
+
+/**
+ * Label types and their order and dominance relations for D criteria. Within a lexicographically
+ * sorted sequence, a label can only be dominated by its predecessors. As these already agree in
+ * the first criterion, dominatesSuccessor() skips it.
+ */
+template<unsigned short D>
+struct CriteriaTraits {
+	typedef WeightVectorLabel<D> Label;
+	typedef WeightVectorNodeLabel<D> NodeLabel;
+
+	/** Sorted pareto sets are staircases: a label is only dominated if its direct predecessor dominates it */
+	static constexpr bool staircase = false;
+
+	static inline bool lexLess(const Label& a, const Label& b) {
+		return std::lexicographical_compare(a.weights.begin(), a.weights.end(), b.weights.begin(), b.weights.end());
+	}
+
+	/** a is (weakly) better than b in all criteria */
+	static inline bool dominates(const Label& a, const Label& b) {
+		for (unsigned short i = 0; i < D; ++i) {
+			if (a[i] > b[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Same as dominates(a, b), but requires a to be lexicographically smaller or equal */
+	static inline bool dominatesSuccessor(const Label& a, const Label& b) {
+		for (unsigned short i = 1; i < D; ++i) {
+			if (a[i] > b[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** The label extended by the weights of the edge (see extended() in Label.hpp) */
+	template<typename edge_type>
+	static inline Label extended(const Label& label, const edge_type& edge) {
+		Label sum;
+		for (unsigned short i = 0; i < D; ++i) {
+			sum[i] = checkedAdd<typename Label::weight_type>(label[i], edge.weights[i]);
+		}
+		return sum;
+	}
+};
+
+/**
+ * Bi-criteria fast path: The bi-criteria Label, compared via its packed lexicographic order
+ * and with fixed comparisons of its two weights.
+ */
+template<>
+struct CriteriaTraits<2> {
+	typedef ::Label Label;
+	typedef ::NodeLabel NodeLabel;
+	static constexpr bool staircase = true;
+
+	static inline bool lexLess(const Label& a, const Label& b) {
+		return a.lexLess(b);
+	}
+
+	static inline bool dominates(const Label& a, const Label& b) {
+		return a.first_weight <= b.first_weight && a.second_weight <= b.second_weight;
+	}
+
+	static inline bool dominatesSuccessor(const Label& a, const Label& b) {
+		return a.second_weight <= b.second_weight;
+	}
+
+	template<typename edge_type>
+	static inline Label extended(const Label& label, const edge_type& edge) {
+		return ::extended(label, edge);
+	}
+};
+
+template<unsigned short D>
+using MultiCriteriaLabel = typename CriteriaTraits<D>::Label;
+
+template<unsigned short D>
+using MultiCriteriaNodeLabel = typename CriteriaTraits<D>::NodeLabel;
+
+template<unsigned short D>
+struct GroupMultiCriteriaLabelsByWeightComperator {
+	inline bool operator() (const MultiCriteriaLabel<D>& i, const MultiCriteriaLabel<D>& j) const {
+		return CriteriaTraits<D>::lexLess(i, j);
+	}
+};
+
+template<unsigned short D>
+struct GroupMultiCriteriaNodeLabelsByWeightAndNodeComperator {
+	inline bool operator() (const MultiCriteriaNodeLabel<D>& i, const MultiCriteriaNodeLabel<D>& j) const {
+		if (static_cast<const MultiCriteriaLabel<D>&>(i) == j) {
+			return i.node < j.node;
+		}
+		return CriteriaTraits<D>::lexLess(i, j);
+	}
+};
+
+template<unsigned short D>
+struct GroupMultiCriteriaNodeLabelsByNodeAndWeightComperator {
+	inline bool operator() (const MultiCriteriaNodeLabel<D>& i, const MultiCriteriaNodeLabel<D>& j) const {
+		if (i.node == j.node) {
+			return CriteriaTraits<D>::lexLess(i, j);
+		}
+		return i.node < j.node;
+	}
+};
+
+#endif
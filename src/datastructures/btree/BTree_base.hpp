@@ -30,10 +30,13 @@
 #include <cstddef>
 #include <assert.h>
 #include <array>
+#include <type_traits>
 #include <unistd.h>
 #include <cmath>
 #include <string.h>
 #include "../NullData.hpp"
+#include "LeafSlots.hpp"
+#include "NodeArena.hpp"
 
 #include "../../options.hpp"
 
@@ -89,6 +92,15 @@ struct btree_default_traits {
     /// Configure nodes to have a fixed size of X cache lines. 
     static const unsigned int leafparameter_k = BTREE_MAX( 8, LEAF_PARAMETER_K );
     static const unsigned int branchingparameter_b = BTREE_MAX( 8, BRANCHING_PARAMETER_B );
+
+    /// If true, leaves store each member of their keys in a separate array (see LeafSlots.hpp)
+    static const bool soa_leaves = false;
+};
+
+/// Traits of a tree with leaves that store each member of its (weight, weight, node) keys in a separate array
+template <typename _Key, typename _MinKey>
+struct btree_soa_traits : public btree_default_traits<_Key, _MinKey> {
+    static const bool soa_leaves = true;
 };
 
 template <typename _Key,
@@ -145,33 +157,21 @@ public:
     static const width_type         innerslotmax =  traits::branchingparameter_b * 4;
     static const width_type         innerslotmin =  traits::branchingparameter_b / 4;
 
+    /// Key storage of the leaves, selected by traits::soa_leaves
+    typedef typename std::conditional<traits::soa_leaves, soa_leaf_slots<key_type, leafslotmax>,
+        aos_leaf_slots<key_type, leafslotmax>>::type leaf_slots;
+
+    /// Keys are read from array of struct leaves by reference and from soa leaves by value
+    typedef typename std::conditional<traits::soa_leaves, key_type, const key_type&>::type leaf_key_type;
+
 protected:
 
     explicit inline btree_base(const allocator_type &alloc=allocator_type())
         : root(NULL), allocator(alloc) { 
-
-        #ifdef PARALLEL_BUILD
-        #else
-            spare_leaf = allocate_leaf_without_count();
-            spare_inner = allocate_inner_without_count(0);
-        #endif
     }
 
     inline ~btree_base() {
         clear();
-        #ifdef PARALLEL_BUILD
-            for (auto& data : tls_data) {
-                if (data.spare_leaf != NULL) {
-                    free_node_without_count(data.spare_leaf);
-                }
-                if (data.spare_inner != NULL) {
-                    free_node_without_count(data.spare_inner);
-                }
-            }
-        #else
-            free_node_without_count(spare_leaf);
-            free_node_without_count(spare_inner);
-        #endif
     }
 
     // *** Node Classes for In-Memory Nodes
@@ -182,6 +182,9 @@ protected:
 
         width_type slotuse;
 
+        /// Reference of the node within the node arena of the tree
+        uint32_t ref;
+
         /// Delayed initialisation of constructed node
         inline void initialize(const level_type l) {
             level = l;
@@ -197,9 +200,11 @@ protected:
         /// Heighest key in the subtree with the same slot index
         key_type        slotkey;
         /// Weight (total number of keys) of the subtree 
-        size_type       weight;
-        /// Pointers to children
-        node*           childid;
+        uint32_t        weight;
+        /// Arena reference of the child (see child())
+        uint32_t        childid;
+        /// Number of keys in the subtree marked for deletion by the next update (see leaf_node::mark)
+        uint32_t        marked;
     #ifdef COMPUTE_PARETO_MIN
         /// Heighest key in the subtree with the same slot index
         min_key_type    minimum; 
@@ -207,9 +212,6 @@ protected:
     };
 
     struct inner_node : public node {
-        /// Define an related allocator for the inner_node structs.
-        typedef typename _Alloc::template rebind<inner_node>::other alloc_type;
-
         inner_node_data slot[innerslotmax];
 
         /// Set variables to initial values
@@ -219,15 +221,84 @@ protected:
     };
 
     struct leaf_node : public node {
-        /// Define an related allocator for the leaf_node structs.
-        typedef typename _Alloc::template rebind<leaf_node>::other alloc_type;
-
         /// Keys of children or data pointers
-        key_type        slotkey[leafslotmax];
+        leaf_slots      slotkey;
+
+        /// Bitmask of the keys to be dropped by the next update of this leaf
+        uint64_t        marks[(leafslotmax + 63) / 64];
+
+    #if defined(COMPUTE_PARETO_MIN) && defined(CACHED_LEAF_STAIRCASE)
+        /// Bitmask of the keys that are pareto minima within this leaf. Recorded when the minimum
+        /// of the leaf is computed by a full scan (see set_min_element) and invalid otherwise
+        uint64_t        staircase[(leafslotmax + 63) / 64];
+        bool            staircase_valid;
+    #endif
 
         /// Set variables to initial values
         inline void initialize() {
             node::initialize(0);
+            std::fill(marks, marks + (leafslotmax + 63) / 64, 0);
+        #if defined(COMPUTE_PARETO_MIN) && defined(CACHED_LEAF_STAIRCASE)
+            staircase_valid = false;
+        #endif
+        }
+
+        /// Superset of the pareto minima of this leaf for any prefix minimum, or NULL if the
+        /// minima search has to scan all keys
+        inline const uint64_t* cached_staircase() const {
+        #if defined(COMPUTE_PARETO_MIN) && defined(CACHED_LEAF_STAIRCASE)
+            return staircase_valid ? staircase : NULL;
+        #else
+            return NULL;
+        #endif
+        }
+
+        inline bool is_marked(const width_type slot) const {
+            return (marks[slot / 64] >> (slot % 64)) & 1;
+        }
+
+        /// Delete the key without searching it again. The caller has to increment
+        /// the marked counters of all slots on the path to this leaf.
+        inline void mark(const width_type slot) {
+            marks[slot / 64] |= uint64_t(1) << (slot % 64);
+        }
+
+        /// Number of marked keys in front of the given slot
+        inline width_type marked_before(const width_type slot) const {
+            width_type count = 0;
+            for (width_type w = 0; w < slot / 64; ++w) {
+                count += __builtin_popcountll(marks[w]);
+            }
+            if (slot % 64 != 0) {
+                count += __builtin_popcountll(marks[slot / 64] & ((uint64_t(1) << (slot % 64)) - 1));
+            }
+            return count;
+        }
+
+        inline leaf_key_type key(const width_type slot) const {
+            return slotkey.get(slot);
+        }
+
+        inline void set_key(const width_type slot, const key_type& value) {
+            slotkey.set(slot, value);
+        }
+
+        /// Drop the marked keys in place
+        inline void remove_marked() {
+            width_type out = 0;
+            for (width_type in = 0; in < node::slotuse; ++in) {
+                if (!is_marked(in)) {
+                    if (out != in) {
+                        set_key(out, key(in));
+                    }
+                    ++out;
+                }
+            }
+            node::slotuse = out;
+            std::fill(marks, marks + (leafslotmax + 63) / 64, 0);
+        #if defined(COMPUTE_PARETO_MIN) && defined(CACHED_LEAF_STAIRCASE)
+            staircase_valid = false;
+        #endif
         }
     };
 
@@ -236,6 +307,7 @@ protected:
         size_type weight;
         size_type upd_begin;
         size_type upd_end;
+        bool has_marked_keys;
     };
     typedef std::array<UpdateDescriptor, innerslotmax> UpdateDescriptorArray;
 
@@ -363,67 +435,74 @@ protected:
 protected:
     // *** Node Object Allocation and Deallocation Functions
 
-    inline typename leaf_node::alloc_type leaf_node_allocator() {
-        return typename leaf_node::alloc_type(allocator);
+    /// Leaves and inner nodes are stored in separate arenas, distinguished by the tag bit of their references
+    static const uint32_t leaf_ref_tag = 1u << 31;
+    typedef NodeArena<leaf_node, leaf_ref_tag, 6> leaf_arena_type;
+    typedef NodeArena<inner_node, 0, 8> inner_arena_type;
+
+    /// Pointer to the child node of an inner node slot
+    inline node* child(const inner_node_data& slot) const {
+        if (slot.childid & leaf_ref_tag) {
+            return leaf_arena.get(slot.childid);
+        } else {
+            return inner_arena.get(slot.childid);
+        }
+    }
+
+    inline typename leaf_arena_type::Cache& leaf_cache() {
+        #ifdef PARALLEL_BUILD
+            return tls_data.local().leaf_cache;
+        #else
+            return leaf_cache_;
+        #endif
     }
 
-    inline typename inner_node::alloc_type inner_node_allocator() {
-        return typename inner_node::alloc_type(allocator);
+    inline typename inner_arena_type::Cache& inner_cache() {
+        #ifdef PARALLEL_BUILD
+            return tls_data.local().inner_cache;
+        #else
+            return inner_cache_;
+        #endif
     }
 
     inline leaf_node* allocate_leaf() {
-        leaf_node *n = new (leaf_node_allocator().allocate(1)) leaf_node();
-        n->initialize();
+        leaf_node *n = allocate_leaf_without_count();
         if (stats.gather_stats) stats.leaves.fetch_and_increment();
         return n;
     }
 
     inline leaf_node* allocate_leaf_without_count() {
-        leaf_node *n = new (leaf_node_allocator().allocate(1)) leaf_node();
+        leaf_node *n = leaf_arena.allocate(leaf_cache());
         n->initialize();
         return n;
     }
 
     inline inner_node* allocate_inner(level_type level) {
-        inner_node *n = new (inner_node_allocator().allocate(1)) inner_node();
-        n->initialize(level);
+        inner_node *n = allocate_inner_without_count(level);
         if (stats.gather_stats) stats.innernodes.fetch_and_increment();
         return n;
     }
 
     inline inner_node* allocate_inner_without_count(level_type level) {
-        inner_node *n = new (inner_node_allocator().allocate(1)) inner_node();
+        inner_node *n = inner_arena.allocate(inner_cache());
         n->initialize(level);
         return n;
     }
 
     inline void free_node(node *n) {
+        free_node_without_count(n);
         if (n->isleafnode()) {
-            leaf_node *ln = static_cast<leaf_node*>(n);
-            typename leaf_node::alloc_type a(leaf_node_allocator());
-            a.destroy(ln);
-            a.deallocate(ln, 1);
             if (stats.gather_stats) stats.leaves.fetch_and_decrement();
         } else {
-            inner_node *in = static_cast<inner_node*>(n);
-            typename inner_node::alloc_type a(inner_node_allocator());
-            a.destroy(in);
-            a.deallocate(in, 1);
             if (stats.gather_stats) stats.innernodes.fetch_and_decrement();
         }
     }
 
-    inline void free_node_without_count(node *n) {
+    inline void free_node_without_count(const node *n) {
         if (n->isleafnode()) {
-            leaf_node *ln = static_cast<leaf_node*>(n);
-            typename leaf_node::alloc_type a(leaf_node_allocator());
-            a.destroy(ln);
-            a.deallocate(ln, 1);
+            leaf_arena.release(leaf_cache(), static_cast<const leaf_node*>(n));
         } else {
-            inner_node *in = static_cast<inner_node*>(n);
-            typename inner_node::alloc_type a(inner_node_allocator());
-            a.destroy(in);
-            a.deallocate(in, 1);
+            inner_arena.release(inner_cache(), static_cast<const inner_node*>(n));
         }
     }
 
@@ -448,7 +527,7 @@ protected:
             inner_node *innernode = static_cast<inner_node*>(n);
 
             for (width_type slot = 0; slot < innernode->slotuse; ++slot) {
-                clear_recursive(innernode->slot[slot].childid);
+                clear_recursive(child(innernode->slot[slot]));
             }
         }
         free_node(n);
@@ -456,7 +535,7 @@ protected:
 
 
     static inline bool hasUpdates(const UpdateDescriptor& update) {
-        return update.upd_begin != update.upd_end;
+        return update.upd_begin != update.upd_end || update.has_marked_keys;
     }
 
     inline weightdelta_type getWeightDelta(const size_type upd_begin, const size_type upd_end) const {
@@ -467,11 +546,12 @@ protected:
         }
     }
 
-    inline bool scheduleSubTreeUpdate(const width_type i, const size_type& weight, const size_type minweight,
+    inline bool scheduleSubTreeUpdate(const width_type i, const inner_node_data& slot, const size_type minweight,
             const size_type maxweight, const size_type subupd_begin, const size_type subupd_end, UpdateDescriptorArray& subtree_updates) const {
         subtree_updates[i].upd_begin = subupd_begin;
         subtree_updates[i].upd_end = subupd_end;
-        subtree_updates[i].weight = weight + getWeightDelta(subupd_begin, subupd_end);
+        subtree_updates[i].has_marked_keys = slot.marked > 0;
+        subtree_updates[i].weight = slot.weight - slot.marked + getWeightDelta(subupd_begin, subupd_end);
         subtree_updates[i].rebalancing_needed =  subtree_updates[i].weight < minweight || subtree_updates[i].weight > maxweight;
         return subtree_updates[i].rebalancing_needed;
     }
@@ -532,7 +612,7 @@ protected:
     }
 
     /// Recursively descend down the tree and print out nodes.
-    static void print_node(const node* node, level_type depth=0, bool recursive=false) {
+    void print_node(const node* node, level_type depth=0, bool recursive=false) const {
         for(level_type i = 0; i < depth; i++) std::cout  << "  ";
         std::cout << "node " << node << " level " << node->level << " slotuse " << node->slotuse << std::endl;
 
@@ -541,7 +621,7 @@ protected:
             for(level_type i = 0; i < depth; i++) std::cout  << "  ";
 
             for (width_type slot = 0; slot < leafnode->slotuse; ++slot) {
-                std::cout << leafnode->slotkey[slot] << "  "; // << "(data: " << leafnode->slotdata[slot] << ") ";
+                std::cout << leafnode->key(slot) << "  "; // << "(data: " << leafnode->slotdata[slot] << ") ";
             }
             std::cout  << std::endl;
         } else {
@@ -555,7 +635,7 @@ protected:
 
             if (recursive) {
                 for (width_type slot = 0; slot < innernode->slotuse; ++slot) {
-                    print_node(innernode->slot[slot].childid, depth + 1, recursive);
+                    print_node(child(innernode->slot[slot]), depth + 1, recursive);
                 }
             }
         }
@@ -593,7 +673,7 @@ protected:
             const leaf_node *leaf = static_cast<const leaf_node*>(n);
 
             for(width_type slot = 0; slot < leaf->slotuse - 1; ++slot) {
-                assert(key_lessequal(leaf->slotkey[slot], leaf->slotkey[slot + 1]));
+                assert(key_lessequal(leaf->key(slot), leaf->key(slot + 1)));
             }
             if ((leaf != root && !(leaf->slotuse >= minweight(leaf->level))) || !( leaf->slotuse <= maxweight(leaf->level))) {
                 std::cout << leaf->slotuse << " min " << minweight(0) << " max " <<maxweight(0) << std::endl;
@@ -602,8 +682,8 @@ protected:
             assert( leaf == root || leaf->slotuse >= minweight(leaf->level) );
             assert( leaf->slotuse <= maxweight(leaf->level) );
 
-            *minkey = leaf->slotkey[0];
-            *maxkey = leaf->slotkey[leaf->slotuse - 1];
+            *minkey = leaf->key(0);
+            *maxkey = leaf->key(leaf->slotuse - 1);
 
             vstats.leaves++;
             vstats.itemcount += leaf->slotuse;
@@ -620,7 +700,7 @@ protected:
             }
 
             for(width_type slot = 0; slot < inner->slotuse; ++slot) {
-                const node *subnode = inner->slot[slot].childid;
+                const node *subnode = child(inner->slot[slot]);
                 key_type subminkey = key_type();
                 key_type submaxkey = key_type();
 
@@ -657,21 +737,69 @@ protected:
 
 #ifdef COMPUTE_PARETO_MIN
 
-    static inline void set_min_element(inner_node_data& slot, const leaf_node* const node) {
-        slot.minimum = *std::min_element(node->slotkey, node->slotkey+node->slotuse,
-            [](const min_key_type& i, const min_key_type& j) { return i.second_weight < j.second_weight; });
+    static inline void set_min_element(inner_node_data& slot, leaf_node* const node) {
+        const typename min_key_type::weight_type max = std::numeric_limits<typename min_key_type::weight_type>::max();
+        if (node->slotuse == 0) {
+            // Left behind by keys removed in place. Cannot be part of any minima search
+            slot.minimum = min_key_type(max, max);
+            return;
+        }
+    #ifdef CACHED_LEAF_STAIRCASE
+        // The leaf is scanned anyway, so record its staircase for the next minima search
+        std::fill(node->staircase, node->staircase + (leafslotmax + 63) / 64, 0);
+        min_key_type local_min(0, max);
+        for (width_type i = 0; i < node->slotuse; ++i) {
+            const key_type key = node->key(i);
+            if (key.second_weight < local_min.second_weight
+                    || (key.first_weight == local_min.first_weight && key.second_weight == local_min.second_weight)) {
+                node->staircase[i / 64] |= uint64_t(1) << (i % 64);
+                local_min = key;
+            }
+        }
+        node->staircase_valid = true;
+        slot.minimum = local_min;
+    #else
+        width_type min = 0;
+        for (width_type i = 1; i < node->slotuse; ++i) {
+            min = node->key(i).second_weight < node->key(min).second_weight ? i : min;
+        }
+        slot.minimum = node->key(min);
+    #endif
     }
 
     static inline void set_min_element(inner_node_data& slot, const min_key_type& local) {
         slot.minimum = local;
     }
 
+    static inline void update_min_element(min_key_type& local_min, const key_type& key) {
+        if (key.second_weight < local_min.second_weight) {
+            local_min = key;
+        }
+    }
+
     static inline void set_min_element(inner_node_data& slot, const inner_node* const node) {
         slot.minimum = std::min_element(node->slot, node->slot+node->slotuse,
             [](const inner_node_data& i, const inner_node_data& j) { return i.minimum.second_weight < j.minimum.second_weight; })->minimum;
     }
+
+    /// Restore weight and minimum of a slot after keys have been removed in place from its subtree.
+    /// Inner nodes of the subtree have to be fixed first. Underfull nodes are rebalanced by the next update.
+    inline void fix_slot_after_removal(inner_node_data& slot) const {
+        node* const n = child(slot);
+        if (n->isleafnode()) {
+            slot.weight = n->slotuse;
+            set_min_element(slot, static_cast<leaf_node*>(n));
+        } else {
+            const inner_node* const inner = static_cast<const inner_node*>(n);
+            slot.weight = 0;
+            for (width_type i = 0; i < inner->slotuse; ++i) {
+                slot.weight += inner->slot[i].weight;
+            }
+            set_min_element(slot, inner);
+        }
+    }
 #else 
-    static inline void set_min_element(inner_node_data&, const leaf_node* const) {
+    static inline void set_min_element(inner_node_data&, leaf_node* const) {
     }
     static inline void set_min_element(inner_node_data&, const min_key_type&) {
     }
@@ -681,14 +809,15 @@ protected:
     width_type create_subtree_from_leaves(inner_node_data& slot, const width_type old_slotuse, const bool reuse_node, const level_type level, size_type rank_begin, size_type rank_end, const leaf_list& leaves) {
         BTREE_ASSERT(rank_end - rank_begin > 0);
         BTREE_PRINT("Creating tree on level " << level << " for range [" << rank_begin << ", " << rank_end << ")" << std::endl);
+        slot.marked = 0;
 
         if (level == 0) { // reached leaf level
             // Just re-use the pre-alloced and filled leaf
             leaf_node* result = leaves[rank_begin / designated_leafsize];
             result->slotuse = rank_end - rank_begin;
             set_min_element(slot, result);
-            update_router(slot.slotkey, result->slotkey[result->slotuse-1]);
-            slot.childid = result;
+            update_router(slot.slotkey, result->key(result->slotuse-1));
+            slot.childid = result->ref;
             return 1;
         } else {
             const size_type designated_treesize = designated_subtreesize(level);
@@ -702,11 +831,11 @@ protected:
 
             inner_node* result = NULL;
             if (reuse_node) {
-                result = static_cast<inner_node*>(slot.childid);
+                result = static_cast<inner_node*>(child(slot));
             } else {
                 result = allocate_inner(level);
                 result->slotuse = new_slotuse;
-                slot.childid = result;
+                slot.childid = result->ref;
             }
             BTREE_ASSERT(new_slotuse <= innerslotmax);
 
@@ -755,10 +884,10 @@ protected:
             size_type subupd_begin = upd_begin;
             for (width_type i = 0; i < last; ++i) {
                 size_type subupd_end = find_lower(subupd_begin, upd_end, inner->slot[i].slotkey);
-                scheduleSubTreeUpdate(i, inner->slot[i].weight, 0, 0, subupd_begin, subupd_end, subtree_updates);
+                scheduleSubTreeUpdate(i, inner->slot[i], 0, 0, subupd_begin, subupd_end, subtree_updates);
                 subupd_begin = subupd_end;
             } 
-            scheduleSubTreeUpdate(last, inner->slot[last].weight, 0, 0, subupd_begin, upd_end, subtree_updates);
+            scheduleSubTreeUpdate(last, inner->slot[last], 0, 0, subupd_begin, upd_end, subtree_updates);
 
             rewriteSubTreesInRange(inner, 0, inner->slotuse, rank, subtree_updates, leaves);
         }
@@ -766,13 +895,14 @@ protected:
     }
 
     void update(inner_node_data& slot, const size_type upd_begin, const size_type upd_end) {
-        BTREE_PRINT("Applying updates [" << upd_begin << ", " << upd_end << ") to " << slot.childid << " on level " << slot.childid->level << std::endl);
+        node* const child_node = child(slot);
+        BTREE_PRINT("Applying updates [" << upd_begin << ", " << upd_end << ") to " << child_node << " on level " << child_node->level << std::endl);
 
-        if (slot.childid->isleafnode()) {
+        if (child_node->isleafnode()) {
             update_leaf_in_current_tree(slot, upd_begin, upd_end);
 
         } else {
-            inner_node* const inner = static_cast<inner_node*>(slot.childid);
+            inner_node* const inner = static_cast<inner_node*>(child_node);
             const size_type max_weight = maxweight(inner->level-1);
             const size_type min_weight = max_weight / 4;
             #ifdef PARALLEL_BUILD
@@ -789,10 +919,10 @@ protected:
             size_type subupd_begin = upd_begin;
             for (width_type i = 0; i < lastslot; ++i) {
                 size_type subupd_end = find_lower(subupd_begin, upd_end, inner->slot[i].slotkey);
-                rebalancing_needed |= scheduleSubTreeUpdate(i, inner->slot[i].weight, min_weight, max_weight, subupd_begin, subupd_end, subtree_updates);
+                rebalancing_needed |= scheduleSubTreeUpdate(i, inner->slot[i], min_weight, max_weight, subupd_begin, subupd_end, subtree_updates);
                 subupd_begin = subupd_end;
             } 
-            rebalancing_needed |= scheduleSubTreeUpdate(lastslot, inner->slot[lastslot].weight, min_weight, max_weight, subupd_begin, upd_end, subtree_updates);
+            rebalancing_needed |= scheduleSubTreeUpdate(lastslot, inner->slot[lastslot], min_weight, max_weight, subupd_begin, upd_end, subtree_updates);
 
             // If no rewrite session is starting on this node, then just push down all updates
             if (!rebalancing_needed) {
@@ -804,13 +934,7 @@ protected:
                 // Need to perform rebalancing.
                 size_type designated_treesize = designated_subtreesize(inner->level);
 
-                #ifdef PARALLEL_BUILD
-                    auto& spare_inner = tls_data.local().spare_inner;
-                    inner_node* const result = spare_inner != NULL ? spare_inner : allocate_inner_without_count(0);
-                #else
-                    inner_node* const result = spare_inner;
-                #endif
-                result->initialize(inner->level);
+                inner_node* const result = allocate_inner_without_count(inner->level);
 
                 width_type in = 0; // current slot in input tree
                 width_type out = 0;
@@ -832,7 +956,7 @@ protected:
                         if (weight_of_defective_range == 0) {
                             BTREE_PRINT("Deleting entire subtree range" << std::endl);
                             for (width_type i = rebalancing_range_start; i < in; ++i) {
-                                clear_recursive(inner->slot[i].childid);
+                                clear_recursive(child(inner->slot[i]));
                             }
                         } else {
                             BTREE_PRINT("Rewrite session started on level " << inner->level << " of " << height() << " for subtrees [" << rebalancing_range_start << "," << in <<") of total weight " << weight_of_defective_range << std::endl);
@@ -841,15 +965,16 @@ protected:
 
                             result->slotuse = out;
                             inner_node_data fake_slot;
-                            fake_slot.childid = result;
+                            fake_slot.childid = result->ref;
                             out += create_subtree_from_leaves(fake_slot, out, /*write into result node*/ true, result->level, 0, weight_of_defective_range, leaves);
-                            BTREE_ASSERT(result == fake_slot.childid);                            
+                            BTREE_ASSERT(result == child(fake_slot));                            
                         }
                     } else {
-                        BTREE_PRINT("Copying " << in << " to " << out << " " << inner->slot[in].childid << std::endl);
+                        BTREE_PRINT("Copying " << in << " to " << out << " " << child(inner->slot[in]) << std::endl);
                         assert(!subtree_updates[in].rebalancing_needed);
                         result->slot[out] = inner->slot[in];
                         result->slot[out].weight = subtree_updates[in].weight;
+                        result->slot[out].marked = 0;
                         // reuse weight variable to store the new index of the current tree; we will update it in a second pass
                         subtree_updates[in].weight = out;
                         ++out;
@@ -858,11 +983,11 @@ protected:
                 }
                 result->slotuse = out;
 
-                // Setup spare_inner to be used by nested rebalancing operations
-                spare_inner = static_cast<inner_node*>(slot.childid);
+                // Release the old node so that it can be reused by nested rebalancing operations
+                free_node_without_count(inner);
 
                 // In a second pass, apply updates to subtrees not needing rebalancing on THIS level
-                // (but which may need to be updated recursively and therefore require the spare_inner)
+                // (but which may need to be updated recursively)
                 for (width_type i = 0; i < slotuse; ++i) {
                     if (!subtree_updates[i].rebalancing_needed && hasUpdates(subtree_updates[i])) {
                         const width_type mapped_slot = subtree_updates[i].weight;
@@ -872,7 +997,7 @@ protected:
                 result->slotuse = out;
                 set_min_element(slot, result);
                 update_router(slot.slotkey, result->slot[result->slotuse-1].slotkey);
-                slot.childid = result;
+                slot.childid = result->ref;
             }
         }
     }
@@ -882,9 +1007,9 @@ protected:
         size_type subtree_rank = rank;
         for (width_type i = begin; i < end; ++i) {
             if (subtree_updates[i].weight == 0) {
-                clear_recursive(node->slot[i].childid);
+                clear_recursive(child(node->slot[i]));
             } else {
-                rewrite(node->slot[i].childid, subtree_rank, subtree_updates[i].upd_begin, subtree_updates[i].upd_end, leaves);
+                rewrite(child(node->slot[i]), subtree_rank, subtree_updates[i].upd_begin, subtree_updates[i].upd_end, leaves);
             }
             subtree_rank += subtree_updates[i].weight;
         }
@@ -895,6 +1020,7 @@ protected:
             if (hasUpdates(subtree_updates[i])) {
                 update(node->slot[i], subtree_updates[i].upd_begin, subtree_updates[i].upd_end);
                 node->slot[i].weight = subtree_updates[i].weight;
+                node->slot[i].marked = 0;
             }
         }
     }
@@ -925,9 +1051,10 @@ protected:
             switch (op.type) {
             case Operation<key_type>::DELETE:
                 // We know the element is in here, so no bounds checks
-                while (key_less(leaf->slotkey[in], op.data)) {
+                while (key_less(leaf->key(in), op.data)) {
                     BTREE_ASSERT(in < in_slotuse);
-                    result->slotkey[out++] = leaf->slotkey[in++];
+                    if (leaf->is_marked(in)) { ++in; continue; }
+                    result->set_key(out++, leaf->key(in++));
 
                     if (out == designated_leafsize && hasNextLeaf(leaf_number, leaves)) {
                         result = getOrCreateLeaf(++leaf_number, leaves);
@@ -937,15 +1064,16 @@ protected:
                 ++in; // delete the element by jumping over it
                 continue;
             case Operation<key_type>::INSERT:
-                while(in < in_slotuse && key_less(leaf->slotkey[in], op.data)) {
-                    result->slotkey[out++] = leaf->slotkey[in++];
+                while(in < in_slotuse && key_less(leaf->key(in), op.data)) {
+                    if (leaf->is_marked(in)) { ++in; continue; }
+                    result->set_key(out++, leaf->key(in++));
 
                     if (out == designated_leafsize && hasNextLeaf(leaf_number, leaves)) {
                         result = getOrCreateLeaf(++leaf_number, leaves);
                         out = 0;
                     }
                 }
-                result->slotkey[out++] = op.data;
+                result->set_key(out++, op.data);
 
                 if (out == designated_leafsize && hasNextLeaf(leaf_number, leaves)) {
                     result = getOrCreateLeaf(++leaf_number, leaves);
@@ -956,8 +1084,9 @@ protected:
         } 
         // Reached the end of the update range. Have to write the remaining elements
         size_type next_update = upd_end;
-        while (in < in_slotuse && (is_last || key_less(leaf->slotkey[in], updates[next_update].data))) {
-            result->slotkey[out++] = leaf->slotkey[in++];
+        while (in < in_slotuse && (is_last || key_less(leaf->key(in), updates[next_update].data))) {
+            if (leaf->is_marked(in)) { ++in; continue; }
+            result->set_key(out++, leaf->key(in++));
 
             if (out == designated_leafsize && hasNextLeaf(leaf_number, leaves) && in < in_slotuse) {
                 result = getOrCreateLeaf(++leaf_number, leaves);
@@ -1000,22 +1129,17 @@ protected:
     }
 
     inline void update_leaf_in_current_tree(inner_node_data& slot, const size_type upd_begin, const size_type upd_end) {
-        const leaf_node* const leaf = static_cast<leaf_node*>(slot.childid);
-        #ifdef PARALLEL_BUILD
-            auto& spare_leaf = tls_data.local().spare_leaf;
-            leaf_node* const result = spare_leaf != NULL ? spare_leaf : allocate_leaf_without_count();
-        #else
-            leaf_node* const result = static_cast<leaf_node*>(spare_leaf);
-        #endif
+        const leaf_node* const leaf = static_cast<leaf_node*>(child(slot));
+        leaf_node* const result = allocate_leaf_without_count();
         width_type in = 0; // existing key to read
         width_type out = 0; // position where to write
         const width_type in_slotuse = leaf->slotuse;
 
         #ifdef COMPUTE_PARETO_MIN
-            const min_key_type local_min_dummy(0, std::numeric_limits<typename min_key_type::weight_type>::max());
-            const min_key_type* local_min =&local_min_dummy;
+            // Tracked by value, as soa leaves cannot hand out references to their keys
+            min_key_type local_min(0, std::numeric_limits<typename min_key_type::weight_type>::max());
         #else 
-            min_key_type* local_min = NULL;
+            min_key_type local_min;
         #endif
 
         BTREE_PRINT("Updating leaf from " << leaf << " to " << result);
@@ -1026,43 +1150,46 @@ protected:
             switch (op.type) {
             case Operation<key_type>::DELETE:
                 // We know the element is in here, so no bounds checks
-                while (key_less(leaf->slotkey[in], op.data)) {
+                while (key_less(leaf->key(in), op.data)) {
                     BTREE_ASSERT(in < in_slotuse);
+                    if (leaf->is_marked(in)) { ++in; continue; }
                     #ifdef COMPUTE_PARETO_MIN
-                        local_min = leaf->slotkey[in].second_weight < local_min->second_weight ? &leaf->slotkey[in] : local_min;
+                        update_min_element(local_min, leaf->key(in));
                     #endif 
-                    result->slotkey[out++] = leaf->slotkey[in++];
+                    result->set_key(out++, leaf->key(in++));
                 }
                 ++in; // delete the element by jumping over it
                 continue;
             case Operation<key_type>::INSERT:
-                while(in < in_slotuse && key_less(leaf->slotkey[in], op.data)) {
+                while(in < in_slotuse && key_less(leaf->key(in), op.data)) {
+                    if (leaf->is_marked(in)) { ++in; continue; }
                     #ifdef COMPUTE_PARETO_MIN
-                        local_min = leaf->slotkey[in].second_weight < local_min->second_weight ? &leaf->slotkey[in] : local_min;
+                        update_min_element(local_min, leaf->key(in));
                     #endif
-                    result->slotkey[out++] = leaf->slotkey[in++];
+                    result->set_key(out++, leaf->key(in++));
                 }
                  #ifdef COMPUTE_PARETO_MIN
-                    local_min = op.data.second_weight < local_min->second_weight ? &op.data : local_min;
+                    update_min_element(local_min, op.data);
                 #endif
-                result->slotkey[out++] = op.data;
+                result->set_key(out++, op.data);
                 continue;
             }
         }
         assert(leaf->slotuse <= leafslotmax);
         while (in < in_slotuse) {
+            if (leaf->is_marked(in)) { ++in; continue; }
             #ifdef COMPUTE_PARETO_MIN
-                local_min = leaf->slotkey[in].second_weight < local_min->second_weight ? &leaf->slotkey[in] : local_min;
+                update_min_element(local_min, leaf->key(in));
             #endif
-            result->slotkey[out++] = leaf->slotkey[in++];
+            result->set_key(out++, leaf->key(in++));
         }
         assert(out <= leafslotmax);
 
-        set_min_element(slot, *local_min);
+        set_min_element(slot, local_min);
         result->slotuse = out;
-        update_router(slot.slotkey, result->slotkey[out-1]); 
-        spare_leaf = static_cast<leaf_node*>(slot.childid);
-        slot.childid = result;
+        update_router(slot.slotkey, result->key(out-1)); 
+        free_node_without_count(leaf);
+        slot.childid = result->ref;
 
         BTREE_PRINT(": size " << leaf->slotuse << " -> " << result->slotuse << std::endl);
     }
@@ -1081,6 +1208,10 @@ protected:
     /// Memory allocator.
     allocator_type allocator;
 
+    /// Storage of all nodes of the tree
+    leaf_arena_type leaf_arena;
+    inner_arena_type inner_arena;
+
     // Currently running updates
     const Operation<key_type>* updates;
 
@@ -1095,9 +1226,9 @@ protected:
         struct tls_data {
             // Leaves created during the current reconstruction effort
             leaf_list leaves;
-            // Pointer to spare leaf used for merging.
-            leaf_node* spare_leaf = NULL;
-            inner_node* spare_inner = NULL;
+            // Free lists of nodes released by this thread
+            typename leaf_arena_type::Cache leaf_cache;
+            typename inner_arena_type::Cache inner_cache;
             UpdateDescriptorArray subtree_updates_per_level[MAX_TREE_LEVEL];
         };
 
@@ -1107,9 +1238,9 @@ protected:
         // Leaves created during the current reconstruction effort
         leaf_list leaves;
 
-        /// Pointer to spare leaf / inner nodes used for updates.
-        leaf_node* spare_leaf;
-        inner_node* spare_inner;
+        /// Free lists of released nodes
+        typename leaf_arena_type::Cache leaf_cache_;
+        typename inner_arena_type::Cache inner_cache_;
 
         // For each level, one array to store the updates needed to push down to the individual subtrees
         UpdateDescriptorArray subtree_updates_per_level[MAX_TREE_LEVEL];
@@ -121,8 +121,8 @@ protected:
     using base::allocate_leaf;
     using base::allocate_inner;
     using base::allocate_leaf_without_count;
-    using base::leaf_node_allocator;
-    using base::inner_node_allocator;
+    using base::allocate_inner_without_count;
+    using base::free_node_without_count;
     using base::free_node;
     using base::clear_recursive;
     using base::num_optimal_levels;
@@ -139,6 +139,7 @@ protected:
     using base::get_resized_leaves_array;
     using base::write_updated_leaf_to_new_tree;
     using base::print_node;
+    using base::child;
 
 protected:
     // *** Tree Object Data Members
@@ -154,7 +155,7 @@ public:
     /// Default constructor initializing an empty B+ tree with the standard key
     /// comparison function
     explicit inline btree(const thread_count _num_threads, const allocator_type &alloc=allocator_type())
-        : base(alloc), num_threads(_num_threads)
+        : base(alloc), num_threads(_num_threads), team_weightdelta_sums(_num_threads)
     {
         assert(num_threads > 0);
         weightdelta.reserve(LARGE_ENOUGH_FOR_EVERYTHING);
@@ -191,7 +192,7 @@ public:
 
         if (rebuild_needed) {
             BTREE_PRINT("Root-level rewrite session started for new level " << level << " with elements: " << new_size << std::endl);
-            UpdateDescriptor upd = {rebuild_needed, new_size, 0, update_count};
+            UpdateDescriptor upd = {rebuild_needed, new_size, 0, update_count, false};
             TreeRootCreationTask& task = *new(tbb::task::allocate_root()) TreeRootCreationTask(level, new_size, this);
             task.subtasks.push_back(*new(task.allocate_child()) TreeRewriteTask(root, 0, upd, task.leaves, this));
             task.subtask_count = 1;
@@ -199,9 +200,12 @@ public:
             root = task.result_node;
         } else {
             inner_node_data fake_slot;
-            fake_slot.childid = root;
+            fake_slot.childid = root->ref;
 
-            if (root->isleafnode()) {
+            if (update_count < SEQUENTIAL_FALLBACK_THRESHOLD) {
+                // Too few updates to amortize the task scheduling overhead
+                update(fake_slot, 0, update_count);
+            } else if (root->isleafnode()) {
                 TreeUpdateTask& task = *new(tbb::task::allocate_root()) TreeUpdateTask(fake_slot, 0, update_count, this);
                 tbb::task::spawn_root_and_wait(task);
             } else {
@@ -217,10 +221,10 @@ public:
                 size_type subupd_begin = 0;
                 for (width_type i = 0; i < last; ++i) {
                     size_type subupd_end = find_lower(subupd_begin, update_count, inner->slot[i].slotkey);
-                    rebalancing_needed |= scheduleSubTreeUpdate(i, inner->slot[i].weight, min_weight, max_weight, subupd_begin, subupd_end, subtree_updates);
+                    rebalancing_needed |= scheduleSubTreeUpdate(i, inner->slot[i], min_weight, max_weight, subupd_begin, subupd_end, subtree_updates);
                     subupd_begin = subupd_end;
                 } 
-                rebalancing_needed |= scheduleSubTreeUpdate(last, inner->slot[last].weight, min_weight, max_weight, subupd_begin, update_count, subtree_updates);
+                rebalancing_needed |= scheduleSubTreeUpdate(last, inner->slot[last], min_weight, max_weight, subupd_begin, update_count, subtree_updates);
 
                 if (!rebalancing_needed) {
                     // No rebalancing needed at all (this is the common case). Push updates to subtrees to update them parallel
@@ -229,6 +233,7 @@ public:
                         if (hasUpdates(subtree_updates[i])) {
                             root_tasks.push_back(*new(tbb::task::allocate_root()) TreeUpdateTask(inner->slot[i], subtree_updates[i].upd_begin, subtree_updates[i].upd_end, this, &subtree_affinity[i]));
                             inner->slot[i].weight = subtree_updates[i].weight;
+                            inner->slot[i].marked = 0;
                         }
                     }
                     tbb::task::spawn_root_and_wait(root_tasks);
@@ -237,7 +242,7 @@ public:
                     tbb::task::spawn_root_and_wait(task);
                 }
             }
-            root = fake_slot.childid;
+            root = child(fake_slot);
         }
 
         #ifdef BTREE_DEBUG
@@ -250,8 +255,123 @@ public:
     }
 
 
+    /**
+     * SPMD variant of apply_updates, to be called by all workers of a worker team. Updates of 
+     * the root's subtrees are distributed dynamically among the workers. Rare structural changes 
+     * (root rewrites and rebalancing) are performed by worker 0 alone. The tree is only 
+     * consistent once all workers have passed another barrier.
+     */
+    template<typename T, typename Worker>
+    void apply_updates_by_team(const T* _updates, const size_t update_count, const OperationBatchType _batch_type, Worker& worker) {
+        if (worker.id == 0) {
+            updates = _updates;
+            batch_type = _batch_type;
+        }
+        computeWeightDelta(_updates, update_count, _batch_type, worker);
+
+        if (worker.id == 0) {
+            const size_type new_size = size() + (_batch_type == INSERTS_AND_DELETES ? weightdelta[update_count] : update_count * _batch_type);
+            team_subtree_updates.clear();
+            next_team_subtree_update = 0;
+            stats.itemcount = new_size;
+
+            if (new_size == 0) {
+                clear(); // Tree will become empty. Just finish early.
+            } else {
+                if (root == NULL) {
+                    root = allocate_leaf();
+                }
+                const level_type level = num_optimal_levels(new_size);
+                bool rebuild_needed = (level < root->level && size() < minweight(root->level)) || size() > maxweight(root->level);
+
+                inner_node_data fake_slot;
+                fake_slot.childid = root->ref;
+
+                if (rebuild_needed) {
+                    auto& leaves = get_resized_leaves_array(new_size);
+                    rewrite(root, /*rank*/0, /*upd_begin*/0, update_count, leaves);
+                    create_subtree_from_leaves(fake_slot, 0, false, level, 0, new_size, leaves);
+                } else if (worker.size == 1 || root->isleafnode() || !scheduleTeamSubTreeUpdates(update_count, level)) {
+                    update(fake_slot, 0, update_count);
+                }
+                root = child(fake_slot);
+            }
+        }
+        worker.barrier();
+
+        for (size_t i = next_team_subtree_update++; i < team_subtree_updates.size(); i = next_team_subtree_update++) {
+            const UpdateDescriptor& upd = team_subtree_updates[i].second;
+            update(static_cast<inner_node*>(root)->slot[team_subtree_updates[i].first], upd.upd_begin, upd.upd_end);
+        }
+    }
+
 private:
 
+    std::vector<std::pair<width_type, UpdateDescriptor>> team_subtree_updates;
+    tbb::atomic<size_t> next_team_subtree_update;
+    std::vector<signed long> team_weightdelta_sums;
+
+    /** Distribute the updates among the root's subtrees. Returns false if rebalancing is needed */
+    bool scheduleTeamSubTreeUpdates(const size_t update_count, const level_type level) {
+        inner_node* const inner = static_cast<inner_node*>(root);
+        const size_type max_weight = maxweight(level-1);
+        const size_type min_weight = max_weight / 4;
+        auto& subtree_updates = tls_data.local().subtree_updates_per_level[MAX_TREE_LEVEL-1];
+        bool rebalancing_needed = false;
+
+        const width_type last = inner->slotuse-1;
+        size_type subupd_begin = 0;
+        for (width_type i = 0; i < last; ++i) {
+            size_type subupd_end = find_lower(subupd_begin, update_count, inner->slot[i].slotkey);
+            rebalancing_needed |= scheduleSubTreeUpdate(i, inner->slot[i], min_weight, max_weight, subupd_begin, subupd_end, subtree_updates);
+            subupd_begin = subupd_end;
+        } 
+        rebalancing_needed |= scheduleSubTreeUpdate(last, inner->slot[last], min_weight, max_weight, subupd_begin, update_count, subtree_updates);
+
+        if (rebalancing_needed) {
+            return false;
+        }
+        for (width_type i = 0; i < inner->slotuse; ++i) {
+            if (hasUpdates(subtree_updates[i])) {
+                team_subtree_updates.emplace_back(i, subtree_updates[i]);
+                inner->slot[i].weight = subtree_updates[i].weight;
+                inner->slot[i].marked = 0;
+            }
+        }
+        return true;
+    }
+
+    /** SPMD variant of the exclusive prefix sum over the weight deltas of the updates */
+    template<typename T, typename Worker>
+    void computeWeightDelta(const T* _updates, const size_t update_count, const OperationBatchType _batch_type, Worker& worker) {
+        if (_batch_type != INSERTS_AND_DELETES) {
+            return;
+        }
+        assert(worker.size <= num_threads);
+        const size_t begin = worker.id * update_count / worker.size;
+        const size_t end = (worker.id+1) * update_count / worker.size;
+
+        signed long sum = 0;
+        for (size_t i = begin; i < end; ++i) {
+            sum += _updates[i].type;
+        }
+        team_weightdelta_sums[worker.id] = sum;
+        worker.barrier();
+
+        sum = 0;
+        for (unsigned short w = 0; w < worker.id; ++w) {
+            sum += team_weightdelta_sums[w];
+        }
+        if (worker.id == 0) {
+            weightdelta[0] = 0;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            sum += _updates[i].type;
+            weightdelta[i+1] = sum;
+        }
+        worker.barrier();
+    }
+
     template<typename TIn, typename TOut>
     class PrefixSum {
         TOut sum;
@@ -305,7 +425,11 @@ private:
             weightdelta[0] = 0;
 
             PrefixSum<Operation<key_type>, signed long> body(weightdelta.data()+1, _updates);
-            parallel_scan(cache_aligned_blocked_range<size_type>(0, update_count, min_problem_size), body, partitioner);
+            if (update_count < SEQUENTIAL_FALLBACK_THRESHOLD) {
+                body(cache_aligned_blocked_range<size_type>(0, update_count, update_count), tbb::final_scan_tag());
+            } else {
+                parallel_scan(cache_aligned_blocked_range<size_type>(0, update_count, min_problem_size), body, partitioner);
+            }
 
             return size() + body.get_sum(); 
         } else {
@@ -362,14 +486,15 @@ private:
             } else if (continuation_mode == 1 && size != 0) {
                 // Reconstruct new tree from the filled leaves
                 // Keep this task alive (as a continuation) so that the leaves data structure is still available to subtasks
-                fake_slot.childid = in_node;
+                // The slot is only read if an existing node is filled
+                fake_slot.childid = in_node != NULL ? in_node->ref : 0;
                 continuation_mode++;
                 recycle_as_continuation();
                 TreeCreationTask& task = *new(allocate_child()) TreeCreationTask(fake_slot, old_slotuse, in_node != NULL, level, 0, size, leaves, tree);
                 set_ref_count(1);
                 return &task;
             } else {
-                result_node = fake_slot.childid;
+                result_node = tree->child(fake_slot);
                 return NULL;
             }
         }
@@ -399,6 +524,7 @@ private:
                 tree->create_subtree_from_leaves(slot, old_slotuse, reuse_node, level, rank_begin, rank_end, leaves);
                 return NULL;
             } else {
+                slot.marked = 0;
                 const size_type designated_treesize = designated_subtreesize(level);
                 const width_type subtrees = num_subtrees(rank_end - rank_begin, designated_treesize);
 
@@ -409,11 +535,11 @@ private:
 
                 inner_node* result = NULL;
                 if (reuse_node) {
-                    result = static_cast<inner_node*>(slot.childid);
+                    result = static_cast<inner_node*>(tree->child(slot));
                 } else {
                     result = tree->allocate_inner(level);
                     result->slotuse = new_slotuse;
-                    slot.childid = result;
+                    slot.childid = result->ref;
                 }
                 BTREE_ASSERT(new_slotuse <= innerslotmax);
                 tbb::task_list tasks;
@@ -449,7 +575,7 @@ private:
         { }
 
         tbb::task* execute() {
-            inner_node* const inner = (inner_node*) slot.childid;
+            inner_node* const inner = (inner_node*) tree->child(slot);
             set_min_element(slot, inner);
             tree->update_router(slot.slotkey, inner->slot[inner->slotuse-1].slotkey);
             return NULL;
@@ -498,7 +624,7 @@ private:
                         } else {
                             const signed long delta = tree->getWeightDelta(upd.upd_begin, r.begin());
                             const width_type key_index = this->find_index_of_lower_key(leaf, tree->updates[r.begin()].data);
-                            const size_type corrected_rank = rank + key_index + delta;
+                            const size_type corrected_rank = rank + key_index - leaf->marked_before(key_index) + delta;
                             tree->write_updated_leaf_to_new_tree(source_node, key_index, corrected_rank, r.begin(), r.end(), leaves, r.end() == upd.upd_end);
                         }
                     }
@@ -515,10 +641,10 @@ private:
                 for (width_type i = 0; i < last; ++i) {
                     size_type subupd_end = tree->find_lower(subupd_begin, upd.upd_end, inner->slot[i].slotkey);
 
-                    tree->scheduleSubTreeUpdate(i, inner->slot[i].weight, 0, 0, subupd_begin, subupd_end, subtree_updates);
+                    tree->scheduleSubTreeUpdate(i, inner->slot[i], 0, 0, subupd_begin, subupd_end, subtree_updates);
                     subupd_begin = subupd_end;
                 } 
-                tree->scheduleSubTreeUpdate(last, inner->slot[last].weight, 0, 0, subupd_begin, upd.upd_end, subtree_updates);
+                tree->scheduleSubTreeUpdate(last, inner->slot[last], 0, 0, subupd_begin, upd.upd_end, subtree_updates);
 
                 // Push updates to subtrees and rewrite them in parallel
                 tbb::task_list tasks;
@@ -527,7 +653,7 @@ private:
 
                 size_type subtree_rank = rank;
                 for (width_type i = 0; i < inner->slotuse; ++i) {
-                    tasks.push_back(*new(c.allocate_child()) TreeRewriteTask(inner->slot[i].childid, subtree_rank, subtree_updates[i], leaves, tree));
+                    tasks.push_back(*new(c.allocate_child()) TreeRewriteTask(tree->child(inner->slot[i]), subtree_rank, subtree_updates[i], leaves, tree));
                     subtree_rank += subtree_updates[i].weight;
                 }
                 c.set_ref_count(inner->slotuse);
@@ -547,7 +673,7 @@ private:
             while (lo < hi) {
                 int mid = (lo + hi) >> 1;
 
-                if (tree->key_lessequal(key, leaf->slotkey[mid])) {
+                if (tree->key_lessequal(key, leaf->key(mid))) {
                     hi = mid;
                 } else {
                     lo = mid + 1;
@@ -578,7 +704,7 @@ private:
 
                 inner_node* const inner = static_cast<inner_node*>(to_delete);
                 for (width_type i = 0; i < inner->slotuse; ++i) {
-                    tasks.push_back(*new(c.allocate_child()) TreeDeletionTask(inner->slot[i].childid, tree));
+                    tasks.push_back(*new(c.allocate_child()) TreeDeletionTask(tree->child(inner->slot[i]), tree));
                 }
                 c.set_ref_count(inner->slotuse);
                 tree->free_node(inner);
@@ -619,14 +745,15 @@ private:
         }
 
         tbb::task* execute() {
-            BTREE_PRINT("Applying updates [" << upd_begin << ", " << upd_end << ") to " << slot.childid   << " on level " << slot.childid->level << std::endl);
-            BTREE_ASSERT(upd_begin != upd_end);
+            node* const child_node = tree->child(slot);
+            BTREE_PRINT("Applying updates [" << upd_begin << ", " << upd_end << ") to " << child_node << " on level " << child_node->level << std::endl);
+            BTREE_ASSERT(upd_begin != upd_end || slot.marked > 0);
 
-            if (upd_end - upd_begin < tree->min_problem_size || slot.childid->isleafnode()) {
+            if (upd_end - upd_begin < tree->min_problem_size || child_node->isleafnode()) {
                 tree->update(slot, upd_begin, upd_end);
                 return NULL;
             } else {
-                inner_node* const inner = static_cast<inner_node*>(slot.childid);
+                inner_node* const inner = static_cast<inner_node*>(child_node);
                 const size_type max_weight = maxweight(inner->level-1);
                 const size_type min_weight = max_weight / 4;
                 auto& subtree_updates = tree->tls_data.local().subtree_updates_per_level[MAX_TREE_LEVEL-1];
@@ -637,10 +764,10 @@ private:
                 size_type subupd_begin = upd_begin;
                 for (width_type i = 0; i < last; ++i) {
                     size_type subupd_end = tree->find_lower(subupd_begin, upd_end, inner->slot[i].slotkey);
-                    rebalancing_needed |= tree->scheduleSubTreeUpdate(i, inner->slot[i].weight, min_weight, max_weight, subupd_begin, subupd_end, subtree_updates);
+                    rebalancing_needed |= tree->scheduleSubTreeUpdate(i, inner->slot[i], min_weight, max_weight, subupd_begin, subupd_end, subtree_updates);
                     subupd_begin = subupd_end;
                 } 
-                rebalancing_needed |= tree->scheduleSubTreeUpdate(last, inner->slot[last].weight, min_weight, max_weight, subupd_begin, upd_end, subtree_updates);
+                rebalancing_needed |= tree->scheduleSubTreeUpdate(last, inner->slot[last], min_weight, max_weight, subupd_begin, upd_end, subtree_updates);
 
                 tbb::task_list tasks;
                 width_type task_count = 0;
@@ -653,6 +780,7 @@ private:
                             tasks.push_back(*new(c.allocate_child()) TreeUpdateTask(inner->slot[i], subtree_updates[i].upd_begin, subtree_updates[i].upd_end, tree));
                             ++task_count;                            
                             inner->slot[i].weight = subtree_updates[i].weight;
+                            inner->slot[i].marked = 0;
                         }
                     }
                     
@@ -662,9 +790,7 @@ private:
                     // Need to perform rebalancing.
                     const size_type designated_treesize = designated_subtreesize(inner->level);
 
-                    auto& spare_inner = tree->tls_data.local().spare_inner;
-                    inner_node* const result = spare_inner != NULL ? spare_inner : tree->allocate_inner_without_count(0);
-                    result->initialize(inner->level);
+                    inner_node* const result = tree->allocate_inner_without_count(inner->level);
                     width_type in = 0; // current slot in input tree
                     width_type out = 0;
 
@@ -688,7 +814,7 @@ private:
 
                             size_type subtree_rank = 0;
                             for (width_type i = rebalancing_range_start; i < in; ++i) {
-                                task.subtasks.push_back(*new(task.allocate_child()) TreeRewriteTask(inner->slot[i].childid, subtree_rank, subtree_updates[i], task.leaves, tree));
+                                task.subtasks.push_back(*new(task.allocate_child()) TreeRewriteTask(tree->child(inner->slot[i]), subtree_rank, subtree_updates[i], task.leaves, tree));
                                 subtree_rank += subtree_updates[i].weight;
                             }
                             task.subtask_count = in - rebalancing_range_start;
@@ -696,10 +822,11 @@ private:
                             tasks.push_back(task);
                             ++task_count;
                         } else {
-                            BTREE_PRINT("Copying " << inner->slot[in].childid << " from " << in << " to " << out << " in " << result << std::endl);
+                            BTREE_PRINT("Copying " << tree->child(inner->slot[in]) << " from " << in << " to " << out << " in " << result << std::endl);
 
                             result->slot[out] = inner->slot[in];
                             result->slot[out].weight = subtree_updates[in].weight;
+                            result->slot[out].marked = 0;
                             if (hasUpdates(subtree_updates[in])) {
                                 tasks.push_back(*new(c.allocate_child()) TreeUpdateTask(result->slot[out], subtree_updates[in].upd_begin, subtree_updates[in].upd_end, tree));
                                 ++task_count;
@@ -709,8 +836,8 @@ private:
                         }
                     }
                     result->slotuse = out;
-                    spare_inner = static_cast<inner_node*>(slot.childid);
-                    slot.childid = result;
+                    tree->free_node_without_count(inner);
+                    slot.childid = result->ref;
                 }
                 c.set_ref_count(task_count);
                 auto& task = tasks.pop_front();
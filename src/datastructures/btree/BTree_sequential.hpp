@@ -101,8 +101,6 @@ protected:
     using base::allocate_leaf;
     using base::allocate_inner;
     using base::allocate_leaf_without_count;
-    using base::leaf_node_allocator;
-    using base::inner_node_allocator;
     using base::free_node;
     using base::clear_recursive;
     using base::num_optimal_levels;
@@ -118,6 +116,7 @@ protected:
     using base::update;
     using base::get_resized_leaves_array;
     using base::print_node;
+    using base::child;
 
 public:
     // *** Constructors and Destructor
@@ -164,17 +163,17 @@ public:
         bool rebuild_needed = (level < root->level && size() < minweight(root->level)) || size() > maxweight(root->level);
 
         inner_node_data fake_slot;
-        fake_slot.childid = root;
+        fake_slot.childid = root->ref;
 
         if (rebuild_needed) {
             BTREE_PRINT("Root-level rewrite session started for new level " << level << std::endl);
             auto& leaves = get_resized_leaves_array(new_size);
-            rewrite(fake_slot.childid, /*rank*/0, /*upd_begin*/0, _updates.size(), leaves);
+            rewrite(root, /*rank*/0, /*upd_begin*/0, _updates.size(), leaves);
             create_subtree_from_leaves(fake_slot, 0, false, level, 0, new_size, leaves);
         } else {
             update(fake_slot, 0, _updates.size());
         }
-        root = fake_slot.childid;
+        root = child(fake_slot);
 
         #ifdef BTREE_DEBUG
             print_node(root, 0, true);
@@ -0,0 +1,42 @@
+/*
+ * Key storage of the B-tree leaves, selected via the soa_leaves flag of the tree traits.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef LEAF_SLOTS_H_
+#define LEAF_SLOTS_H_
+
+#include <cstddef>
+
+/// Leaf keys stored as a plain array of keys
+template <typename _Key, size_t _Size>
+struct aos_leaf_slots {
+    typedef _Key key_type;
+
+    _Key keys[_Size];
+
+    inline const _Key& get(const size_t i) const { return keys[i]; }
+    inline void set(const size_t i, const _Key& key) { keys[i] = key; }
+};
+
+/// Leaf keys stored as one array per key member. A scan over a single weight only touches the
+/// cache lines of that weight. Requires keys with first_weight, second_weight and node members.
+template <typename _Key, size_t _Size>
+struct soa_leaf_slots {
+    typedef _Key key_type;
+    typedef typename _Key::weight_type weight_type;
+    typedef decltype(_Key::node) node_type;
+
+    weight_type first_weight[_Size];
+    weight_type second_weight[_Size];
+    node_type node[_Size];
+
+    inline _Key get(const size_t i) const { return _Key(node[i], first_weight[i], second_weight[i]); }
+    inline void set(const size_t i, const _Key& key) {
+        first_weight[i] = key.first_weight;
+        second_weight[i] = key.second_weight;
+        node[i] = key.node;
+    }
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Slab allocator for the nodes of a B-tree. Nodes are handed out as 32 bit references
+ * (an index into fixed-size chunks plus a tag bit), so that inner nodes can store compact
+ * child references instead of 64 bit pointers. Freed nodes are kept in per-thread free
+ * lists and reused by later allocations of the same thread. Memory is only returned to
+ * the system once the arena is destroyed.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef NODE_ARENA_H_
+#define NODE_ARENA_H_
+
+#include <new>
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+#include "tbb/atomic.h"
+#include "tbb/cache_aligned_allocator.h"
+
+/**
+ * Arena for nodes of type node_type, which needs a public member ref. All references
+ * handed out by this arena have the given tag bits set.
+ */
+template<typename node_type, uint32_t tag, unsigned int chunk_bits>
+class NodeArena {
+public:
+	typedef uint32_t ref_type;
+
+	/** Free list and unused remainder of the current chunk of a single thread */
+	struct Cache {
+		std::vector<ref_type> free;
+		ref_type next = 0;
+		ref_type end = 0;
+	};
+
+private:
+	static const uint32_t chunk_size = 1u << chunk_bits;
+	static const uint32_t max_chunks = 1u << 18;
+
+	/** Pad each node to a cache line to prevent false sharing between the threads */
+	struct alignas(64) padded_node {
+		node_type node;
+	};
+	typedef tbb::cache_aligned_allocator<padded_node> chunk_allocator;
+
+	padded_node** const chunks;
+	tbb::atomic<uint32_t> chunk_count;
+
+	NodeArena(const NodeArena&); // do not copy
+	void operator=(const NodeArena&); // do not copy
+
+public:
+	NodeArena()
+		// Lazily zeroed by the OS, so only the entries of used chunks are touched
+		: chunks(static_cast<padded_node**>(calloc(max_chunks, sizeof(padded_node*))))
+	{
+		static_assert(((max_chunks << chunk_bits) & tag) == 0, "tag bits overlap the node indices");
+		chunk_count = 0;
+		if (chunks == NULL) {
+			throw std::bad_alloc();
+		}
+	}
+
+	~NodeArena() {
+		chunk_allocator allocator;
+		for (uint32_t c = 0; c < chunk_count && c < max_chunks; ++c) {
+			if (chunks[c] == NULL) {
+				continue; // allocation of the chunk failed
+			}
+			for (uint32_t i = 0; i < chunk_size; ++i) {
+				chunks[c][i].~padded_node();
+			}
+			allocator.deallocate(chunks[c], chunk_size);
+		}
+		std::free(chunks);
+	}
+
+	inline node_type* get(const ref_type ref) const {
+		const ref_type index = ref & ~tag;
+		return &chunks[index >> chunk_bits][index & (chunk_size - 1)].node;
+	}
+
+	/** The returned node is (re-)used as is and needs to be initialized by the caller */
+	inline node_type* allocate(Cache& cache) {
+		ref_type ref;
+		if (!cache.free.empty()) {
+			ref = cache.free.back();
+			cache.free.pop_back();
+		} else {
+			if (cache.next == cache.end) {
+				claimChunk(cache);
+			}
+			ref = cache.next++ | tag;
+		}
+		node_type* const n = get(ref);
+		n->ref = ref;
+		return n;
+	}
+
+	inline void release(Cache& cache, const node_type* const n) {
+		cache.free.push_back(n->ref);
+	}
+
+private:
+	void claimChunk(Cache& cache) {
+		const uint32_t c = chunk_count.fetch_and_increment();
+		if (c >= max_chunks) {
+			throw std::bad_alloc();
+		}
+		chunk_allocator allocator;
+		padded_node* const chunk = allocator.allocate(chunk_size);
+		for (uint32_t i = 0; i < chunk_size; ++i) {
+			new (&chunk[i]) padded_node();
+		}
+		chunks[c] = chunk;
+		cache.next = c << chunk_bits;
+		cache.end = cache.next + chunk_size;
+	}
+};
+
+#endif
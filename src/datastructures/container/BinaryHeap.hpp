@@ -57,14 +57,20 @@ struct DataElement< id_slot, key_slot, NullData  >{
 	{}
 
 	//should never be called!
-	const NullData & getData() const { GUARANTEE( false, std::runtime_error, "DataElement<id_type, NULL_DATA> data requested. This should should never happen." ) return NULL; }
-	NullData & getData() { GUARANTEE( false, std::runtime_error, "DataElement<id_type, NULL_DATA> data requested. This should should never happen." )  return NULL; }
+	const NullData & getData() const { GUARANTEE( false, std::runtime_error, "DataElement<id_type, NULL_DATA> data requested. This should should never happen." ) return null_data; }
+	NullData & getData() { GUARANTEE( false, std::runtime_error, "DataElement<id_type, NULL_DATA> data requested. This should should never happen." )  return null_data; }
 
 	id_slot id;
 	key_slot key;
 	size_t heap_index;
+
+private:
+	static NullData null_data;
 };
 
+template<typename id_slot, typename key_slot >
+NullData DataElement< id_slot, key_slot, NullData >::null_data;
+
 //id_slot : ID Type for stored elements
 //key_slot: type of key_slot used
 //Meta key slot: min/max values for key_slot accessible via static functions ::max() / ::min()
@@ -19,6 +19,7 @@
 #include <string>
 #include <algorithm>
 #include <limits>
+#include <array>
 
 namespace utility{
 namespace datastructure{
@@ -480,6 +481,52 @@ struct DirectedBiWeightDataWithMiddleNode : public DirectedBiWeightData< weight_
 	NodeID middle_node;
 };
 
+//Edge data with a compile-time number of criteria
+template< typename weight_type_slot, unsigned short dimension >
+struct UndirectedMultiWeightData{
+	/*******************************************/
+	typedef weight_type_slot weight_type;
+
+	/*******************************************/
+	UndirectedMultiWeightData(){ weights.fill( 0 ); }
+
+	UndirectedMultiWeightData( const std::array<weight_type, dimension> & weights_ )
+	: weights( weights_ )
+	{}
+
+	weight_type operator[]( size_t index ) const { return weights[index]; }
+
+	/*******************************************/
+	inline void serialize( std::ostream & os ) const {
+		os.write( reinterpret_cast<const char*> (weights.data()), sizeof( weights ));
+	}
+
+	inline void deserialize( std::istream & is ) {
+		is.read( reinterpret_cast<char*> (weights.data()), sizeof( weights ));
+	}
+
+	bool operator==( const UndirectedMultiWeightData<weight_type_slot,dimension> & other ) const {
+		return other.weights == weights;
+	}
+
+	bool operator!=( const UndirectedMultiWeightData<weight_type_slot,dimension> & other ) const {
+		return other.weights != weights;
+	}
+
+	bool isClosed() const { return false; }
+
+	std::string toString() const {
+		std::ostringstream oss;
+		for( size_t i = 0; i < dimension; ++i ){
+			oss << (i > 0 ? ":" : "") << weights[i];
+		}
+		return oss.str();
+	}
+
+	/*******************************************/
+	std::array<weight_type, dimension> weights;
+};
+
 template< typename node_id_slot, typename edge_data_slot = utility::NullData, typename user_data_slot = utility::NullData >
 class Edge_t : public edge_data_slot, public user_data_slot {	//use base class optimization with NullData to use zero space if no data associated
 public:
@@ -571,7 +618,12 @@ typedef Edge_t< utility::datastructure::NodeID, DirectedWeightData<unsigned int>
 typedef Edge_t< utility::datastructure::NodeID, DirectedWeightDataWithMiddleNode<utility::datastructure::NodeID,unsigned int> > DirectedIntegerWeightedEdgeWithMiddleNode;
 typedef Edge_t< utility::datastructure::NodeID, UndirectedWeightDataWithMiddleNode<utility::datastructure::NodeID,unsigned int> > UndirectedIntegerWeightedEdgeWithMiddleNode;
 
-typedef Edge_t< utility::datastructure::NodeID, UndirectedBiWeightData<unsigned int> > IntegerBiWeightedEdge;
+template< typename weight_type_slot >
+using BiWeightedEdge = Edge_t< utility::datastructure::NodeID, UndirectedBiWeightData<weight_type_slot> >;
+template< typename weight_type_slot, unsigned short dimension >
+using MultiWeightedEdge = Edge_t< utility::datastructure::NodeID, UndirectedMultiWeightData<weight_type_slot, dimension> >;
+
+typedef BiWeightedEdge<unsigned int> IntegerBiWeightedEdge;
 typedef Edge_t< utility::datastructure::NodeID, DirectedBiWeightData<unsigned int> > DirectedIntegerBiWeightedEdge;
 typedef Edge_t< utility::datastructure::NodeID, DirectedBiWeightDataWithMiddleNode<utility::datastructure::NodeID,unsigned int> > DirectedIntegerBiWeightedEdgeWithMiddleNode;
 
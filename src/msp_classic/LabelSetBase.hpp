@@ -22,7 +22,11 @@
 template<typename label_type, typename label_type_extended>
 class LabelSetBase {
 public:
+#ifdef PRIORITY_LEX
+	typedef typename label_type::packed_type Priority;
+#else
 	typedef uint64_t Priority;
+#endif
 
 	static inline Priority computePriority(const label_type& label) {
 		#ifdef PRIORITY_SUM
@@ -32,7 +32,7 @@ private:
 	LabelSettingStatistics stats;
 
 	static inline Label createNewLabel(const Label& current_label, const Edge& edge) {
-		return Label(current_label.first_weight + edge.first_weight, current_label.second_weight + edge.second_weight);
+		return extended(current_label, edge);
 	}
 
 public:
@@ -74,6 +74,39 @@ public:
 		}		
 	}
 	
+	/** One-to-one search: Not specialized, therefore solved as one-to-all search */
+	void run(NodeID node, NodeID) {
+		run(node);
+	}
+
+	/** Goal-directed one-to-one search: Not specialized, therefore solved as one-to-all search */
+	void runGoalDirected(NodeID node, NodeID) {
+		run(node);
+	}
+
+	/** Resource-constrained one-to-one search: Not specialized, therefore the target labels are filtered afterwards */
+	bool runConstrained(NodeID node, NodeID target, const Label& max_weights, Label& best) {
+		run(node);
+		bool found = false;
+		for (auto label = begin(target); label != end(target); ++label) {
+			if (label->first_weight <= max_weights.first_weight && label->second_weight <= max_weights.second_weight
+					&& (!found || label->first_weight < best.first_weight
+						|| (label->first_weight == best.first_weight && label->second_weight < best.second_weight))) {
+				best = *label;
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	/** Approximation: Not supported, therefore searches remain exact */
+	void setEpsilon(double) { }
+
+	/** Prepare for the next query. Not specialized, therefore all label sets are recreated */
+	void reset() {
+		std::vector<SharedHeapLabelSet<Label, BinaryHeap>>(graph.numberOfNodes()).swap(labels);
+	}
+
 	void printStatistics() {
 		#ifdef GATHER_DATASTRUCTURE_MODIFICATION_LOG
 			std::cout << "# LabelSet Modifications: insertion position, dominance position" << std::endl;
@@ -0,0 +1,227 @@
+/*
+ * Bidirectional variant of the (sequential) ParetoSearch for one-to-one queries: A forward
+ * search from the source and a backward search on the reverse graph from the target alternate
+ * their iterations. Whenever a side adds a label to a node that has already been reached by
+ * the other side, the label is combined with the label set of the other side. The combined
+ * labels are the tentative solutions. Each side prunes its labels by their lower bounds
+ * towards the opposite end, raised by the queue minimum of the other side once a label
+ * has been combined (see BidirectionalPruning). The query ends as soon as either side
+ * runs out of labels, as each side on its own would already find all solutions.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef BIDIRECTIONAL_PARETO_SEARCH_H_
+#define BIDIRECTIONAL_PARETO_SEARCH_H_
+
+#include "../options.hpp"
+
+#include "../Label.hpp"
+#include "../Graph.hpp"
+
+#include "ParetoQueue_sequential.hpp"
+#include "ParetoLabelSet.hpp"
+#include "ParetoSearchStatistics.hpp"
+#include "LabelPruning.hpp"
+#include "ReverseGraph.hpp"
+#include "LowerBounds.hpp"
+
+#include <vector>
+#include <algorithm>
+
+/** The label sets need to be iterable (e.g., the VectorParetoLabelSet) */
+template<typename labelset_slot=VectorParetoLabelSet<std::allocator<Label>>, typename paretoqueue_slot=ParetoQueue>
+class BidirectionalParetoSearch {
+private:
+	typedef labelset_slot LabelSet;
+
+	template<typename graph_type>
+	struct Direction {
+		const graph_type& graph;
+		std::vector<LabelSet> labels;
+		paretoqueue_slot pq;
+		LowerBounds bounds; // towards the start of the opposite direction
+		ParetoSearchStatistics<Label> stats;
+		Label queue_minimum; // per criterion; a lower bound for all labels still to be queued
+
+		std::vector<Operation<NodeLabel>> updates;
+		std::vector<NodeLabel> candidates;
+		std::vector<NodeID> touched_nodes;
+
+		Direction(const graph_type& graph_, ReverseGraph& reverse_graph):
+			graph(graph_),
+			labels(graph_.numberOfNodes()),
+			bounds(reverse_graph)
+		{}
+
+		void init(const NodeID node, typename LabelSet::ThreadLocalLSData& labelset_data) {
+			pq.init(NodeLabel(node, Label(0,0)));
+			labels[node].init(Label(0,0), labelset_data);
+			touched_nodes.push_back(node);
+			queue_minimum = Label(0,0);
+		}
+
+		void reset() {
+			for (const NodeID node : touched_nodes) {
+				labels[node].reset();
+			}
+			touched_nodes.clear();
+			pq.clear();
+		}
+	};
+
+	GroupOperationsByWeightAndNodeComperator<Operation<NodeLabel>> groupOpsByWeight;
+	GroupNodeLabelsByNodeComperator groupCandidates;
+	GroupLabelsByWeightComperator groupLabels;
+
+	ReverseGraph reverse_graph;
+	Direction<Graph> forward;
+	Direction<ReverseGraph> backward;
+
+	LabelSet solutions;
+	std::vector<NodeLabel> solution_candidates;
+	std::vector<Operation<NodeLabel>> solution_updates;
+	ParetoSearchStatistics<Label> solution_stats;
+	NodeID target;
+
+	typename LabelSet::ThreadLocalLSData labelset_data;
+
+public:
+	BidirectionalParetoSearch(const Graph& graph_):
+		reverse_graph(graph_),
+		forward(graph_, reverse_graph),
+		backward(reverse_graph, reverse_graph),
+		target(0)
+	{
+		forward.updates.reserve(LARGE_ENOUGH_FOR_MOST);
+		forward.candidates.reserve(LARGE_ENOUGH_FOR_MOST);
+		backward.updates.reserve(LARGE_ENOUGH_FOR_MOST);
+		backward.candidates.reserve(LARGE_ENOUGH_FOR_MOST);
+	}
+
+	/** One-to-one search: Afterwards, the label set of the target holds all pareto optimal solutions */
+	void run(const NodeID node, const NodeID target_) {
+		target = target_;
+		reverse_graph.init();
+		forward.bounds.compute(target);
+		backward.bounds.computeFromSource(node);
+
+		forward.init(node, labelset_data);
+		backward.init(target, labelset_data);
+		if (node == target) {
+			solutions.init(Label(0,0), labelset_data);
+		}
+		while (!forward.pq.empty() && !backward.pq.empty()) {
+			iteration(forward, backward);
+			if (forward.pq.empty()) {
+				break;
+			}
+			iteration(backward, forward);
+		}
+	}
+
+	/** Prepare for the next query by clearing all label sets touched since the last reset */
+	void reset() {
+		forward.reset();
+		backward.reset();
+		solutions.reset();
+	}
+
+	void printStatistics() {
+		std::cout << "# Forward: " << forward.stats.toString(forward.labels) << std::endl;
+		std::cout << "# Backward: " << backward.stats.toString(backward.labels) << std::endl;
+	}
+
+	void printComponentTimings() const { }
+
+	/** Labels of the forward search. These are only complete for the target node */
+	const LabelSet& labelSet(const NodeID node) const { return node == target ? solutions : forward.labels[node]; }
+
+	size_t size(NodeID node) const { return labelSet(node).size(); }
+	typename LabelSet::const_iterator begin(NodeID node) const { return labelSet(node).begin(); }
+	typename LabelSet::const_iterator end(NodeID node) const { return labelSet(node).end(); }
+
+	/** Number of labels in both directions. Not counting the solutions */
+	size_t exploredLabels() const {
+		size_t count = 0;
+		for (const NodeID node : forward.touched_nodes) {
+			count += forward.labels[node].size();
+		}
+		for (const NodeID node : backward.touched_nodes) {
+			count += backward.labels[node].size();
+		}
+		return count;
+	}
+
+private:
+
+	/** A single iteration of the ParetoSearch in the given direction */
+	template<typename Side, typename OtherSide>
+	void iteration(Side& side, const OtherSide& other) {
+		side.stats.report(ITERATION, side.pq.size());
+		side.pq.findParetoMinima(side.updates, side.candidates, side.graph,
+			BidirectionalPruning<LabelSet>(solutions, side.bounds, side.labels, other.queue_minimum));
+		const size_t minima_count = side.updates.size();
+		side.stats.report(MINIMA_COUNT, minima_count);
+
+		// All labels queued from now on are extensions of these minima
+		side.queue_minimum = Label(MAX_WEIGHT, MAX_WEIGHT);
+		for (auto min = side.updates.begin(); min != side.updates.end(); ++min) {
+			side.queue_minimum.first_weight = std::min(side.queue_minimum.first_weight, min->data.first_weight);
+			side.queue_minimum.second_weight = std::min(side.queue_minimum.second_weight, min->data.second_weight);
+		}
+
+		std::sort(side.candidates.begin(), side.candidates.end(), groupCandidates);
+		const auto cand_end = side.candidates.end();
+		auto cand_iter = side.candidates.begin();
+		while (cand_iter != cand_end) {
+			auto range_start = cand_iter;
+			auto& ls = side.labels[range_start->node];
+			if (ls.size() == 0) {
+				side.touched_nodes.push_back(range_start->node);
+			}
+			while (cand_iter != cand_end && range_start->node == cand_iter->node) {
+				++cand_iter;
+			}
+			std::sort(range_start, cand_iter, groupLabels);
+			ls.updateLabelSet(range_start->node, range_start, cand_iter, side.updates, labelset_data, side.stats);
+		}
+
+		// Combine the new labels with the labels of the other side at the same node
+		for (auto upd = side.updates.begin() + minima_count; upd != side.updates.end(); ++upd) {
+			if (upd->type != Operation<NodeLabel>::INSERT) {
+				continue;
+			}
+			const LabelSet& other_labels = other.labels[upd->data.node];
+			for (auto label = other_labels.begin(); label != other_labels.end(); ++label) {
+				addSolutionCandidate(extended(upd->data, *label));
+			}
+		}
+		updateSolutions();
+
+		std::sort(side.updates.begin()+minima_count, side.updates.end(), groupOpsByWeight);
+		std::inplace_merge(side.updates.begin(), side.updates.begin()+minima_count, side.updates.end(), groupOpsByWeight);
+		side.pq.applyUpdates(side.updates);
+		side.stats.report(UPDATE_COUNT, side.updates.size());
+
+		side.updates.clear();
+		side.candidates.clear();
+	}
+
+	inline void addSolutionCandidate(const Label& label) {
+		if (!solutions.dominates(label)) {
+			solution_candidates.emplace_back(target, label);
+		}
+	}
+
+	void updateSolutions() {
+		if (solution_candidates.empty()) {
+			return;
+		}
+		std::sort(solution_candidates.begin(), solution_candidates.end(), groupLabels);
+		solutions.updateLabelSet(target, solution_candidates.begin(), solution_candidates.end(), solution_updates, labelset_data, solution_stats);
+		solution_candidates.clear();
+		solution_updates.clear();
+	}
+};
+
+#endif
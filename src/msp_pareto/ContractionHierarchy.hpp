@@ -0,0 +1,407 @@
+/*
+ * Multi-criteria contraction hierarchy for one-to-one queries on static graphs.
+ *
+ * An offline preprocessing step contracts the nodes in the order of their importance.
+ * Contracting a node removes it from the remaining graph. A shortcut between two of its
+ * neighbors is only added for those paths via the node that are pareto optimal, as
+ * decided by local witness searches. Once the remaining graph (the core) becomes too
+ * dense, the contraction stops.
+ *
+ * The result is split into an upward graph (edges towards later contracted nodes, plus all
+ * edges within the core) and a downward graph (reversed edges from later contracted nodes).
+ * A query runs a one-to-all search on each graph and combines both at the common nodes.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef CONTRACTION_HIERARCHY_H_
+#define CONTRACTION_HIERARCHY_H_
+
+#include "../Label.hpp"
+#include "../Graph.hpp"
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+class ContractionHierarchy {
+private:
+	typedef Label::weight_type weight_type;
+
+	/** Edge of the remaining graph. Points to the neighbor, in either direction */
+	struct Arc {
+		NodeID node;
+		Label weight;
+
+		Arc(const NodeID node_, const Label& weight_): node(node_), weight(weight_) {}
+	};
+
+	/** Path source -> contracted node -> target */
+	struct Shortcut {
+		NodeID source;
+		NodeID target;
+		Label weight;
+		bool witnessed;
+
+		Shortcut(const NodeID source_, const NodeID target_, const Label& weight_):
+			source(source_), target(target_), weight(weight_), witnessed(false)
+		{}
+	};
+
+	static inline bool groupShortcuts(const Shortcut& i, const Shortcut& j) {
+		if (i.source != j.source) {
+			return i.source < j.source;
+		}
+		if (i.target != j.target) {
+			return i.target < j.target;
+		}
+		return i.weight.lexLess(j.weight);
+	}
+
+	/** The witness search settles labels in lexicographic order (min-heap) */
+	static inline bool witnessOrder(const NodeLabel& i, const NodeLabel& j) {
+		return j.lexLess(i);
+	}
+
+	typedef std::pair<long, NodeID> Importance;
+
+	const double core_degree;
+	const size_t witness_limit;
+
+	std::vector<std::vector<Arc>> out_arcs;
+	std::vector<std::vector<Arc>> in_arcs;
+	std::vector<bool> contracted;
+	std::vector<unsigned int> contracted_neighbors;
+	size_t remaining_nodes;
+	size_t remaining_arcs;
+
+	std::vector<Shortcut> shortcuts;
+	std::vector<NodeLabel> witness_queue;
+	std::vector<weight_type> settled_second_weight; // MAX_WEIGHT if the node has not been settled
+	std::vector<NodeID> settled_nodes;
+
+	std::vector<std::pair<NodeID, Edge>> upward_edges;
+	std::vector<std::pair<NodeID, Edge>> downward_edges;
+	Graph upward;
+	Graph downward;
+	size_t shortcut_count;
+
+public:
+	/**
+	 * Contract the given graph. Nodes are contracted as long as the remaining graph has less than
+	 * core_degree edges per node. A witness search gives up after settling witness_limit labels;
+	 * the shortcuts it could not disprove are added, so that the hierarchy stays exact.
+	 */
+	ContractionHierarchy(const Graph& graph, const double core_degree_=24, const size_t witness_limit_=500):
+		core_degree(core_degree_),
+		witness_limit(witness_limit_),
+		out_arcs(graph.numberOfNodes()),
+		in_arcs(graph.numberOfNodes()),
+		contracted(graph.numberOfNodes(), false),
+		contracted_neighbors(graph.numberOfNodes(), 0),
+		remaining_nodes(graph.numberOfNodes()),
+		remaining_arcs(0),
+		settled_second_weight(graph.numberOfNodes(), MAX_WEIGHT),
+		shortcut_count(0)
+	{
+		FORALL_NODES(graph, node) {
+			FORALL_EDGES(graph, node, eid) {
+				const Edge& edge = graph.getEdge(eid);
+				if (edge.target != node) { // self loops are never part of a pareto optimal path
+					addArc(node, edge.target, Label(edge.first_weight, edge.second_weight));
+				}
+			}
+		}
+		contract();
+		buildGraph(upward, upward_edges);
+		buildGraph(downward, downward_edges);
+		upward_edges = std::vector<std::pair<NodeID, Edge>>();
+		downward_edges = std::vector<std::pair<NodeID, Edge>>();
+	}
+
+	/** Edges towards later contracted nodes and all edges within the core */
+	const Graph& upwardGraph() const { return upward; }
+
+	/** Reversed edges from later contracted nodes */
+	const Graph& downwardGraph() const { return downward; }
+
+	size_t numberOfNodes() const { return out_arcs.size(); }
+	size_t shortcutCount() const { return shortcut_count; }
+	size_t coreSize() const { return remaining_nodes; }
+
+private:
+
+	void addArc(const NodeID source, const NodeID target, const Label& weight) {
+		out_arcs[source].emplace_back(target, weight);
+		in_arcs[target].emplace_back(source, weight);
+		++remaining_arcs;
+	}
+
+	/** Contract the nodes by increasing importance, updated lazily */
+	void contract() {
+		std::priority_queue<Importance, std::vector<Importance>, std::greater<Importance>> queue;
+		for (NodeID node = NodeID(0); node < out_arcs.size(); ++node) {
+			queue.push(Importance(importance(node), node));
+		}
+		while (!queue.empty() && remaining_arcs < core_degree * remaining_nodes) {
+			const NodeID node = queue.top().second;
+			queue.pop();
+			const long current_importance = importance(node);
+			if (!queue.empty() && current_importance > queue.top().first) {
+				queue.push(Importance(current_importance, node));
+				continue;
+			}
+			contractNode(node); // reuses the shortcuts of the importance computation
+		}
+		// The core remains uncontracted and can only be traversed by the upward search
+		for (NodeID node = NodeID(0); node < out_arcs.size(); ++node) {
+			if (!contracted[node]) {
+				for (const Arc& arc : out_arcs[node]) {
+					upward_edges.emplace_back(node, Edge(arc.node, Edge::edge_data(arc.weight.first_weight, arc.weight.second_weight)));
+				}
+			}
+		}
+	}
+
+	/** Edge difference of the contraction, penalizing the contraction of neighboring nodes */
+	long importance(const NodeID node) {
+		const long added = (long) findShortcuts(node);
+		const long removed = (long) (in_arcs[node].size() + out_arcs[node].size());
+		return added - removed + (long) contracted_neighbors[node];
+	}
+
+	void contractNode(const NodeID node) {
+		for (const Arc& arc : out_arcs[node]) {
+			upward_edges.emplace_back(node, Edge(arc.node, Edge::edge_data(arc.weight.first_weight, arc.weight.second_weight)));
+			removeArcsTo(in_arcs[arc.node], node);
+			++contracted_neighbors[arc.node];
+		}
+		for (const Arc& arc : in_arcs[node]) {
+			downward_edges.emplace_back(node, Edge(arc.node, Edge::edge_data(arc.weight.first_weight, arc.weight.second_weight)));
+			removeArcsTo(out_arcs[arc.node], node);
+			++contracted_neighbors[arc.node];
+		}
+		remaining_arcs -= out_arcs[node].size() + in_arcs[node].size();
+		out_arcs[node] = std::vector<Arc>();
+		in_arcs[node] = std::vector<Arc>();
+		contracted[node] = true;
+		--remaining_nodes;
+
+		for (const Shortcut& shortcut : shortcuts) {
+			if (!shortcut.witnessed) {
+				addArc(shortcut.source, shortcut.target, shortcut.weight);
+				++shortcut_count;
+			}
+		}
+	}
+
+	/** Removed arcs leave the remaining graph of all other nodes */
+	static void removeArcsTo(std::vector<Arc>& arcs, const NodeID node) {
+		arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [node](const Arc& arc) { return arc.node == node; }), arcs.end());
+	}
+
+	/**
+	 * Collect the pareto optimal paths between the neighbors of the node and mark those with a witness,
+	 * i.e., a (weakly) dominating path avoiding the node. Returns the number of required shortcuts.
+	 */
+	size_t findShortcuts(const NodeID node) {
+		shortcuts.clear();
+		for (const Arc& in : in_arcs[node]) {
+			for (const Arc& out : out_arcs[node]) {
+				if (in.node != out.node) {
+					shortcuts.emplace_back(in.node, out.node, extended(in.weight, out.weight));
+				}
+			}
+		}
+		// Among the parallel paths, only keep the pareto optimal ones (a staircase per source and target)
+		std::sort(shortcuts.begin(), shortcuts.end(), groupShortcuts);
+		shortcuts.erase(std::unique(shortcuts.begin(), shortcuts.end(), [](const Shortcut& prev, const Shortcut& next) {
+			return prev.source == next.source && prev.target == next.target && prev.weight.second_weight <= next.weight.second_weight;
+		}), shortcuts.end());
+
+		size_t required = 0;
+		auto begin = shortcuts.begin();
+		while (begin != shortcuts.end()) {
+			auto end = begin;
+			while (end != shortcuts.end() && end->source == begin->source) {
+				++end;
+			}
+			required += witnessSearch(node, begin, end);
+			begin = end;
+		}
+		return required;
+	}
+
+	/**
+	 * Label setting search in lexicographic order from the common source of the shortcuts, not passing
+	 * the contracted node. Labels are settled in lexicographic order, so that the label set of a node
+	 * reduces to the smallest second weight settled so far. Returns the number of shortcuts without witness.
+	 */
+	size_t witnessSearch(const NodeID contracted_node, const std::vector<Shortcut>::iterator begin, const std::vector<Shortcut>::iterator end) {
+		weight_type max_first_weight = 0;
+		weight_type max_second_weight = 0;
+		for (auto shortcut = begin; shortcut != end; ++shortcut) {
+			max_first_weight = std::max(max_first_weight, shortcut->weight.first_weight);
+			max_second_weight = std::max(max_second_weight, shortcut->weight.second_weight);
+		}
+		size_t without_witness = end - begin;
+		size_t settled = 0;
+		witness_queue.emplace_back(begin->source, Label(0, 0));
+
+		while (!witness_queue.empty() && without_witness > 0 && settled < witness_limit) {
+			std::pop_heap(witness_queue.begin(), witness_queue.end(), witnessOrder);
+			const NodeLabel label = witness_queue.back();
+			witness_queue.pop_back();
+			if (label.first_weight > max_first_weight) {
+				break; // all remaining labels are worse in the first criterion
+			}
+			weight_type& settled_weight = settled_second_weight[label.node];
+			if (settled_weight <= label.second_weight) {
+				continue; // dominated
+			}
+			if (settled_weight == MAX_WEIGHT) {
+				settled_nodes.push_back(label.node);
+			}
+			settled_weight = label.second_weight;
+			++settled;
+
+			for (auto shortcut = begin; shortcut != end; ++shortcut) {
+				if (!shortcut->witnessed && shortcut->target == label.node && label.first_weight <= shortcut->weight.first_weight
+						&& label.second_weight <= shortcut->weight.second_weight) {
+					shortcut->witnessed = true;
+					--without_witness;
+				}
+			}
+			for (const Arc& arc : out_arcs[label.node]) {
+				const Label next = extended(label, arc.weight);
+				if (arc.node == contracted_node || next.first_weight > max_first_weight || next.second_weight > max_second_weight
+						|| settled_second_weight[arc.node] <= next.second_weight) {
+					continue;
+				}
+				witness_queue.emplace_back(arc.node, next);
+				std::push_heap(witness_queue.begin(), witness_queue.end(), witnessOrder);
+			}
+		}
+		witness_queue.clear();
+		for (const NodeID node : settled_nodes) {
+			settled_second_weight[node] = MAX_WEIGHT;
+		}
+		settled_nodes.clear();
+		return without_witness;
+	}
+
+	void buildGraph(Graph& graph, std::vector<std::pair<NodeID, Edge>>& edges) const {
+		std::stable_sort(edges.begin(), edges.end(), [](const std::pair<NodeID, Edge>& i, const std::pair<NodeID, Edge>& j) {
+			return i.first < j.first;
+		});
+		auto edge = edges.begin();
+		for (NodeID node = NodeID(0); node < out_arcs.size(); ++node) {
+			graph.addNode();
+			for (; edge != edges.end() && edge->first == node; ++edge) {
+				graph.addEdge(node, edge->second);
+			}
+		}
+		graph.finalize();
+	}
+};
+
+/**
+ * One-to-one queries on a contraction hierarchy. Every pareto optimal path consists of an upward part
+ * found by the forward search and a downward part found by the backward search. The forward and backward
+ * labels are thus combined at all nodes reached by both searches. Any of the label setting algorithms can
+ * be used as search_slot; additional constructor arguments (e.g., the thread count) are passed on.
+ */
+template<typename search_slot>
+class ContractionHierarchyQuery {
+private:
+	const ContractionHierarchy& hierarchy;
+	search_slot forward;
+	search_slot backward;
+
+	std::vector<Label> solutions;
+	std::vector<NodeID> search_space;
+	std::vector<bool> visited;
+	NodeID target;
+
+	GroupLabelsByWeightComperator groupLabels;
+
+public:
+	template<typename... Args>
+	ContractionHierarchyQuery(const ContractionHierarchy& hierarchy_, Args... args):
+		hierarchy(hierarchy_),
+		forward(hierarchy_.upwardGraph(), args...),
+		backward(hierarchy_.downwardGraph(), args...),
+		visited(hierarchy_.numberOfNodes(), false),
+		target(0)
+	{}
+
+	/** Afterwards, size(), begin() and end() of the target hold all pareto optimal solutions */
+	void run(const NodeID source, const NodeID target_) {
+		target = target_;
+		forward.run(source);
+		backward.run(target);
+
+		collectBackwardSearchSpace(target);
+		for (const NodeID node : search_space) {
+			visited[node] = false;
+			if (forward.size(node) == 0 || backward.size(node) == 0) {
+				continue;
+			}
+			for (auto f = forward.begin(node); f != forward.end(node); ++f) {
+				for (auto b = backward.begin(node); b != backward.end(node); ++b) {
+					solutions.push_back(extended(*f, *b));
+				}
+			}
+		}
+		search_space.clear();
+
+		std::sort(solutions.begin(), solutions.end(), groupLabels);
+		weight_type min_second_weight = MAX_WEIGHT;
+		solutions.erase(std::remove_if(solutions.begin(), solutions.end(), [&min_second_weight](const Label& label) {
+			if (label.second_weight >= min_second_weight) {
+				return true; // dominated by a lexicographically smaller label
+			}
+			min_second_weight = label.second_weight;
+			return false;
+		}), solutions.end());
+	}
+
+	/** Prepare for the next query */
+	void reset() {
+		forward.reset();
+		backward.reset();
+		solutions.clear();
+	}
+
+	void printStatistics() {
+		forward.printStatistics();
+		backward.printStatistics();
+	}
+
+	/** Only valid for the target of the last query */
+	size_t size(const NodeID) const { return solutions.size(); }
+	std::vector<Label>::const_iterator begin(const NodeID) const { return solutions.begin(); }
+	std::vector<Label>::const_iterator end(const NodeID) const { return solutions.end(); }
+
+private:
+	typedef Label::weight_type weight_type;
+
+	/** All nodes reachable within the downward graph, i.e., candidates to be labeled by the backward search */
+	void collectBackwardSearchSpace(const NodeID root) {
+		const Graph& graph = hierarchy.downwardGraph();
+		search_space.push_back(root);
+		visited[root] = true;
+		for (size_t i = 0; i < search_space.size(); ++i) {
+			FORALL_EDGES(graph, search_space[i], eid) {
+				const NodeID next = graph.getEdge(eid).target;
+				if (!visited[next]) {
+					visited[next] = true;
+					search_space.push_back(next);
+				}
+			}
+		}
+	}
+};
+
+#endif
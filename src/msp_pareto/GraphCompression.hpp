@@ -0,0 +1,704 @@
+/*
+ * Compression of degree-2 chains and dead-end trees, as found in large numbers in road graphs.
+ *
+ * Dead-end trees are removed by repeatedly removing nodes with a single neighbor. A chain of
+ * nodes with exactly two neighbors is collapsed into (at most) two shortcut edges between its
+ * ends. Dominated parallel edges are dropped. The compressed graph keeps the node IDs of the
+ * input graph: a removed node has no incoming edges, but keeps outgoing edges to the core
+ * nodes it is attached to, so that queries can still start there. Queries ending at a removed
+ * node combine the labels of its attachments. Removed structures are only collapsed if this
+ * is unambiguous, i.e., all links carry at most one edge per direction and no shortcut has a
+ * non-dominated parallel edge. Paths of the compressed graph can thus be unpacked from their
+ * nodes alone.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef GRAPH_COMPRESSION_H_
+#define GRAPH_COMPRESSION_H_
+
+#include "../Label.hpp"
+#include "../Graph.hpp"
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+
+class GraphCompression {
+public:
+	/** Path from a core node to a removed node (or the node itself, for core nodes) */
+	struct Attachment {
+		NodeID node;
+		Label weight;
+
+		Attachment(const NodeID node_, const Label& weight_): node(node_), weight(weight_) {}
+	};
+
+private:
+	enum Role { CORE, DEAD_END, CHAIN };
+	static const size_t NO_CHAIN = (size_t) -1;
+
+	struct WeightedEdge {
+		NodeID source;
+		NodeID target;
+		Label weight;
+		size_t chain; // NO_CHAIN for edges of the input graph
+
+		WeightedEdge(const NodeID source_, const NodeID target_, const Label& weight_, const size_t chain_=NO_CHAIN):
+			source(source_), target(target_), weight(weight_), chain(chain_)
+		{}
+	};
+
+	/** Both directions between a node and one of its neighbors */
+	struct Link {
+		NodeID neighbor;
+		unsigned int out_count;
+		unsigned int in_count;
+		Label out; // weight towards the neighbor, MAX_WEIGHT if there is no edge
+		Label in;
+
+		Link(const NodeID neighbor_): neighbor(neighbor_), out_count(0), in_count(0),
+			out(MAX_WEIGHT, MAX_WEIGHT), in(MAX_WEIGHT, MAX_WEIGHT) {}
+
+		bool simple() const { return out_count <= 1 && in_count <= 1; }
+	};
+
+	/**
+	 * Nodes of a chain, including both ends. Missing edges count as zero weight within the
+	 * prefix sums; a segment only exists if it contains no gap.
+	 */
+	struct Chain {
+		std::vector<NodeID> nodes;
+		std::vector<Label> forward;  // nodes[0] -> nodes[i]
+		std::vector<Label> backward; // nodes[i] -> nodes[0]
+		std::vector<unsigned int> forward_gaps;
+		std::vector<unsigned int> backward_gaps;
+		bool dissolved;
+	};
+
+	static inline bool groupEdges(const WeightedEdge& i, const WeightedEdge& j) {
+		if (i.source != j.source) {
+			return i.source < j.source;
+		}
+		if (i.target != j.target) {
+			return i.target < j.target;
+		}
+		if (i.weight != j.weight) {
+			return i.weight.lexLess(j.weight);
+		}
+		return i.chain == NO_CHAIN && j.chain != NO_CHAIN; // prefer the input edge on ties
+	}
+
+	static inline Label::weight_type saturatedAdd(const Label::weight_type a, const Label::weight_type b) {
+		return a > MAX_WEIGHT - b ? MAX_WEIGHT : a + b;
+	}
+
+	static inline Label saturatedAdd(const Label& a, const Label& b) {
+		return Label(saturatedAdd(a.first_weight, b.first_weight), saturatedAdd(a.second_weight, b.second_weight));
+	}
+
+	static inline bool exists(const Label& weight) {
+		return weight.first_weight != MAX_WEIGHT;
+	}
+
+	std::vector<Role> role;
+	std::vector<std::vector<Link>> links;
+
+	// Dead-end trees
+	std::vector<NodeID> parent;
+	std::vector<Label> to_parent;
+	std::vector<Label> from_parent;
+	std::vector<NodeID> root;
+	std::vector<Label> to_root;
+	std::vector<Label> from_root;
+	std::vector<unsigned int> depth;
+	std::vector<bool> anchor;
+
+	// Chains
+	std::vector<Chain> chains;
+	std::vector<size_t> chain_of;
+	std::vector<unsigned int> chain_position;
+	std::map<std::pair<NodeID, NodeID>, size_t> shortcut_chain;
+
+	Graph compressed;
+	size_t removed_nodes;
+
+public:
+	GraphCompression(const Graph& graph):
+		role(graph.numberOfNodes(), CORE),
+		links(graph.numberOfNodes()),
+		parent(graph.numberOfNodes()),
+		to_parent(graph.numberOfNodes()),
+		from_parent(graph.numberOfNodes()),
+		root(graph.numberOfNodes()),
+		to_root(graph.numberOfNodes()),
+		from_root(graph.numberOfNodes()),
+		depth(graph.numberOfNodes(), 0),
+		anchor(graph.numberOfNodes(), false),
+		chain_of(graph.numberOfNodes(), NO_CHAIN),
+		chain_position(graph.numberOfNodes(), 0),
+		removed_nodes(0)
+	{
+		std::vector<WeightedEdge> edges;
+		FORALL_NODES(graph, node) {
+			FORALL_EDGES(graph, node, eid) {
+				const Edge& edge = graph.getEdge(eid);
+				if (edge.target != node) { // self loops are never part of a pareto optimal path
+					edges.emplace_back(node, edge.target, Label(edge.first_weight, edge.second_weight));
+				}
+			}
+		}
+		removeDominatedParallelEdges(edges);
+		buildLinks(edges);
+		removeDeadEnds();
+		collapseChains();
+
+		std::vector<WeightedEdge> compressed_edges;
+		while (!buildCompressedEdges(edges, compressed_edges)) {
+			// some chains had to be dissolved, try again
+		}
+		addAttachmentEdges(compressed_edges);
+		buildGraph(compressed_edges);
+		links = std::vector<std::vector<Link>>();
+	}
+
+	/** Same node IDs as the input graph */
+	const Graph& graph() const { return compressed; }
+
+	size_t removedNodes() const { return removed_nodes; }
+	bool removed(const NodeID node) const { return role[node] != CORE; }
+
+	/** Core nodes from which the node can be reached, together with the weight of the path */
+	void attachments(const NodeID node, std::vector<Attachment>& result) const {
+		result.clear();
+		if (role[node] == CORE) {
+			result.emplace_back(node, Label(0, 0));
+		} else if (role[node] == DEAD_END) {
+			if (exists(from_root[node])) {
+				result.emplace_back(root[node], from_root[node]);
+			}
+		} else {
+			const Chain& chain = chains[chain_of[node]];
+			Label weight;
+			if (segment(chain, 0, chain_position[node], weight)) {
+				result.emplace_back(chain.nodes.front(), weight);
+			}
+			if (segment(chain, chain.nodes.size()-1, chain_position[node], weight)) {
+				result.emplace_back(chain.nodes.back(), weight);
+			}
+		}
+	}
+
+	/**
+	 * Path between two nodes of the same chain or dead-end tree that does not leave it
+	 * (all other paths pass the attachments). Returns false if there is no such path.
+	 */
+	bool directPath(const NodeID source, const NodeID target, Label& weight) const {
+		if (source == target) {
+			return false;
+		}
+		if (role[source] == CHAIN && role[target] == CHAIN && chain_of[source] == chain_of[target]) {
+			return segment(chains[chain_of[source]], chain_position[source], chain_position[target], weight);
+		}
+		if (role[source] == DEAD_END && role[target] == DEAD_END && root[source] == root[target]) {
+			Label up(0, 0);
+			Label down(0, 0);
+			NodeID s = source;
+			NodeID t = target;
+			while (s != t) {
+				if (depth[s] >= depth[t]) {
+					up = saturatedAdd(up, to_parent[s]);
+					s = parent[s];
+				} else {
+					down = saturatedAdd(down, from_parent[t]);
+					t = parent[t];
+				}
+			}
+			weight = saturatedAdd(up, down);
+			return exists(weight);
+		}
+		return false;
+	}
+
+	/** Replace a path of the compressed graph by the corresponding path of the input graph */
+	void unpackPath(const std::vector<NodeID>& compressed_path, std::vector<NodeID>& path) const {
+		path.clear();
+		if (compressed_path.empty()) {
+			return;
+		}
+		path.push_back(compressed_path.front());
+		for (size_t i = 1; i < compressed_path.size(); ++i) {
+			const NodeID from = compressed_path[i-1];
+			const NodeID to = compressed_path[i];
+			if (role[from] == DEAD_END) {
+				for (NodeID node = from; node != to; ) {
+					node = parent[node];
+					path.push_back(node);
+				}
+			} else if (role[from] == CHAIN) {
+				const Chain& chain = chains[chain_of[from]];
+				appendChainNodes(chain, chain_position[from], to == chain.nodes.front() ? 0 : chain.nodes.size()-1, path);
+			} else {
+				const auto shortcut = shortcut_chain.find(std::make_pair(from, to));
+				if (shortcut == shortcut_chain.end()) {
+					path.push_back(to);
+				} else {
+					const Chain& chain = chains[shortcut->second];
+					const bool forward = chain.nodes.front() == from;
+					appendChainNodes(chain, forward ? 0 : chain.nodes.size()-1, forward ? chain.nodes.size()-1 : 0, path);
+				}
+			}
+		}
+	}
+
+	/** Append the nodes after the given attachment up to the removed node */
+	void appendAttachmentPath(const NodeID attachment, const NodeID node, std::vector<NodeID>& path) const {
+		if (role[node] == DEAD_END) {
+			const size_t begin = path.size();
+			for (NodeID current = node; current != attachment; current = parent[current]) {
+				path.push_back(current);
+			}
+			std::reverse(path.begin() + begin, path.end());
+		} else if (role[node] == CHAIN) {
+			const Chain& chain = chains[chain_of[node]];
+			appendChainNodes(chain, attachment == chain.nodes.front() ? 0 : chain.nodes.size()-1, chain_position[node], path);
+		}
+	}
+
+	/** Append the nodes of a path found by directPath(), except for the source */
+	void appendDirectPath(const NodeID source, const NodeID target, std::vector<NodeID>& path) const {
+		if (role[source] == CHAIN) {
+			appendChainNodes(chains[chain_of[source]], chain_position[source], chain_position[target], path);
+			return;
+		}
+		NodeID s = source;
+		NodeID t = target;
+		std::vector<NodeID> down;
+		while (s != t) {
+			if (depth[s] >= depth[t]) {
+				s = parent[s];
+				path.push_back(s);
+			} else {
+				down.push_back(t);
+				t = parent[t];
+			}
+		}
+		path.insert(path.end(), down.rbegin(), down.rend());
+	}
+
+private:
+
+	/** Weight of the path between two positions of a chain */
+	static bool segment(const Chain& chain, const size_t from, const size_t to, Label& weight) {
+		if (from <= to) {
+			if (chain.forward_gaps[from] != chain.forward_gaps[to]) {
+				return false;
+			}
+			weight = Label(chain.forward[to].first_weight - chain.forward[from].first_weight,
+				chain.forward[to].second_weight - chain.forward[from].second_weight);
+		} else {
+			if (chain.backward_gaps[from] != chain.backward_gaps[to]) {
+				return false;
+			}
+			weight = Label(chain.backward[from].first_weight - chain.backward[to].first_weight,
+				chain.backward[from].second_weight - chain.backward[to].second_weight);
+		}
+		return true;
+	}
+
+	static void appendChainNodes(const Chain& chain, size_t from, const size_t to, std::vector<NodeID>& path) {
+		while (from != to) {
+			from = from < to ? from+1 : from-1;
+			path.push_back(chain.nodes[from]);
+		}
+	}
+
+	static void removeDominatedParallelEdges(std::vector<WeightedEdge>& edges) {
+		std::sort(edges.begin(), edges.end(), groupEdges);
+		edges.erase(std::unique(edges.begin(), edges.end(), [](const WeightedEdge& prev, const WeightedEdge& next) {
+			return prev.source == next.source && prev.target == next.target && prev.weight.second_weight <= next.weight.second_weight;
+		}), edges.end());
+	}
+
+	Link& link(const NodeID node, const NodeID neighbor) {
+		std::vector<Link>& node_links = links[node];
+		if (node_links.empty() || node_links.back().neighbor != neighbor) {
+			for (Link& l : node_links) {
+				if (l.neighbor == neighbor) {
+					return l;
+				}
+			}
+			node_links.emplace_back(neighbor);
+		}
+		return node_links.back();
+	}
+
+	void buildLinks(const std::vector<WeightedEdge>& edges) {
+		for (const WeightedEdge& edge : edges) {
+			Link& out = link(edge.source, edge.target);
+			++out.out_count;
+			out.out = edge.weight;
+			Link& in = link(edge.target, edge.source);
+			++in.in_count;
+			in.in = edge.weight;
+		}
+	}
+
+	/** The only remaining neighbor of a node, with its link. NULL if there is not exactly one */
+	const Link* singleLink(const NodeID node) const {
+		const Link* result = NULL;
+		for (const Link& l : links[node]) {
+			if (role[l.neighbor] == CORE) {
+				if (result != NULL) {
+					return NULL;
+				}
+				result = &l;
+			}
+		}
+		return result;
+	}
+
+	void removeDeadEnds() {
+		std::vector<NodeID> removal_order;
+		std::vector<NodeID> queue;
+		for (NodeID node = NodeID(0); node < links.size(); ++node) {
+			queue.push_back(node);
+		}
+		while (!queue.empty()) {
+			const NodeID node = queue.back();
+			queue.pop_back();
+			const Link* l = role[node] == CORE ? singleLink(node) : NULL;
+			if (l == NULL || !l->simple()) {
+				continue;
+			}
+			role[node] = DEAD_END;
+			parent[node] = l->neighbor;
+			to_parent[node] = l->out;
+			from_parent[node] = l->in;
+			removal_order.push_back(node);
+			queue.push_back(l->neighbor);
+		}
+		// Parents are removed after their children (or remain in the core)
+		for (auto node = removal_order.rbegin(); node != removal_order.rend(); ++node) {
+			const NodeID p = parent[*node];
+			if (role[p] == CORE) {
+				anchor[p] = true;
+				root[*node] = p;
+				to_root[*node] = to_parent[*node];
+				from_root[*node] = from_parent[*node];
+				depth[*node] = 1;
+			} else {
+				root[*node] = root[p];
+				to_root[*node] = saturatedAdd(to_parent[*node], to_root[p]);
+				from_root[*node] = saturatedAdd(from_root[p], from_parent[*node]);
+				depth[*node] = depth[p] + 1;
+			}
+		}
+		removed_nodes += removal_order.size();
+	}
+
+	/** Remaining node with exactly two neighbors, both by simple links, and without dead-end trees */
+	bool chainNode(const NodeID node, const Link*& first, const Link*& second) const {
+		if (role[node] != CORE || anchor[node]) {
+			return false;
+		}
+		first = NULL;
+		second = NULL;
+		for (const Link& l : links[node]) {
+			if (role[l.neighbor] != DEAD_END) {
+				if (second != NULL || !l.simple()) {
+					return false;
+				}
+				(first == NULL ? first : second) = &l;
+			}
+		}
+		return second != NULL;
+	}
+
+	void collapseChains() {
+		std::vector<bool> visited(links.size(), false);
+		std::vector<NodeID> left;
+		std::vector<NodeID> right;
+		for (NodeID node = NodeID(0); node < links.size(); ++node) {
+			const Link* first;
+			const Link* second;
+			if (visited[node] || !chainNode(node, first, second)) {
+				continue;
+			}
+			visited[node] = true;
+			const bool cycle = !walkChain(node, first->neighbor, visited, left) || !walkChain(node, second->neighbor, visited, right);
+			if (cycle || left.back() == right.back()) {
+				continue; // no distinct ends
+			}
+			Chain chain;
+			chain.nodes.assign(left.rbegin(), left.rend());
+			chain.nodes.push_back(node);
+			chain.nodes.insert(chain.nodes.end(), right.begin(), right.end());
+			chain.dissolved = false;
+			prefixSums(chain);
+
+			for (size_t i = 1; i+1 < chain.nodes.size(); ++i) {
+				role[chain.nodes[i]] = CHAIN;
+				chain_of[chain.nodes[i]] = chains.size();
+				chain_position[chain.nodes[i]] = i;
+			}
+			removed_nodes += chain.nodes.size() - 2;
+			chains.push_back(chain);
+		}
+	}
+
+	/** Follow the chain from node via next up to its end (included). False if it leads back to node */
+	bool walkChain(const NodeID node, NodeID next, std::vector<bool>& visited, std::vector<NodeID>& nodes) const {
+		nodes.clear();
+		NodeID previous = node;
+		const Link* first;
+		const Link* second;
+		while (next != node && !visited[next] && chainNode(next, first, second)) {
+			visited[next] = true;
+			nodes.push_back(next);
+			const NodeID following = first->neighbor == previous ? second->neighbor : first->neighbor;
+			previous = next;
+			next = following;
+		}
+		nodes.push_back(next);
+		return next != node && !(visited[next] && chainNode(next, first, second));
+	}
+
+	void prefixSums(Chain& chain) {
+		const size_t size = chain.nodes.size();
+		chain.forward.assign(size, Label(0, 0));
+		chain.backward.assign(size, Label(0, 0));
+		chain.forward_gaps.assign(size, 0);
+		chain.backward_gaps.assign(size, 0);
+		for (size_t i = 1; i < size; ++i) {
+			const Link& l = link(chain.nodes[i-1], chain.nodes[i]);
+			chain.forward[i] = chain.forward[i-1];
+			chain.forward_gaps[i] = chain.forward_gaps[i-1];
+			if (exists(l.out)) {
+				chain.forward[i] = extended(chain.forward[i], l.out);
+			} else {
+				++chain.forward_gaps[i];
+			}
+			chain.backward[i] = chain.backward[i-1];
+			chain.backward_gaps[i] = chain.backward_gaps[i-1];
+			if (exists(l.in)) {
+				chain.backward[i] = extended(chain.backward[i], l.in);
+			} else {
+				++chain.backward_gaps[i];
+			}
+		}
+	}
+
+	/**
+	 * Edges between core nodes plus the chain shortcuts, without dominated parallel edges.
+	 * A shortcut that remains parallel to another edge would be ambiguous during path unpacking.
+	 * Its chain is dissolved instead (returns false).
+	 */
+	bool buildCompressedEdges(const std::vector<WeightedEdge>& edges, std::vector<WeightedEdge>& compressed_edges) {
+		compressed_edges.clear();
+		for (const WeightedEdge& edge : edges) {
+			if (role[edge.source] == CORE && role[edge.target] == CORE) {
+				compressed_edges.push_back(edge);
+			}
+		}
+		for (size_t c = 0; c < chains.size(); ++c) {
+			const Chain& chain = chains[c];
+			if (chain.dissolved) {
+				continue;
+			}
+			const size_t last = chain.nodes.size()-1;
+			Label weight;
+			if (segment(chain, 0, last, weight)) {
+				compressed_edges.emplace_back(chain.nodes.front(), chain.nodes.back(), weight, c);
+			}
+			if (segment(chain, last, 0, weight)) {
+				compressed_edges.emplace_back(chain.nodes.back(), chain.nodes.front(), weight, c);
+			}
+		}
+		removeDominatedParallelEdges(compressed_edges);
+
+		bool unambiguous = true;
+		for (size_t i = 0; i < compressed_edges.size(); ++i) {
+			const WeightedEdge& edge = compressed_edges[i];
+			const bool parallel = (i > 0 && compressed_edges[i-1].source == edge.source && compressed_edges[i-1].target == edge.target)
+				|| (i+1 < compressed_edges.size() && compressed_edges[i+1].source == edge.source && compressed_edges[i+1].target == edge.target);
+			if (parallel && edge.chain != NO_CHAIN) {
+				dissolveChain(edge.chain);
+				unambiguous = false;
+			}
+		}
+		if (unambiguous) {
+			for (const WeightedEdge& edge : compressed_edges) {
+				if (edge.chain != NO_CHAIN) {
+					shortcut_chain[std::make_pair(edge.source, edge.target)] = edge.chain;
+				}
+			}
+		}
+		return unambiguous;
+	}
+
+	void dissolveChain(const size_t c) {
+		Chain& chain = chains[c];
+		if (chain.dissolved) {
+			return;
+		}
+		chain.dissolved = true;
+		for (size_t i = 1; i+1 < chain.nodes.size(); ++i) {
+			role[chain.nodes[i]] = CORE;
+			chain_of[chain.nodes[i]] = NO_CHAIN;
+		}
+		removed_nodes -= chain.nodes.size() - 2;
+	}
+
+	/** Removed nodes keep their paths to the core, so that queries can start there */
+	void addAttachmentEdges(std::vector<WeightedEdge>& compressed_edges) const {
+		for (NodeID node = NodeID(0); node < role.size(); ++node) {
+			if (role[node] == DEAD_END && exists(to_root[node])) {
+				compressed_edges.emplace_back(node, root[node], to_root[node]);
+			} else if (role[node] == CHAIN) {
+				const Chain& chain = chains[chain_of[node]];
+				Label weight;
+				if (segment(chain, chain_position[node], 0, weight)) {
+					compressed_edges.emplace_back(node, chain.nodes.front(), weight);
+				}
+				if (segment(chain, chain_position[node], chain.nodes.size()-1, weight)) {
+					compressed_edges.emplace_back(node, chain.nodes.back(), weight);
+				}
+			}
+		}
+	}
+
+	void buildGraph(std::vector<WeightedEdge>& compressed_edges) {
+		std::stable_sort(compressed_edges.begin(), compressed_edges.end(), [](const WeightedEdge& i, const WeightedEdge& j) {
+			return i.source < j.source;
+		});
+		auto edge = compressed_edges.begin();
+		for (NodeID node = NodeID(0); node < role.size(); ++node) {
+			compressed.addNode();
+			for (; edge != compressed_edges.end() && edge->source == node; ++edge) {
+				compressed.addEdge(node, Edge(edge->target, Edge::edge_data(edge->weight.first_weight, edge->weight.second_weight)));
+			}
+		}
+		compressed.finalize();
+	}
+};
+
+/**
+ * One-to-one queries on the compressed graph, using a ParetoSearch. Paths to a removed target
+ * pass one of its attachments; labels are pruned if they are dominated by an attachment label
+ * extended to the target.
+ */
+template<typename search_slot>
+class CompressedGraphQuery {
+private:
+	typedef GraphCompression::Attachment Attachment;
+
+	struct AttachmentPruning {
+		const search_slot& search;
+		const std::vector<Attachment>& attachments;
+
+		inline bool operator()(const NodeID, const Label& label) const {
+			for (const Attachment& a : attachments) {
+				if (a.weight.first_weight <= label.first_weight && a.weight.second_weight <= label.second_weight &&
+						search.labelSet(a.node).dominates(Label(label.first_weight - a.weight.first_weight, label.second_weight - a.weight.second_weight))) {
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
+	const GraphCompression& compression;
+	search_slot search;
+	std::vector<Attachment> target_attachments;
+	std::vector<Label> solutions;
+	NodeID source;
+	NodeID target;
+
+	GroupLabelsByWeightComperator groupLabels;
+
+public:
+	template<typename... Args>
+	CompressedGraphQuery(const GraphCompression& compression_, Args... args):
+		compression(compression_),
+		search(compression_.graph(), args...),
+		source(0),
+		target(0)
+	{}
+
+	/** Afterwards, size(), begin() and end() of the target hold all pareto optimal solutions */
+	void run(const NodeID source_, const NodeID target_) {
+		source = source_;
+		target = target_;
+		if (source == target) {
+			solutions.push_back(Label(0, 0));
+			return;
+		}
+		compression.attachments(target, target_attachments);
+		search.runPruned(source, AttachmentPruning{search, target_attachments});
+
+		for (const Attachment& a : target_attachments) {
+			for (auto label = search.begin(a.node); label != search.end(a.node); ++label) {
+				solutions.push_back(extended(*label, a.weight));
+			}
+		}
+		Label direct;
+		if (compression.directPath(source, target, direct)) {
+			solutions.push_back(direct);
+		}
+		std::sort(solutions.begin(), solutions.end(), groupLabels);
+		Label::weight_type min_second_weight = MAX_WEIGHT;
+		solutions.erase(std::remove_if(solutions.begin(), solutions.end(), [&min_second_weight](const Label& label) {
+			if (label.second_weight >= min_second_weight) {
+				return true; // dominated by a lexicographically smaller label
+			}
+			min_second_weight = label.second_weight;
+			return false;
+		}), solutions.end());
+	}
+
+	/** Reconstruct a path (in the input graph) of the last query that ends in the given label of the target */
+	bool unpackPath(const NodeID node, const Label& label, std::vector<NodeID>& path) {
+		path.clear();
+		if (node != target || std::find(solutions.begin(), solutions.end(), label) == solutions.end()) {
+			return false;
+		}
+		if (source == target) {
+			path.push_back(source);
+			return true;
+		}
+		Label direct;
+		if (compression.directPath(source, target, direct) && direct == label) {
+			path.push_back(source);
+			compression.appendDirectPath(source, target, path);
+			return true;
+		}
+		std::vector<NodeID> compressed_path;
+		for (const Attachment& a : target_attachments) {
+			if (a.weight.first_weight <= label.first_weight && a.weight.second_weight <= label.second_weight &&
+					search.unpackPath(a.node, Label(label.first_weight - a.weight.first_weight, label.second_weight - a.weight.second_weight), compressed_path)) {
+				compression.unpackPath(compressed_path, path);
+				compression.appendAttachmentPath(a.node, target, path);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Prepare for the next query */
+	void reset() {
+		search.reset();
+		solutions.clear();
+	}
+
+	void printStatistics() {
+		search.printStatistics();
+	}
+
+	/** Only valid for the target of the last query */
+	size_t size(const NodeID) const { return solutions.size(); }
+	std::vector<Label>::const_iterator begin(const NodeID) const { return solutions.begin(); }
+	std::vector<Label>::const_iterator end(const NodeID) const { return solutions.end(); }
+};
+
+#endif
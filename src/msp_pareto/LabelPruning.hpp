@@ -0,0 +1,157 @@
+/*
+ * Pruning predicates evaluated while the pareto minima are extracted from the
+ * ParetoQueue. A label for which the predicate holds cannot contribute to the
+ * result of the current query and is therefore never relaxed.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef LABEL_PRUNING_H_
+#define LABEL_PRUNING_H_
+
+#include "../Label.hpp"
+#include "LowerBounds.hpp"
+
+#include <vector>
+#include <atomic>
+
+/**
+ * One-to-all search: Nothing can be pruned.
+ */
+struct NoLabelPruning {
+	template<typename label_type>
+	inline bool operator()(const NodeID, const label_type&) const {
+		return false;
+	}
+};
+
+/**
+ * One-to-one search: The current label set of the target node acts as a global
+ * dominance filter. As edge weights are non-negative, a label that is (weakly)
+ * dominated by a target label can only be extended to dominated paths.
+ * With epsilon > 0, labels are already pruned if they are epsilon-dominated. The search passes
+ * its per-hop tolerance, as a pruned label adds one more hop of error to the paths it represents.
+ */
+template<typename LabelSet>
+struct TargetDominancePruning {
+	const LabelSet& target_labels;
+	const double epsilon;
+
+	TargetDominancePruning(const LabelSet& _target_labels, const double _epsilon=0)
+		: target_labels(_target_labels), epsilon(_epsilon)
+	{}
+
+	inline bool operator()(const NodeID, const Label& label) const {
+		return target_labels.dominates(epsilon > 0 ? epsilonScaled(label, epsilon) : label);
+	}
+};
+
+/**
+ * Goal-directed one-to-one search: A label is extended by the lower bounds of its
+ * node before it is checked against the target labels. Labels at nodes that 
+ * cannot reach the target are pruned right away.
+ */
+template<typename LabelSet>
+struct LowerBoundPruning {
+	const LabelSet& target_labels;
+	const LowerBounds& bounds;
+	const double epsilon;
+
+	LowerBoundPruning(const LabelSet& _target_labels, const LowerBounds& _bounds, const double _epsilon=0)
+		: target_labels(_target_labels), bounds(_bounds), epsilon(_epsilon)
+	{}
+
+	inline bool operator()(const NodeID node, const Label& label) const {
+		if (bounds[node].first_weight == MAX_WEIGHT) {
+			return true; // target unreachable
+		}
+		const Label estimate = bounds.estimate(node, label);
+		return target_labels.dominates(epsilon > 0 ? epsilonScaled(estimate, epsilon) : estimate);
+	}
+};
+
+/**
+ * Resource-constrained one-to-one search: Only the lexicographically smallest target label
+ * within the given maximum weights is of interest (use MAX_WEIGHT for an unconstrained
+ * criterion). A label is pruned if the lower bound of its extensions violates a constraint,
+ * or if it cannot beat the lexicographically smallest target label found so far. As pruned
+ * candidates never reach the target, all target labels are feasible.
+ */
+template<typename LabelSet>
+struct ResourceConstrainedPruning {
+	const LabelSet& target_labels;
+	const LowerBounds& bounds;
+	const Label max_weights;
+
+	ResourceConstrainedPruning(const LabelSet& _target_labels, const LowerBounds& _bounds, const Label& _max_weights)
+		: target_labels(_target_labels), bounds(_bounds), max_weights(_max_weights)
+	{}
+
+	inline bool operator()(const NodeID node, const Label& label) const {
+		if (bounds[node].first_weight == MAX_WEIGHT) {
+			return true; // target unreachable
+		}
+		const Label estimate = bounds.estimate(node, label);
+		if (estimate.first_weight > max_weights.first_weight || estimate.second_weight > max_weights.second_weight) {
+			return true; // infeasible
+		}
+		if (target_labels.size() == 0) {
+			return false;
+		}
+		const Label& best = target_labels.front();
+		return best.first_weight < estimate.first_weight
+			|| (best.first_weight == estimate.first_weight && best.second_weight <= estimate.second_weight);
+	}
+};
+
+/**
+ * Bidirectional one-to-one search: Like LowerBoundPruning, the solutions found so far act
+ * as dominance filter. A label that is already part of the label set of its node has been
+ * combined with all labels of the opposite direction at this node. Its remaining extensions
+ * have to pass a label still queued by the opposite direction, so its lower bounds can be
+ * raised to the smallest weights (per criterion) of this opposite queue.
+ */
+template<typename LabelSet>
+struct BidirectionalPruning {
+	const LabelSet& solutions;
+	const LowerBounds& bounds;
+	const std::vector<LabelSet>& labels;
+	const Label opposite_minimum;
+
+	BidirectionalPruning(const LabelSet& _solutions, const LowerBounds& _bounds, const std::vector<LabelSet>& _labels, const Label& _opposite_minimum)
+		: solutions(_solutions), bounds(_bounds), labels(_labels), opposite_minimum(_opposite_minimum)
+	{}
+
+	inline bool operator()(const NodeID node, const Label& label) const {
+		if (bounds[node].first_weight == MAX_WEIGHT) {
+			return true; // opposite end unreachable
+		}
+		if (solutions.dominates(bounds.estimate(node, label))) {
+			return true;
+		}
+		const Label& bound = bounds[node];
+		if (opposite_minimum.first_weight <= bound.first_weight && opposite_minimum.second_weight <= bound.second_weight) {
+			return false; // no stronger bound
+		}
+		return labels[node].contains(label) && solutions.dominates(bounds.estimate(node, label, opposite_minimum));
+	}
+};
+
+/**
+ * Probing search: Labels are relaxed until a budget of pruning checks is used up. Afterwards,
+ * all labels are pruned and the search runs dry. The counter is shared by all copies of the
+ * predicate, as the parallel search may evaluate them concurrently.
+ */
+struct BudgetPruning {
+	std::atomic<size_t>& checks;
+	const size_t budget;
+
+	BudgetPruning(std::atomic<size_t>& _checks, const size_t _budget)
+		: checks(_checks), budget(_budget)
+	{}
+
+	inline bool operator()(const NodeID, const Label&) const {
+		return checks.fetch_add(1, std::memory_order_relaxed) >= budget;
+	}
+};
+
+#endif
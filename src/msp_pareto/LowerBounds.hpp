@@ -0,0 +1,105 @@
+/*
+ * Per-criterion lower bounds on the distance to a target node (or from a source node),
+ * computed by one single-criterion (backward) Dijkstra search per weight.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef LOWER_BOUNDS_H_
+#define LOWER_BOUNDS_H_
+
+#include "../Label.hpp"
+#include "../Graph.hpp"
+#include "ReverseGraph.hpp"
+#include "../datastructures/container/BinaryHeap.hpp"
+
+#include <vector>
+#include <limits>
+#include <memory>
+#include <algorithm>
+
+class LowerBounds {
+private:
+	typedef Label::weight_type weight_type;
+	typedef utility::datastructure::BinaryHeap<NodeID, weight_type, std::numeric_limits<weight_type>> BinaryHeap;
+
+	ReverseGraph& reverse_graph;
+	std::unique_ptr<BinaryHeap> heap; // Built on first use
+	std::vector<Label> bounds;
+
+public:
+	LowerBounds(ReverseGraph& reverse_graph_):
+		reverse_graph(reverse_graph_)
+	{}
+
+	/** Compute the lower bounds of all nodes towards the given target */
+	void compute(const NodeID target) {
+		prepare();
+		dijkstra(reverse_graph, target, &Edge::edge_data::first_weight, &Label::first_weight);
+		dijkstra(reverse_graph, target, &Edge::edge_data::second_weight, &Label::second_weight);
+	}
+
+	/** Compute the lower bounds of the distances from the given source to all nodes (for backward searches) */
+	void computeFromSource(const NodeID source) {
+		prepare();
+		dijkstra(reverse_graph.original(), source, &Edge::edge_data::first_weight, &Label::first_weight);
+		dijkstra(reverse_graph.original(), source, &Edge::edge_data::second_weight, &Label::second_weight);
+	}
+
+	/** Lower bound per criterion. MAX_WEIGHT if the target is not reachable */
+	inline const Label& operator[](const NodeID node) const {
+		return bounds[node];
+	}
+
+	/** Lower bound of all extensions of the label at the node to the target. Saturates at MAX_WEIGHT */
+	inline Label estimate(const NodeID node, const Label& label) const {
+		const Label& bound = bounds[node];
+		return Label(saturatedAdd(label.first_weight, bound.first_weight),
+			saturatedAdd(label.second_weight, bound.second_weight));
+	}
+
+	/** Same as estimate(), but with each bound raised to at least the given minimum */
+	inline Label estimate(const NodeID node, const Label& label, const Label& min_bound) const {
+		const Label& bound = bounds[node];
+		return Label(saturatedAdd(label.first_weight, std::max(bound.first_weight, min_bound.first_weight)),
+			saturatedAdd(label.second_weight, std::max(bound.second_weight, min_bound.second_weight)));
+	}
+
+private:
+
+	static inline weight_type saturatedAdd(const weight_type a, const weight_type b) {
+		return a > MAX_WEIGHT - b ? MAX_WEIGHT : a + b;
+	}
+
+	void prepare() {
+		if (!heap) {
+			reverse_graph.init();
+			heap.reset(new BinaryHeap((NodeID)reverse_graph.numberOfNodes()));
+		}
+		bounds.assign(reverse_graph.numberOfNodes(), Label(MAX_WEIGHT, MAX_WEIGHT));
+	}
+
+	template<typename graph_type>
+	void dijkstra(const graph_type& graph, const NodeID root, weight_type Edge::edge_data::* edge_weight, weight_type Label::* bound) {
+		BinaryHeap& heap = *this->heap;
+		heap.clear();
+		heap.push(root, 0);
+		while (!heap.empty()) {
+			const NodeID node = heap.getMin();
+			const weight_type distance = heap.getMinKey();
+			heap.deleteMin();
+			bounds[node].*bound = distance;
+
+			FORALL_EDGES(graph, node, eid) {
+				const Edge& edge = graph.getEdge(eid);
+				const weight_type new_distance = checkedAdd<weight_type>(distance, edge.*edge_weight);
+				if (!heap.isReached(edge.target)) {
+					heap.push(edge.target, new_distance);
+				} else if (heap.contains(edge.target) && new_distance < heap.getKey(edge.target)) {
+					heap.decreaseKey(edge.target, new_distance);
+				}
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ * Pareto set (skyline) of D-criteria labels, kept in lexicographic order.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef MULTI_CRITERIA_LABEL_SET_H_
+#define MULTI_CRITERIA_LABEL_SET_H_
+
+#include "../MultiCriteriaLabel.hpp"
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Skyline of mutually non-dominated labels. As the labels are sorted lexicographically, a new
+ * label can only be dominated by its predecessors and can only dominate its successors.
+ * For D == 2 the skyline is a staircase and both checks reduce to the direct neighbours.
+ * Three criteria use an index instead (see below), more criteria scan the predecessors.
+ */
+template<unsigned short D>
+class SkylineLabelSet {
+public:
+	typedef MultiCriteriaLabel<D> Label;
+	typedef typename std::vector<Label>::iterator iterator;
+	typedef typename std::vector<Label>::const_iterator const_iterator;
+
+private:
+	typedef CriteriaTraits<D> Dominance;
+	std::vector<Label> labels;
+
+	bool isDominated(const_iterator position, const Label& label) const {
+		if (Dominance::staircase) {
+			return position != labels.begin() && Dominance::dominatesSuccessor(*(position-1), label);
+		}
+		for (const_iterator i = labels.begin(); i != position; ++i) {
+			if (Dominance::dominatesSuccessor(*i, label)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+
+	/**
+	 * Add the label unless it is (weakly) dominated by a label of the set. The labels
+	 * dominated by the new label are removed and appended to 'removed'.
+	 */
+	bool add(const Label& label, std::vector<Label>& removed) {
+		const iterator position = std::lower_bound(labels.begin(), labels.end(), label, Dominance::lexLess);
+		if ((position != labels.end() && *position == label) || isDominated(position, label)) {
+			return false;
+		}
+		iterator dominated_end = position;
+		if (Dominance::staircase) {
+			while (dominated_end != labels.end() && Dominance::dominatesSuccessor(label, *dominated_end)) {
+				removed.push_back(*dominated_end++);
+			}
+		} else {
+			dominated_end = std::stable_partition(position, labels.end(), [&label](const Label& successor) {
+				return Dominance::dominatesSuccessor(label, successor); });
+			removed.insert(removed.end(), position, dominated_end);
+		}
+		if (position == dominated_end) {
+			labels.insert(position, label);
+		} else {
+			*position = label;
+			labels.erase(position+1, dominated_end);
+		}
+		return true;
+	}
+
+	/** True if the given label is (weakly) dominated by a label of this set */
+	bool dominates(const Label& label) const {
+		const const_iterator position = std::upper_bound(labels.begin(), labels.end(), label, Dominance::lexLess);
+		return isDominated(position, label);
+	}
+
+	void reset() { labels.clear(); }
+
+	size_t size() const { return labels.size(); }
+	iterator begin() { return labels.begin(); }
+	const_iterator begin() const { return labels.begin(); }
+	iterator end() { return labels.end(); }
+	const_iterator end() const { return labels.end(); }
+};
+
+/**
+ * Insert-only index of three-criteria labels that answers whether a label is (weakly) dominated
+ * by any of the inserted labels. New labels are collected in a small buffer that is scanned
+ * linearly. Full buffers are merged into static blocks of BUFFER_SIZE * 2^i lexicographically
+ * sorted labels (logarithmic method), so that each label is rebuilt O(log n) times.
+ *
+ * Within a block, the labels of a prefix are candidates to dominate a label if their first weight
+ * is not larger. A Fenwick tree over the block splits such a prefix into O(log n) ranges. Each of
+ * its nodes stores the two-dimensional skyline of the last two weights of its range: a staircase
+ * ordered by increasing second and strictly decreasing third weight (see ParetoMinimaFilter<3>).
+ * A query therefore takes O(log^2 n) time per block.
+ */
+class DominanceIndex {
+	typedef MultiCriteriaLabel<3> Label;
+	typedef Label::weight_type weight_type;
+	typedef CriteriaTraits<3> Dominance;
+
+	struct Step {
+		weight_type second;
+		weight_type third;
+	};
+
+	struct Block {
+		std::vector<Label> labels;
+		std::vector<uint32_t> offsets; // staircase of Fenwick node j is steps[offsets[j-1], offsets[j])
+		std::vector<Step> steps;
+	};
+
+	static const size_t BUFFER_SIZE = 64;
+	std::vector<Label> buffer;
+	std::vector<Block> blocks; // blocks[i] is either empty or holds BUFFER_SIZE * 2^i labels
+	std::vector<Label> carry;
+	std::vector<Step> merged;
+	std::vector<Step> staircase;
+
+	static inline bool stepLess(const Step& a, const Step& b) {
+		return a.second < b.second || (a.second == b.second && a.third < b.third);
+	}
+
+	static inline bool secondLess(const weight_type second, const Step& step) {
+		return second < step.second;
+	}
+
+	/** The staircase of the Fenwick node j is the skyline of label j and of the staircases of its children */
+	void build(Block& block) {
+		const std::vector<Label>& labels = block.labels;
+		block.offsets.assign(1, 0);
+		block.steps.clear();
+		for (size_t j = 1; j <= labels.size(); ++j) {
+			staircase.assign(1, Step{labels[j-1][1], labels[j-1][2]});
+			for (size_t child_offset = 1; child_offset < (j & -j); child_offset <<= 1) {
+				const size_t child = j - child_offset;
+				merged.clear();
+				std::merge(staircase.begin(), staircase.end(), block.steps.begin() + block.offsets[child-1],
+					block.steps.begin() + block.offsets[child], std::back_inserter(merged), stepLess);
+				staircase.clear();
+				for (const Step& step : merged) {
+					if (staircase.empty() || step.third < staircase.back().third) {
+						staircase.push_back(step);
+					}
+				}
+			}
+			block.steps.insert(block.steps.end(), staircase.begin(), staircase.end());
+			block.offsets.push_back(block.steps.size());
+		}
+	}
+
+	static bool isDominated(const Block& block, const Label& label) {
+		size_t j = std::upper_bound(block.labels.begin(), block.labels.end(), label, Dominance::lexLess) - block.labels.begin();
+		for (; j > 0; j -= j & -j) {
+			const auto begin = block.steps.begin() + block.offsets[j-1];
+			const auto step = std::upper_bound(begin, block.steps.begin() + block.offsets[j], label[1], secondLess);
+			if (step != begin && (step-1)->third <= label[2]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	DominanceIndex() {
+		buffer.reserve(BUFFER_SIZE);
+	}
+
+	void add(const Label& label) {
+		buffer.push_back(label);
+		if (buffer.size() < BUFFER_SIZE) {
+			return;
+		}
+		std::sort(buffer.begin(), buffer.end(), Dominance::lexLess);
+		carry.swap(buffer);
+		buffer.clear();
+		size_t level = 0;
+		for (; level < blocks.size() && !blocks[level].labels.empty(); ++level) {
+			std::vector<Label>& labels = blocks[level].labels;
+			buffer.resize(carry.size() + labels.size());
+			std::merge(carry.begin(), carry.end(), labels.begin(), labels.end(), buffer.begin(), Dominance::lexLess);
+			carry.swap(buffer);
+			buffer.clear();
+			labels.clear();
+		}
+		if (level == blocks.size()) {
+			blocks.emplace_back();
+		}
+		blocks[level].labels.swap(carry);
+		build(blocks[level]);
+	}
+
+	bool isDominated(const Label& label) const {
+		for (const Label& other : buffer) {
+			if (Dominance::dominates(other, label)) {
+				return true;
+			}
+		}
+		for (const Block& block : blocks) {
+			if (!block.labels.empty() && isDominated(block, label)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void clear() {
+		buffer.clear();
+		blocks.clear();
+	}
+};
+
+/**
+ * Three criteria: The dominance checks are answered by a DominanceIndex instead of scanning the
+ * predecessors. A second index of the complemented weights (MAX_WEIGHT - weight) tells whether
+ * the new label dominates any label of the set, so that the set is only searched for these rare
+ * removals. Removed labels stay in the indexes, as a label dominated by a removed label is also
+ * dominated by the label that removed it. The indexes are rebuilt once they are twice as large
+ * as the set. New labels are appended and only sorted when required.
+ */
+template<>
+class SkylineLabelSet<3> {
+public:
+	typedef MultiCriteriaLabel<3> Label;
+	typedef std::vector<Label>::iterator iterator;
+	typedef std::vector<Label>::const_iterator const_iterator;
+
+private:
+	typedef CriteriaTraits<3> Dominance;
+	static const size_t MIN_REBUILD_SIZE = 1024;
+
+	mutable std::vector<Label> labels; // lexicographically sorted up to sorted_size
+	mutable size_t sorted_size;
+	DominanceIndex lower;
+	DominanceIndex upper; // of the complemented labels
+	size_t indexed_size;
+
+	static inline Label complemented(const Label& label) {
+		Label complement;
+		for (unsigned short i = 0; i < 3; ++i) {
+			complement[i] = MAX_WEIGHT - label[i];
+		}
+		return complement;
+	}
+
+	void sort() const {
+		if (sorted_size < labels.size()) {
+			std::sort(labels.begin() + sorted_size, labels.end(), Dominance::lexLess);
+			std::inplace_merge(labels.begin(), labels.begin() + sorted_size, labels.end(), Dominance::lexLess);
+			sorted_size = labels.size();
+		}
+	}
+
+	void removeDominated(const Label& label, std::vector<Label>& removed) {
+		sort();
+		iterator out = std::lower_bound(labels.begin(), labels.end(), label, Dominance::lexLess);
+		for (iterator i = out; i != labels.end(); ++i) {
+			if (Dominance::dominatesSuccessor(label, *i)) {
+				removed.push_back(*i);
+			} else {
+				*out++ = *i;
+			}
+		}
+		labels.erase(out, labels.end());
+		sorted_size = labels.size();
+	}
+
+	void rebuildIndexes() {
+		lower.clear();
+		upper.clear();
+		for (const Label& label : labels) {
+			lower.add(label);
+			upper.add(complemented(label));
+		}
+		indexed_size = labels.size();
+	}
+
+public:
+	SkylineLabelSet():
+		sorted_size(0),
+		indexed_size(0)
+	{}
+
+	/**
+	 * Add the label unless it is (weakly) dominated by a label of the set. The labels
+	 * dominated by the new label are removed and appended to 'removed'.
+	 */
+	bool add(const Label& label, std::vector<Label>& removed) {
+		if (lower.isDominated(label)) {
+			return false;
+		}
+		if (upper.isDominated(complemented(label))) {
+			removeDominated(label, removed);
+		}
+		labels.push_back(label);
+		lower.add(label);
+		upper.add(complemented(label));
+		if (++indexed_size > std::max(2 * labels.size(), MIN_REBUILD_SIZE)) {
+			rebuildIndexes();
+		}
+		return true;
+	}
+
+	/** True if the given label is (weakly) dominated by a label of this set */
+	bool dominates(const Label& label) const {
+		return lower.isDominated(label);
+	}
+
+	void reset() {
+		labels.clear();
+		sorted_size = 0;
+		lower.clear();
+		upper.clear();
+		indexed_size = 0;
+	}
+
+	size_t size() const { return labels.size(); }
+	iterator begin() { sort(); return labels.begin(); }
+	const_iterator begin() const { sort(); return labels.begin(); }
+	iterator end() { sort(); return labels.end(); }
+	const_iterator end() const { sort(); return labels.end(); }
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Pareto queue of D-criteria node labels, the D-criteria VectorParetoQueue: The labels are kept
+ * sorted lexicographically by weight, so that the pareto minima are found within a single sweep
+ * and all updates of an iteration are merged within a single pass.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef MULTI_CRITERIA_PARETO_QUEUE_H_
+#define MULTI_CRITERIA_PARETO_QUEUE_H_
+
+#include "../MultiCriteriaLabel.hpp"
+#ifdef PARALLEL_BUILD
+	#include "ParetoQueue_parallel.hpp"
+#else
+	#include "ParetoQueue_sequential.hpp"
+#endif
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cassert>
+
+/**
+ * The pareto minima found so far within a sweep of the queue. Queried labels must not be
+ * lexicographically smaller than any of the minima, so only a minimum with different weights
+ * can dominate them. Without further structure, a query has to check all minima.
+ */
+template<unsigned short D>
+class ParetoMinimaFilter {
+	typedef CriteriaTraits<D> Dominance;
+	typedef MultiCriteriaLabel<D> Label;
+	std::vector<Label> minima;
+
+public:
+	void clear() { minima.clear(); }
+
+	bool isDominated(const Label& label) const {
+		if (Dominance::staircase) {
+			return !minima.empty() && minima.back() != label && Dominance::dominatesSuccessor(minima.back(), label);
+		}
+		for (const Label& min : minima) {
+			if (Dominance::dominatesSuccessor(min, label) && min != label) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Add a label that is not dominated */
+	void add(const Label& label) { minima.push_back(label); }
+};
+
+/**
+ * Three criteria: Only the last two weights decide whether a minimum dominates a queried label.
+ * Their two-dimensional skyline is a staircase, ordered by increasing second and strictly
+ * decreasing third weight. Its step left of the label has the smallest third weight of all
+ * minima that are not worse in the second weight, so a query takes logarithmic time.
+ */
+template<>
+class ParetoMinimaFilter<3> {
+	typedef MultiCriteriaLabel<3> Label;
+	typedef Label::weight_type weight_type;
+	std::map<weight_type, Label> staircase;
+
+	const Label* step(const Label& label) const {
+		auto it = staircase.upper_bound(label[1]);
+		if (it == staircase.begin()) {
+			return nullptr;
+		}
+		--it;
+		return it->second[2] <= label[2] ? &it->second : nullptr;
+	}
+
+public:
+	void clear() { staircase.clear(); }
+
+	bool isDominated(const Label& label) const {
+		const Label* const min = step(label);
+		// a minimum with equal second and third weight but a smaller first weight
+		// dominates the label, even if an equal minimum exists too
+		return min != nullptr && *min != label;
+	}
+
+	void add(const Label& label) {
+		if (step(label) != nullptr) {
+			return; // equal weights, the step is already there
+		}
+		auto it = staircase.lower_bound(label[1]);
+		while (it != staircase.end() && it->second[2] >= label[2]) {
+			it = staircase.erase(it);
+		}
+		staircase.emplace_hint(it, label[1], label);
+	}
+};
+
+template<unsigned short D>
+class MultiCriteriaParetoQueue {
+public:
+	typedef MultiCriteriaLabel<D> Label;
+	typedef MultiCriteriaNodeLabel<D> NodeLabel;
+
+private:
+	typedef CriteriaTraits<D> Dominance;
+	typedef GroupMultiCriteriaNodeLabelsByWeightAndNodeComperator<D> Comperator;
+
+	typedef std::vector<NodeLabel> QueueType;
+	QueueType labels;
+	QueueType temp;
+	ParetoMinimaFilter<D> minima;
+
+public:
+
+	void init(const NodeLabel& data) {
+		labels.clear();
+		labels.push_back(data);
+	}
+
+	/** Returns the number of pareto minima */
+	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning=NoLabelPruning>
+	size_t findParetoMinima(upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune=Pruning()) {
+		const size_t updates_before = updates.size();
+		minima.clear();
+
+		for (const NodeLabel& label : labels) {
+			if (minima.isDominated(label)) {
+				continue;
+			}
+			minima.add(label);
+			updates.emplace_back(Operation<NodeLabel>::DELETE, label);
+			if (prune(label.node, label)) {
+				continue; // retire the minimum without relaxing it
+			}
+			FORALL_EDGES(graph, label.node, eid) {
+				const auto& edge = graph.getEdge(eid);
+				const Label candidate = Dominance::extended(label, edge);
+				if (!prune(edge.target, candidate)) {
+					candidates.emplace_back(edge.target, candidate);
+				}
+			}
+		}
+		return updates.size() - updates_before;
+	}
+
+	/** Updates have to be sorted by weight and node. Deleted labels have to be in the queue */
+	void applyUpdates(const std::vector<Operation<NodeLabel> >& updates) {
+		const Comperator less;
+		typename QueueType::const_iterator label_iter = labels.begin();
+
+		temp.clear();
+		for (const Operation<NodeLabel>& update : updates) {
+			while (label_iter != labels.end() && less(*label_iter, update.data)) {
+				temp.push_back(*label_iter++);
+			}
+			if (update.type == Operation<NodeLabel>::DELETE) {
+				assert(label_iter != labels.end() && *label_iter == update.data && label_iter->node == update.data.node);
+				++label_iter; // delete the element by jumping over it
+			} else {
+				temp.push_back(update.data);
+			}
+		}
+		temp.insert(temp.end(), label_iter, labels.cend());
+		labels.swap(temp);
+	}
+
+	size_t size() const { return labels.size(); }
+	bool empty() const { return labels.empty(); }
+};
+
+#endif
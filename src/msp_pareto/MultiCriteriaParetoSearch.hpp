@@ -0,0 +1,150 @@
+/*
+ * Pareto search for a compile-time number of criteria D. MultiCriteriaParetoSearch<2> is the
+ * (parallel) bi-criteria ParetoSearch. For more criteria, the SkylineParetoSearch runs the same
+ * iteration on D-criteria label sets and queue: relax _all_ globaly pareto optimal labels at once.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef MULTI_CRITERIA_PARETO_SEARCH_H_
+#define MULTI_CRITERIA_PARETO_SEARCH_H_
+
+#ifdef PARALLEL_BUILD
+	#include "ParetoSearch_parallel.hpp"
+#else
+	#include "ParetoSearch_sequential.hpp"
+#endif
+
+#include "../MultiCriteriaLabel.hpp"
+#include "../Graph.hpp"
+
+#include "MultiCriteriaLabelSet.hpp"
+#include "MultiCriteriaParetoQueue.hpp"
+
+#include <vector>
+#include <algorithm>
+
+template<unsigned short D>
+struct GroupMultiCriteriaOperationsByWeightAndNodeComperator {
+	inline bool operator() (const Operation<MultiCriteriaNodeLabel<D>>& i, const Operation<MultiCriteriaNodeLabel<D>>& j) const {
+		return GroupMultiCriteriaNodeLabelsByWeightAndNodeComperator<D>()(i.data, j.data);
+	}
+};
+
+template<unsigned short D, typename graph_slot=MultiCriteriaGraph<D>>
+class SkylineParetoSearch {
+public:
+	typedef MultiCriteriaLabel<D> Label;
+	typedef MultiCriteriaNodeLabel<D> NodeLabel;
+	typedef SkylineLabelSet<D> LabelSet;
+	typedef typename LabelSet::iterator iterator;
+	typedef typename LabelSet::const_iterator const_iterator;
+
+private:
+	const graph_slot& graph;
+	std::vector<LabelSet> labels;
+	MultiCriteriaParetoQueue<D> pq;
+
+	std::vector<Operation<NodeLabel>> updates;
+	std::vector<NodeLabel> candidates;
+	std::vector<Label> removed;
+	std::vector<NodeID> touched_nodes;
+
+	size_t iterations;
+
+	struct TargetDominancePruning {
+		const LabelSet& target_labels;
+		inline bool operator()(const NodeID, const Label& label) const { return target_labels.dominates(label); }
+	};
+
+public:
+	SkylineParetoSearch(const graph_slot& graph_):
+		graph(graph_),
+		labels(graph_.numberOfNodes()),
+		iterations(0)
+	{}
+
+	/** One-to-all search: Compute the pareto optimal labels of all nodes */
+	void run(const NodeID node) {
+		search(node, NoLabelPruning());
+	}
+
+	/** One-to-one search: Labels dominated by the current target labels are not relaxed any further */
+	void run(const NodeID node, const NodeID target) {
+		search(node, TargetDominancePruning{labels[target]});
+	}
+
+	/** Prepare for the next query by clearing all label sets touched since the last reset */
+	void reset() {
+		for (const NodeID node : touched_nodes) {
+			labels[node].reset();
+		}
+		touched_nodes.clear();
+	}
+
+	void printStatistics() const {
+		std::cout << "# Iterations: " << iterations << std::endl;
+	}
+
+	size_t size(NodeID node) const { return labels[node].size(); }
+	iterator begin(NodeID node) { return labels[node].begin(); }
+	const_iterator begin(NodeID node) const { return labels[node].begin(); }
+	iterator end(NodeID node) { return labels[node].end(); }
+	const_iterator end(NodeID node) const { return labels[node].end(); }
+
+private:
+
+	template<typename Pruning>
+	void search(const NodeID node, const Pruning& prune) {
+		labels[node].add(Label(), removed);
+		touched_nodes.push_back(node);
+		pq.init(NodeLabel(node, Label()));
+
+		while (!pq.empty()) {
+			++iterations;
+			pq.findParetoMinima(updates, candidates, graph, prune);
+
+			// Within a node, lexicographically smaller candidates come first and can therefore
+			// never be dominated by the following ones. Removed labels are thus always queued.
+			std::sort(candidates.begin(), candidates.end(), GroupMultiCriteriaNodeLabelsByNodeAndWeightComperator<D>());
+			for (const NodeLabel& candidate : candidates) {
+				LabelSet& ls = labels[candidate.node];
+				if (ls.size() == 0) {
+					touched_nodes.push_back(candidate.node);
+				}
+				if (ls.add(candidate, removed)) {
+					updates.emplace_back(Operation<NodeLabel>::INSERT, candidate);
+					for (const Label& label : removed) {
+						updates.emplace_back(Operation<NodeLabel>::DELETE, candidate.node, label);
+					}
+				}
+				removed.clear();
+			}
+			std::sort(updates.begin(), updates.end(), GroupMultiCriteriaOperationsByWeightAndNodeComperator<D>());
+			pq.applyUpdates(updates);
+
+			candidates.clear();
+			updates.clear();
+		}
+	}
+};
+
+template<unsigned short D>
+struct MultiCriteriaTypes {
+	typedef SkylineLabelSet<D> LabelSet;
+	typedef SkylineParetoSearch<D> ParetoSearch;
+};
+
+/** The bi-criteria search keeps its specialized label sets and (parallel) queues */
+template<>
+struct MultiCriteriaTypes<2> {
+	typedef ParetoLabelSet LabelSet;
+	typedef ::ParetoSearch<> ParetoSearch;
+};
+
+template<unsigned short D>
+using MultiCriteriaLabelSet = typename MultiCriteriaTypes<D>::LabelSet;
+
+template<unsigned short D>
+using MultiCriteriaParetoSearch = typename MultiCriteriaTypes<D>::ParetoSearch;
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Storage of the bucket based ParetoQueues, meant for graphs with small integer edge weights.
+ * Each bucket holds all labels of a single first weight, sorted by decreasing second weight
+ * (and node), so that the pareto minima of a bucket are found at its back. The second weights
+ * of these bucket minima are kept in a separate, dense array: The buckets holding pareto minima
+ * are those whose minimum undercuts the minima of all buckets before it.
+ *
+ * The lexicographically smallest label is always a pareto minimum, so the smallest first weight
+ * within the queue only grows. The buckets therefore form a circular array that only has to span
+ * the first weights currently in use. It grows whenever this span exceeds its capacity.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef PARETO_BUCKETS_H_
+#define PARETO_BUCKETS_H_
+
+#include "../options.hpp"
+#include "../Label.hpp"
+#include "../Graph.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+class ParetoBuckets {
+public:
+	typedef Label::weight_type weight_type;
+	typedef std::vector<NodeLabel> Bucket;
+
+private:
+	static const size_t initial_capacity = 1024;
+
+	std::vector<Bucket> buckets;
+	std::vector<weight_type> bucket_minima; // second weight at the back of each bucket, MAX_WEIGHT if empty
+	size_t mask;
+
+	// All buckets outside of [lowest, highest] are empty
+	weight_type lowest;
+	weight_type highest;
+
+	/** Order of the labels within a bucket */
+	static inline bool greater(const NodeLabel& i, const NodeLabel& j) {
+		return i.second_weight > j.second_weight || (i.second_weight == j.second_weight && i.node > j.node);
+	}
+
+public:
+	ParetoBuckets():
+		buckets(initial_capacity),
+		bucket_minima(initial_capacity, MAX_WEIGHT),
+		mask(initial_capacity - 1),
+		lowest(0),
+		highest(0)
+	{}
+
+	size_t capacity() const {
+		return buckets.size();
+	}
+
+	/**
+	 * Make room for labels with first weights in [first, last]. Must not be called concurrently
+	 * with any other method. If the queue is empty, the previous range is dropped.
+	 */
+	void cover(const weight_type first, const weight_type last, const bool queue_empty) {
+		const weight_type new_lowest = queue_empty ? first : std::min(lowest, first);
+		const weight_type new_highest = queue_empty ? last : std::max(highest, last);
+		const size_t span = (size_t) new_highest - new_lowest + 1;
+
+		if (span > capacity()) {
+			size_t grown_capacity = capacity();
+			while (grown_capacity < span) {
+				grown_capacity *= 2;
+			}
+			std::vector<Bucket> grown(grown_capacity);
+			std::vector<weight_type> grown_minima(grown_capacity, MAX_WEIGHT);
+			for (size_t w = lowest; w <= highest; ++w) {
+				grown[w & (grown_capacity - 1)].swap(buckets[w & mask]);
+				grown_minima[w & (grown_capacity - 1)] = bucket_minima[w & mask];
+			}
+			buckets.swap(grown);
+			bucket_minima.swap(grown_minima);
+			mask = grown_capacity - 1;
+		}
+		lowest = new_lowest;
+		highest = new_highest;
+	}
+
+	/** Drop all labels */
+	void clear() {
+		for (size_t w = lowest; w <= highest; ++w) {
+			buckets[w & mask].clear();
+			bucket_minima[w & mask] = MAX_WEIGHT;
+		}
+	}
+
+	/**
+	 * Merge the sorted updates [begin, end) of a single first weight into its bucket, which has to
+	 * be covered. Updates of different buckets can be applied concurrently, each with its own merge
+	 * buffer. Returns the change of the label count.
+	 */
+	long applyBucketUpdates(const Operation<NodeLabel>* const begin, const Operation<NodeLabel>* const end, Bucket& merged) {
+		const size_t index = begin->data.first_weight & mask;
+		Bucket& bucket = buckets[index];
+		assert(begin->data.first_weight >= lowest && begin->data.first_weight <= highest);
+
+		long delta = 0;
+		merged.clear();
+		auto in = bucket.cbegin();
+		// The updates are in increasing order, the bucket in decreasing
+		for (const Operation<NodeLabel>* op = end; op != begin; ) {
+			const NodeLabel& label = (--op)->data;
+			switch (op->type) {
+			case Operation<NodeLabel>::DELETE:
+				while (in != bucket.cend() && (in->second_weight != label.second_weight || in->node != label.node)) {
+					merged.push_back(*in++);
+				}
+				assert(in != bucket.cend() && "deleted label has to be in the queue");
+				if (in != bucket.cend()) {
+					++in; // delete the element by jumping over it
+					--delta;
+				}
+				continue;
+			case Operation<NodeLabel>::INSERT:
+				while (in != bucket.cend() && greater(*in, label)) {
+					merged.push_back(*in++);
+				}
+				merged.push_back(label);
+				++delta;
+				continue;
+			}
+		}
+		merged.insert(merged.end(), in, bucket.cend());
+		bucket.swap(merged);
+		bucket_minima[index] = bucket.empty() ? MAX_WEIGHT : bucket.back().second_weight;
+		return delta;
+	}
+
+	/** Append the first weights of all buckets holding pareto minima, in increasing order */
+	void collectMinimaBuckets(std::vector<weight_type>& minima_buckets) {
+		while (lowest < highest && bucket_minima[lowest & mask] == MAX_WEIGHT) {
+			++lowest;
+		}
+		while (highest > lowest && bucket_minima[highest & mask] == MAX_WEIGHT) {
+			--highest;
+		}
+		weight_type min = MAX_WEIGHT;
+		for (size_t w = lowest; w <= highest; ++w) {
+			const weight_type bucket_min = bucket_minima[w & mask];
+			if (bucket_min < min) {
+				minima_buckets.push_back(w);
+				min = bucket_min;
+			}
+		}
+	}
+
+	/**
+	 * Remove the pareto minima of the given bucket (i.e., all labels with its smallest second weight)
+	 * and relax those that are not pruned. Different buckets can be processed concurrently.
+	 * Returns the number of removed minima.
+	 */
+	template<typename cand_sequence_type, typename graph_type, typename Pruning>
+	size_t extractMinima(const weight_type first_weight, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) {
+		const size_t index = first_weight & mask;
+		Bucket& bucket = buckets[index];
+		const weight_type min = bucket_minima[index];
+
+		size_t count = 0;
+		while (!bucket.empty() && bucket.back().second_weight == min) {
+			const NodeLabel label = bucket.back();
+			bucket.pop_back();
+			++count;
+			if (prune(label.node, label)) {
+				continue; // retire the minimum without relaxing it
+			}
+			FORALL_EDGES(graph, label.node, eid) {
+				const auto& edge = graph.getEdge(eid);
+				const Label candidate = extended(label, edge);
+				if (!prune(edge.target, candidate)) {
+					candidates.emplace_back(edge.target, candidate);
+				}
+			}
+		}
+		bucket_minima[index] = bucket.empty() ? MAX_WEIGHT : bucket.back().second_weight;
+		return count;
+	}
+};
+
+#endif
@@ -132,15 +132,16 @@ public:
 public:
 
 
+    /** With epsilon > 0, candidates that are epsilon-dominated by a label of the set are rejected */
     template<class NodeID, class candidates_iter_type, class PQUpdates, class Stats>
-    void updateLabelSet(const NodeID node, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& pq_updates, ThreadLocalLSData& _data, Stats& ls_stats) {
+    void updateLabelSet(const NodeID node, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& pq_updates, ThreadLocalLSData& _data, Stats& ls_stats, const double epsilon=0) {
         tls_data = &_data; // pupulate with current (thread local) data structures
 
         inner_node_data fake_slot;
         fake_slot.childid = root;
         fake_slot.weight = stats.itemcount;
         batch_type = INSERTS_ONLY;
-        generateUpdates(node, fake_slot, start, end, pq_updates, MAX_WEIGHT, /*continued check*/ false, ls_stats);
+        generateUpdates(node, fake_slot, start, end, pq_updates, MAX_WEIGHT, /*continued check*/ false, ls_stats, epsilon);
         stats.itemcount = fake_slot.weight;
         root = fake_slot.childid;
 
@@ -164,13 +165,73 @@ public:
         apply_updates(upds, INSERTS_ONLY);
     }
 
+    /** Remove all labels. A single root leaf is kept for the next query */
+    void reset() {
+        if (root->isleafnode()) {
+            static_cast<leaf_node*>(root)->initialize();
+            stats.itemcount = 0;
+        } else {
+            clear();
+            root = allocate_leaf();
+        }
+    }
+
+    /** True if the given label is (weakly) dominated by a label of this set */
+    bool dominates(const Label& label) const {
+        const Label* predecessor = find_x_predecessor(label);
+        return predecessor != NULL && predecessor->second_weight <= label.second_weight;
+    }
+
+    /** True if the given label is contained in this set */
+    bool contains(const Label& label) const {
+        const Label* predecessor = find_x_predecessor(label);
+        return predecessor != NULL && *predecessor == label;
+    }
+
+    /** The label with the smallest first weight (i.e., the lexicographic minimum). Requires size() > 0 */
+    const Label& front() const {
+        const node* n = root;
+        while (!n->isleafnode()) {
+            n = static_cast<const inner_node*>(n)->slot[0].childid;
+        }
+        return static_cast<const leaf_node*>(n)->slotkey[0];
+    }
+
 private:
 
+    /** 
+     * The last label with a first weight <= label.first_weight. Within a pareto set, 
+     * it is the label with the smallest second weight among all such labels.
+     */
+    const Label* find_x_predecessor(const Label& label) const {
+        if (root == NULL || size() == 0) {
+            return NULL;
+        }
+        const Label* predecessor = NULL;
+        const node* n = root;
+        while (!n->isleafnode()) {
+            const inner_node* const inner = static_cast<const inner_node*>(n);
+            width_type i = 0;
+            while (i < inner->slotuse-1 && inner->slot[i].slotkey.first_weight <= label.first_weight) {
+                ++i;
+            }
+            if (i > 0) {
+                predecessor = &inner->slot[i-1].slotkey;
+            }
+            n = inner->slot[i].childid;
+        }
+        const leaf_node* const leaf = static_cast<const leaf_node*>(n);
+        for (width_type i = 0; i < leaf->slotuse && leaf->slotkey[i].first_weight <= label.first_weight; ++i) {
+            predecessor = &leaf->slotkey[i];
+        }
+        return predecessor;
+    }
+
     template<class NodeID, class candidates_iter_type, class PQUpdates, class Stats>
-    inline Label::weight_type generateUpdates(const NodeID node, inner_node_data& slot, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& pq_updates, Label::weight_type min, bool continue_check, Stats& stats) {
+    inline Label::weight_type generateUpdates(const NodeID node, inner_node_data& slot, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& pq_updates, Label::weight_type min, bool continue_check, Stats& stats, const double epsilon) {
 
         if (slot.childid->isleafnode()) {
-            return generateLeafUpdates(node, slot, start, end, pq_updates, min, stats);
+            return generateLeafUpdates(node, slot, start, end, pq_updates, min, stats, epsilon);
         } else {
             inner_node* const inner = static_cast<inner_node*>(slot.childid);
             const width_type slotuse = inner->slotuse;
@@ -192,7 +253,7 @@ private:
                 }
                 if (sub_start != sub_end || continue_check) {
                     const width_type pre_weight = inner->slot[i].weight;
-                    min = generateUpdates(node, inner->slot[i], sub_start, sub_end, pq_updates, min, continue_check, stats);
+                    min = generateUpdates(node, inner->slot[i], sub_start, sub_end, pq_updates, min, continue_check, stats, epsilon);
                     const signed short diff = inner->slot[i].weight - pre_weight;
                     slot.weight += diff;
                     // if the last element (router) is dominated, also check for dominance in the next leaf
@@ -213,6 +274,10 @@ private:
                     stats.report(DOMINATION_SHORTCUT);
                     continue; 
                 }
+                if (epsilon > 0 && isEpsilonDominatedByPredecessors(min, new_label, epsilon)) {
+                    stats.report(LABEL_DOMINATED);
+                    continue;
+                }
                 stats.report(LABEL_NONDOMINATED);
                 min = new_label.second_weight;
                 local_upds.emplace_back(Operation<Label>::INSERT, new_label);
@@ -249,8 +314,26 @@ private:
         return false;
     }
 
+    /** Epsilon-dominated by a label left of the new label (with min being their smallest second weight) */
+    static inline bool isEpsilonDominatedByPredecessors(const Label::weight_type min, const Label& new_label, const double epsilon) {
+        return min != MAX_WEIGHT && min <= epsilonScaled(new_label, epsilon).second_weight;
+    }
+
+    /** 
+     * Check for a label that is not dominated: Is it epsilon-dominated by a label left of it or by the 
+     * last label of the set with a first weight of at most (1+epsilon) times its own?
+     */
+    inline bool isEpsilonDominated(const Label::weight_type min, const Label& new_label, const double epsilon) const {
+        if (isEpsilonDominatedByPredecessors(min, new_label, epsilon)) {
+            return true;
+        }
+        const Label scaled = epsilonScaled(new_label, epsilon);
+        const Label* predecessor = find_x_predecessor(scaled);
+        return predecessor != NULL && predecessor->second_weight <= scaled.second_weight;
+    }
+
     template<class NodeID, class candidates_iter_type, class PQUpdates, class Stats>
-    inline Label::weight_type generateLeafUpdates(const NodeID node, inner_node_data& slot, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& pq_updates, Label::weight_type min, Stats& stats) {
+    inline Label::weight_type generateLeafUpdates(const NodeID node, inner_node_data& slot, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& pq_updates, Label::weight_type min, Stats& stats, const double epsilon) {
         auto& local_upds = tls_data->local_updates;
 
         const leaf_node* const leaf = static_cast<leaf_node*>(slot.childid);
@@ -281,6 +364,8 @@ private:
             if (isDominated(leaf, i, new_label)) {
                 stats.report(LABEL_DOMINATED);
                 min = leaf->slotkey[i].second_weight;
+            } else if (epsilon > 0 && isEpsilonDominated(i > 0 ? std::min(min, leaf->slotkey[i-1].second_weight) : min, new_label, epsilon)) {
+                stats.report(LABEL_DOMINATED);
             } else {
                 stats.report(LABEL_NONDOMINATED);
                 min = new_label.second_weight;
@@ -407,8 +492,9 @@ public:
         labels.insert(labels.end(), Label(MAX_WEIGHT, MIN_WEIGHT));
     }
 
+    /** With epsilon > 0, candidates that are epsilon-dominated by a label of the set are rejected */
     template<class NodeID, class candidates_iter_type, class Stats, class PQUpdates>
-    void updateLabelSet(const NodeID node, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& updates, const ThreadLocalLSData&, Stats& stats) {
+    void updateLabelSet(const NodeID node, const candidates_iter_type start, const candidates_iter_type end, PQUpdates& updates, const ThreadLocalLSData&, Stats& stats, const double epsilon=0) {
         typename Label::weight_type min = MAX_WEIGHT;
         int modifications = 0;
 
@@ -438,6 +524,11 @@ public:
                 perform_deferred_insertion(deferred_insertion, deferred_ins_pos_start, previous_first_nondominated, deferred_ins_cand_start, candidate);
                 continue;
             }
+            if (epsilon > 0 && isEpsilonDominated(min, new_label, iter, epsilon)) {
+                stats.report(LABEL_DOMINATED);
+                perform_deferred_insertion(deferred_insertion, deferred_ins_pos_start, previous_first_nondominated, deferred_ins_cand_start, candidate);
+                continue;
+            }
             // Log upcoming insertion
             ++modifications;
             stats.report(LABEL_NONDOMINATED);
@@ -493,6 +584,33 @@ public:
         labels.insert(++labels.begin(), label);
     }
 
+    /** Remove all labels but keep the sentinals and the reserved memory */
+    void reset() {
+        labels.erase(++labels.begin(), --labels.end());
+    }
+
+    /** True if the given label is (weakly) dominated by a label of this set */
+    inline bool dominates(const Label& label) const {
+        // x-predecessor: the sentinal guarantees that there is one
+        const_label_iter iter = --std::lower_bound(++labels.begin(), --labels.end(), label, WeightLessComp());
+        if (iter->second_weight <= label.second_weight) {
+            return true;
+        }
+        ++iter; // element with greater or equal x-coordinate
+        return iter->first_weight == label.first_weight && iter->second_weight <= label.second_weight;
+    }
+
+    /** True if the given label is contained in this set */
+    inline bool contains(const Label& label) const {
+        const_label_iter iter = std::lower_bound(++labels.begin(), --labels.end(), label, WeightLessComp());
+        return *iter == label;
+    }
+
+    /** The label with the smallest first weight (i.e., the lexicographic minimum). Requires size() > 0 */
+    inline const Label& front() const {
+        return labels[1]; // behind the leading sentinal
+    }
+
     // Accessors, corrected for internal sentinals
     size_t size() const { return labels.size() - 2; };
     label_iter begin() { return ++labels.begin(); }
@@ -566,6 +684,21 @@ private:
         return false;
     }
 
+    /** 
+     * Check for a label that is not dominated (iter points to its successor): Is it epsilon-dominated by
+     * a label left of it (with min being their smallest second weight), its x-predecessor, or by the last
+     * not yet processed label with a first weight of at most (1+epsilon) times its own?
+     */
+    inline bool isEpsilonDominated(const Label::weight_type min, const Label& new_label, const label_iter iter, const double epsilon) {
+        const Label scaled = epsilonScaled(new_label, epsilon);
+        if ((min != MAX_WEIGHT && min <= scaled.second_weight) || 
+            (iter-1 != labels.begin() && (iter-1)->second_weight <= scaled.second_weight)) {
+            return true;
+        }
+        const label_iter last = --std::upper_bound(iter, --labels.end(), scaled, firstWeightLess);
+        return last >= iter && last->second_weight <= scaled.second_weight;
+    }
+
 };
 
 #endif // _PARETO_LABELSET_H_
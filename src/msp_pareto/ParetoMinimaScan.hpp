@@ -0,0 +1,317 @@
+/*
+ * Scan for the pareto minima within a leaf of the B-tree based ParetoQueues. The keys of a leaf
+ * are sorted lexicographically, so a key is a minimum if its second weight is smaller than the
+ * prefix minimum of all second weights before it (or if it has the same weights as the minimum
+ * directly before it). Instead of a data dependent branch per key, a vectorized prefix-min over
+ * the second weights computes a bitmask of all candidates. Only these are checked one by one.
+ * Leaves with separate weight arrays (soa_leaf_slots) are loaded directly, array of struct
+ * leaves are split into their weights first.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef PARETO_MINIMA_SCAN_H_
+#define PARETO_MINIMA_SCAN_H_
+
+#include "../options.hpp"
+#include "../Label.hpp"
+#include "../datastructures/btree/LeafSlots.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+#ifdef SIMD_PARETO_MINIMA
+#include <immintrin.h>
+#endif
+
+/**
+ * Computes a superset of the pareto minima among the n sorted keys of a leaf: Bit i of the mask is
+ * set if the second weight of key i is smaller than all second weights before it (including the
+ * prefix minimum) or if key i has the same weights as its predecessor (or the prefix minimum). As
+ * in the B-tree, the prefix minimum must not be lexicographically larger than the keys.
+ * The mask needs to hold (n+63)/64 words.
+ */
+template<typename key_type>
+class ParetoMinimaScan {
+private:
+	typedef typename key_type::weight_type weight_type;
+
+	/** The vectorized kernels work on 32 bit weights. Array of struct leaves need keys of three 32 bit words */
+	static constexpr bool vectorizable_soa = std::is_same<weight_type, uint32_t>::value;
+	static constexpr bool vectorizable_aos = vectorizable_soa && sizeof(key_type) == 3 * sizeof(uint32_t);
+
+public:
+	template<size_t max_keys>
+	static inline void candidates(const aos_leaf_slots<key_type, max_keys>& slots, const size_t n, const Label& prefix_minima, uint64_t* const mask) {
+		clear(n, mask);
+		candidates(slots.keys, n, prefix_minima, mask, std::integral_constant<bool, vectorizable_aos>());
+	}
+
+	template<size_t max_keys>
+	static inline void candidates(const soa_leaf_slots<key_type, max_keys>& slots, const size_t n, const Label& prefix_minima, uint64_t* const mask) {
+		clear(n, mask);
+		candidates(slots.first_weight, slots.second_weight, n, prefix_minima, mask, std::integral_constant<bool, vectorizable_soa>());
+	}
+
+private:
+	static inline void clear(const size_t n, uint64_t* const mask) {
+		for (size_t w = 0; w < (n + 63) / 64; ++w) {
+			mask[w] = 0;
+		}
+	}
+
+	/** Scalar scan of the keys [begin, n), continuing after the given minimum and previous key */
+	static inline void candidates(const key_type* const keys, const size_t begin, const size_t n, weight_type minimum, Label previous, uint64_t* const mask) {
+		for (size_t i = begin; i < n; ++i) {
+			const key_type& l = keys[i];
+			const bool candidate = l.second_weight < minimum || l == previous;
+			mask[i / 64] |= (uint64_t) candidate << (i % 64);
+			minimum = std::min(minimum, l.second_weight);
+			previous = l;
+		}
+	}
+
+	/** Scalar scan of the separately stored weights [begin, n) */
+	static inline void candidates(const weight_type* const first, const weight_type* const second, const size_t begin, const size_t n,
+			weight_type minimum, Label previous, uint64_t* const mask) {
+		for (size_t i = begin; i < n; ++i) {
+			const bool candidate = second[i] < minimum || (first[i] == previous.first_weight && second[i] == previous.second_weight);
+			mask[i / 64] |= (uint64_t) candidate << (i % 64);
+			minimum = std::min(minimum, second[i]);
+			previous = Label(first[i], second[i]);
+		}
+	}
+
+	static inline void candidates(const key_type* const keys, const size_t n, const Label& prefix_minima, uint64_t* const mask, std::false_type) {
+		candidates(keys, 0, n, prefix_minima.second_weight, prefix_minima, mask);
+	}
+
+	static inline void candidates(const weight_type* const first, const weight_type* const second, const size_t n, const Label& prefix_minima,
+			uint64_t* const mask, std::false_type) {
+		candidates(first, second, 0, n, prefix_minima.second_weight, prefix_minima, mask);
+	}
+
+#if defined(SIMD_PARETO_MINIMA) && defined(__AVX512F__)
+	/** Broadcasts of the state after the previous block */
+	struct BlockState {
+		__m512i minimum;
+		__m512i previous_first;
+		__m512i previous_second;
+
+		BlockState(const Label& prefix_minima)
+			: minimum(_mm512_set1_epi32(prefix_minima.second_weight)),
+			  previous_first(_mm512_set1_epi32(prefix_minima.first_weight)),
+			  previous_second(minimum)
+		{}
+	};
+
+	/** Candidates among a block of 16 keys, given as their first and second weights.
+	 *  Uses the zero-masking intrinsics, as the unmasked ones pass undefined vectors through (-Wmaybe-uninitialized) */
+	static inline __mmask16 block(const __m512i first, const __m512i second, BlockState& state) {
+		const __mmask16 all = 0xFFFF;
+		const __m512i max = _mm512_set1_epi32(-1);
+		const __m512i last_lane = _mm512_set1_epi32(15);
+
+		// inclusive prefix minimum within the block, shifted by one lane to exclude the key itself
+		__m512i prefix = _mm512_maskz_min_epu32(all, second, _mm512_maskz_alignr_epi32(all, second, max, 15));
+		prefix = _mm512_maskz_min_epu32(all, prefix, _mm512_maskz_alignr_epi32(all, prefix, max, 14));
+		prefix = _mm512_maskz_min_epu32(all, prefix, _mm512_maskz_alignr_epi32(all, prefix, max, 12));
+		prefix = _mm512_maskz_min_epu32(all, prefix, _mm512_maskz_alignr_epi32(all, prefix, max, 8));
+		const __m512i before = _mm512_maskz_min_epu32(all, _mm512_maskz_alignr_epi32(all, prefix, state.minimum, 15), state.minimum);
+
+		__mmask16 hits = _mm512_cmplt_epu32_mask(second, before);
+		hits |= _mm512_cmpeq_epi32_mask(first, _mm512_maskz_alignr_epi32(all, first, state.previous_first, 15))
+			& _mm512_cmpeq_epi32_mask(second, _mm512_maskz_alignr_epi32(all, second, state.previous_second, 15));
+
+		state.minimum = _mm512_maskz_min_epu32(all, state.minimum, _mm512_maskz_permutexvar_epi32(all, last_lane, prefix));
+		state.previous_first = _mm512_maskz_permutexvar_epi32(all, last_lane, first);
+		state.previous_second = _mm512_maskz_permutexvar_epi32(all, last_lane, second);
+		return hits;
+	}
+
+	static inline weight_type minimum(const BlockState& state) { return _mm512_cvtsi512_si32(state.minimum); }
+	static inline Label previous(const BlockState& state) {
+		return Label(_mm512_cvtsi512_si32(state.previous_first), _mm512_cvtsi512_si32(state.previous_second));
+	}
+
+	static inline void candidates(const key_type* const keys, const size_t n, const Label& prefix_minima, uint64_t* const mask, std::true_type) {
+		// Blocks of 16 keys are loaded as three vectors and split into their first and second weights
+		const int* const base = reinterpret_cast<const int*>(keys);
+		const __m512i first_lo = _mm512_setr_epi32(0,3,6,9,12,15,18,21,24,27,30, 0,0,0,0,0);
+		const __m512i first_hi = _mm512_setr_epi32(0,0,0,0,0,0,0,0,0,0,0, 1,4,7,10,13);
+		const __m512i second_lo = _mm512_setr_epi32(1,4,7,10,13,16,19,22,25,28,31, 0,0,0,0,0);
+		const __m512i second_hi = _mm512_setr_epi32(0,0,0,0,0,0,0,0,0,0,0, 2,5,8,11,14);
+		const __mmask16 hi_lanes = 0xF800;
+
+		BlockState state(prefix_minima);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			const __m512i v0 = _mm512_loadu_si512(base + 3*i);
+			const __m512i v1 = _mm512_loadu_si512(base + 3*i + 16);
+			const __m512i v2 = _mm512_loadu_si512(base + 3*i + 32);
+			const __m512i first = _mm512_mask_permutexvar_epi32(_mm512_permutex2var_epi32(v0, first_lo, v1), hi_lanes, first_hi, v2);
+			const __m512i second = _mm512_mask_permutexvar_epi32(_mm512_permutex2var_epi32(v0, second_lo, v1), hi_lanes, second_hi, v2);
+			mask[i / 64] |= (uint64_t) block(first, second, state) << (i % 64);
+		}
+		candidates(keys, i, n, minimum(state), previous(state), mask);
+	}
+
+	static inline void candidates(const weight_type* const first, const weight_type* const second, const size_t n, const Label& prefix_minima,
+			uint64_t* const mask, std::true_type) {
+		BlockState state(prefix_minima);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			mask[i / 64] |= (uint64_t) block(_mm512_loadu_si512(first + i), _mm512_loadu_si512(second + i), state) << (i % 64);
+		}
+		candidates(first, second, i, n, minimum(state), previous(state), mask);
+	}
+#elif defined(SIMD_PARETO_MINIMA) && defined(__AVX2__)
+	/** Broadcasts of the state after the previous block */
+	struct BlockState {
+		__m256i minimum;
+		__m256i previous_first;
+		__m256i previous_second;
+
+		BlockState(const Label& prefix_minima)
+			: minimum(_mm256_set1_epi32(prefix_minima.second_weight)),
+			  previous_first(_mm256_set1_epi32(prefix_minima.first_weight)),
+			  previous_second(minimum)
+		{}
+	};
+
+	/** Candidates among a block of 8 keys, given as their first and second weights */
+	static inline uint32_t block(const __m256i first, const __m256i second, BlockState& state) {
+		const __m256i max = _mm256_set1_epi32(-1);
+		const __m256i last_lane = _mm256_set1_epi32(7);
+		const __m256i shift1 = _mm256_setr_epi32(0,0,1,2,3,4,5,6);
+		const __m256i shift2 = _mm256_setr_epi32(0,0,0,1,2,3,4,5);
+		const __m256i shift4 = _mm256_setr_epi32(0,0,0,0,0,1,2,3);
+
+		__m256i prefix = _mm256_min_epu32(second, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(second, shift1), max, 0x01));
+		prefix = _mm256_min_epu32(prefix, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(prefix, shift2), max, 0x03));
+		prefix = _mm256_min_epu32(prefix, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(prefix, shift4), max, 0x0F));
+		const __m256i before = _mm256_min_epu32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(prefix, shift1), state.minimum, 0x01), state.minimum);
+
+		// second < before <=> max(second, before) != second
+		const __m256i not_less = _mm256_cmpeq_epi32(_mm256_max_epu32(second, before), second);
+		const __m256i same = _mm256_and_si256(
+			_mm256_cmpeq_epi32(first, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(first, shift1), state.previous_first, 0x01)),
+			_mm256_cmpeq_epi32(second, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(second, shift1), state.previous_second, 0x01)));
+		const __m256i hits = _mm256_or_si256(_mm256_andnot_si256(not_less, max), same);
+
+		state.minimum = _mm256_min_epu32(state.minimum, _mm256_permutevar8x32_epi32(prefix, last_lane));
+		state.previous_first = _mm256_permutevar8x32_epi32(first, last_lane);
+		state.previous_second = _mm256_permutevar8x32_epi32(second, last_lane);
+		return _mm256_movemask_ps(_mm256_castsi256_ps(hits));
+	}
+
+	static inline weight_type minimum(const BlockState& state) { return _mm256_cvtsi256_si32(state.minimum); }
+	static inline Label previous(const BlockState& state) {
+		return Label(_mm256_cvtsi256_si32(state.previous_first), _mm256_cvtsi256_si32(state.previous_second));
+	}
+
+	static inline void candidates(const key_type* const keys, const size_t n, const Label& prefix_minima, uint64_t* const mask, std::true_type) {
+		// Blocks of 8 keys are loaded as three vectors; each weight is permuted into place and blended
+		const int* const base = reinterpret_cast<const int*>(keys);
+		const __m256i first0 = _mm256_setr_epi32(0,3,6, 0,0,0, 0,0);
+		const __m256i first1 = _mm256_setr_epi32(0,0,0, 1,4,7, 0,0);
+		const __m256i first2 = _mm256_setr_epi32(0,0,0, 0,0,0, 2,5);
+		const __m256i second0 = _mm256_setr_epi32(1,4,7, 0,0, 0,0,0);
+		const __m256i second1 = _mm256_setr_epi32(0,0,0, 2,5, 0,0,0);
+		const __m256i second2 = _mm256_setr_epi32(0,0,0, 0,0, 0,3,6);
+
+		BlockState state(prefix_minima);
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			const __m256i v0 = _mm256_loadu_si256((const __m256i*) (base + 3*i));
+			const __m256i v1 = _mm256_loadu_si256((const __m256i*) (base + 3*i + 8));
+			const __m256i v2 = _mm256_loadu_si256((const __m256i*) (base + 3*i + 16));
+			const __m256i first = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(v0, first0),
+				_mm256_permutevar8x32_epi32(v1, first1), 0x38), _mm256_permutevar8x32_epi32(v2, first2), 0xC0);
+			const __m256i second = _mm256_blend_epi32(_mm256_blend_epi32(_mm256_permutevar8x32_epi32(v0, second0),
+				_mm256_permutevar8x32_epi32(v1, second1), 0x18), _mm256_permutevar8x32_epi32(v2, second2), 0xE0);
+			mask[i / 64] |= (uint64_t) block(first, second, state) << (i % 64);
+		}
+		candidates(keys, i, n, minimum(state), previous(state), mask);
+	}
+
+	static inline void candidates(const weight_type* const first, const weight_type* const second, const size_t n, const Label& prefix_minima,
+			uint64_t* const mask, std::true_type) {
+		BlockState state(prefix_minima);
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			const __m256i f = _mm256_loadu_si256((const __m256i*) (first + i));
+			const __m256i s = _mm256_loadu_si256((const __m256i*) (second + i));
+			mask[i / 64] |= (uint64_t) block(f, s, state) << (i % 64);
+		}
+		candidates(first, second, i, n, minimum(state), previous(state), mask);
+	}
+#else
+	static inline void candidates(const key_type* const keys, const size_t n, const Label& prefix_minima, uint64_t* const mask, std::true_type) {
+		candidates(keys, n, prefix_minima, mask, std::false_type());
+	}
+
+	static inline void candidates(const weight_type* const first, const weight_type* const second, const size_t n, const Label& prefix_minima,
+			uint64_t* const mask, std::true_type) {
+		candidates(first, second, n, prefix_minima, mask, std::false_type());
+	}
+#endif
+};
+
+/**
+ * Retire the pareto minima among the n <= max_keys sorted keys of a leaf via retire(index, key)
+ * and relax the minima that are not pruned. Returns the number of retired minima.
+ * If given, only the keys in the staircase of the leaf are checked: The bitmask of the keys that
+ * are pareto minima within the leaf itself, which is a superset of the minima for any prefix.
+ */
+template<size_t max_keys, typename leaf_slots, typename Retire, typename cand_sequence_type, typename graph_type, typename Pruning>
+inline size_t relaxLeafMinimaWith(const leaf_slots& slots, const size_t n, const uint64_t* const staircase, const Label& prefix_minima,
+		Retire retire, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) {
+	typedef typename leaf_slots::key_type key_type;
+	uint64_t scanned[(max_keys + 63) / 64];
+	const uint64_t* mask = staircase;
+	if (mask == NULL) {
+		ParetoMinimaScan<key_type>::candidates(slots, n, prefix_minima, scanned);
+		mask = scanned;
+	}
+
+	size_t count = 0;
+	Label min = prefix_minima;
+	for (size_t w = 0; w < (n + 63) / 64; ++w) {
+		for (uint64_t bits = mask[w]; bits != 0; bits &= bits - 1) {
+			const size_t idx = w * 64 + __builtin_ctzll(bits);
+			const key_type l = slots.get(idx);
+			if (l.second_weight < min.second_weight || (l.first_weight == min.first_weight && l.second_weight == min.second_weight)) {
+				retire(idx, l);
+				++count;
+				min = l;
+				if (prune(l.node, l)) {
+					continue; // retire the minimum without relaxing it
+				}
+				// Derive all candidate labels
+				FORALL_EDGES(graph, l.node, eid) {
+					const auto& edge = graph.getEdge(eid);
+					const Label candidate = extended(l, edge);
+					if (!prune(edge.target, candidate)) {
+						candidates.emplace_back(edge.target, candidate);
+					}
+				}
+			}
+		}
+	}
+	return count;
+}
+
+/**
+ * Emit the pareto minima among the n <= max_keys sorted keys of a leaf as DELETE updates and
+ * relax the minima that are not pruned. Used by the sequential and the parallel B-tree ParetoQueue.
+ */
+template<size_t max_keys, typename leaf_slots, typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning>
+inline size_t relaxLeafMinima(const leaf_slots& slots, const size_t n, const uint64_t* const staircase, const Label& prefix_minima,
+		upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) {
+	typedef typename leaf_slots::key_type key_type;
+	return relaxLeafMinimaWith<max_keys>(slots, n, staircase, prefix_minima,
+		[&updates](size_t, const key_type& l) { updates.emplace_back(Operation<key_type>::DELETE, l); },
+		candidates, graph, prune);
+}
+
+#endif
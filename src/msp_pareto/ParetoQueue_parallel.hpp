@@ -4,6 +4,7 @@
 #include <iostream>
 #include <vector>
 #include <deque>
+#include <memory>
 
 #include "../options.hpp"
 
@@ -17,52 +18,78 @@
 
 #include "../datastructures/ThreadLocalWriteBuffer.hpp"
 #include "../utility/memory.h"
+#include "../tbx/worker_team.h"
 
 
 #include <algorithm>
 #include "../Label.hpp"
 #include "../Graph.hpp"
+#include "LabelPruning.hpp"
+#include "ParetoMinimaScan.hpp"
+#include "ParetoBuckets.hpp"
 
 #include "tbb/enumerable_thread_specific.h"
 #include "tbb/cache_aligned_allocator.h"
 #include "tbb/scalable_allocator.h"
 #include "tbb/task.h"
 #include "tbb/concurrent_vector.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/atomic.h"
+#include "tbb/tick_count.h"
 
 
 
+#ifdef BTREE_SOA_LEAVES
+typedef btree_soa_traits<NodeLabel, Label> pareto_queue_traits;
+#else
+typedef btree_default_traits<NodeLabel, Label> pareto_queue_traits;
+#endif
+
 /**
  * Queue storing all temporary labels of all nodes.
  */
-template<typename TLSData>
-class ParallelBTreeParetoQueue : public btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator> {
-	friend class FindParetMinTask;
+template<typename TLSData, typename queue_traits=pareto_queue_traits>
+class BasicParallelBTreeParetoQueue : public btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator, queue_traits> {
 private:
-	typedef btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator> base_type;
+	typedef btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator, queue_traits> base_type;
 
 	typedef typename base_type::node node;
 	typedef typename base_type::inner_node inner_node;
 	typedef typename base_type::inner_node_data inner_node_data;
 	typedef typename base_type::leaf_node leaf_node;
 	typedef typename base_type::width_type width_type;
+	typedef typename base_type::min_key_type min_key_type;
 	
+	using base_type::leafslotmax;
 	using base_type::min_problem_size;
+	using base_type::child;
 
 	const Label min_label;
 	const Graph& graph;
 
 	TLSData& tls_data;
+	bool inplace_extraction;
 
 public:
 
 	using base_type::num_threads;
 
 
-	ParallelBTreeParetoQueue(const Graph& _graph, const base_type::thread_count _num_threads, TLSData& _tls_data)
+	BasicParallelBTreeParetoQueue(const Graph& _graph, const typename base_type::thread_count _num_threads, TLSData& _tls_data)
 		: base_type(_num_threads), min_label(MIN_WEIGHT, MAX_WEIGHT),
-			graph(_graph), tls_data(_tls_data)
+			graph(_graph), tls_data(_tls_data), inplace_extraction(false)
 	{}
 
+	/**
+	 * If enabled, findParetoMinima removes the minima from the leaves it visits and fixes the
+	 * weights and minima of the affected slots on its way back up. No DELETE updates are emitted.
+	 * Underfull nodes left behind are rebalanced by the next update of their parent.
+	 */
+	void setInPlaceExtraction(const bool enabled) {
+		inplace_extraction = enabled;
+	}
+
 	void init(const NodeLabel& data) {
 		Operation<NodeLabel> op = {Operation<NodeLabel>::INSERT, data};
 		auto ap = tbb::auto_partitioner();
@@ -70,8 +97,13 @@ public:
 	}
 
 	template<typename T, typename Partitioner>
-	void applyUpdates(const T* updates, const size_t update_count, Partitioner& partitioner) {
-		base_type::apply_updates(updates, update_count, INSERTS_AND_DELETES, partitioner);
+	void applyUpdates(const T* updates, const size_t update_count, const OperationBatchType batch_type, Partitioner& partitioner) {
+		base_type::apply_updates(updates, update_count, batch_type, partitioner);
+	}
+
+	template<typename T, typename Worker>
+	void applyUpdatesByTeam(const T* updates, const size_t update_count, const OperationBatchType batch_type, Worker& worker) {
+		base_type::apply_updates_by_team(updates, update_count, batch_type, worker);
 	}
 
 	void printStatistics() {
@@ -80,91 +112,287 @@ public:
 		std::cout << "#   leaf slots size [" << base_type::leafslotmin << ", " << base_type::leafslotmax << "]. Bytes: " << base_type::leafnodebytesize << std::endl;
 	}
 
-	void findParetoMinima() {
+	template<typename Pruning=NoLabelPruning>
+	void findParetoMinima(const Pruning& prune=Pruning()) {
+		findParetoMinima(min_label, prune);
+	}
+
+	/** Only labels undercutting the given prefix minimum are pareto minima (e.g., if smaller labels are stored elsewhere) */
+	template<typename Pruning>
+	void findParetoMinima(const Label& prefix_minima, const Pruning& prune) {
 		// Adaptive cut-off; Taken from the MCSTL implementation
         min_problem_size = std::max((base_type::size()/num_threads) / (log2(base_type::size()/num_threads + 1)+1), base_type::maxweight(1)*1.0);
 
-		if (base_type::size() <= min_problem_size) {
-			findParetoMinima(base_type::root, min_label);
+		if (base_type::size() <= min_problem_size || base_type::size() < SEQUENTIAL_FALLBACK_THRESHOLD) {
+			const size_t minima_count = findParetoMinima(base_type::root, prefix_minima, prune);
+			if (inplace_extraction) {
+				base_type::stats.itemcount -= minima_count;
+			}
 		} else {
 			assert(!base_type::root->isleafnode());
-			const inner_node* const inner = (inner_node*) base_type::root;
+			inner_node* const inner = (inner_node*) base_type::root;
 			const width_type slotuse = inner->slotuse;
 
 			tbb::task_list root_tasks;
-			const Label* min = &min_label;
+			Label min = prefix_minima;
 			for (width_type i = 0; i<slotuse; ++i) {
-				const Label& l = inner->slot[i].minimum;
-				if (l.second_weight < min->second_weight || (l.first_weight == min->first_weight && l.second_weight == min->second_weight)) {
-					root_tasks.push_back(*new(tbb::task::allocate_root()) FindParetMinTask(inner->slot[i], min, this, &base_type::subtree_affinity[i]));
-					min = &l;
+				const Label l = inner->slot[i].minimum;
+				if (l.second_weight < min.second_weight || (l.first_weight == min.first_weight && l.second_weight == min.second_weight)) {
+					root_tasks.push_back(*new(tbb::task::allocate_root()) FindParetMinTask<Pruning>(inner->slot[i], min, this, prune, &base_type::subtree_affinity[i]));
+					min = l;
 				}
 			}
 			tbb::task::spawn_root_and_wait(root_tasks);
+			if (inplace_extraction) {
+				fixRootAfterExtraction();
+			}
 		}
 	}
 
-	inline void findParetoMinima(const node* const in_node, const Label& prefix_minima) {
+	/** Sequential variant writing to the given sequences instead of the thread local write buffers */
+	template<typename upd_sequence_type, typename cand_sequence_type, typename Pruning>
+	void findParetoMinimaSequentially(upd_sequence_type& updates, cand_sequence_type& candidates, const Pruning& prune) {
+		findParetoMinimaSequentially(min_label, updates, candidates, prune);
+	}
+
+	template<typename upd_sequence_type, typename cand_sequence_type, typename Pruning>
+	void findParetoMinimaSequentially(const Label& prefix_minima, upd_sequence_type& updates, cand_sequence_type& candidates, const Pruning& prune) {
+		if (inplace_extraction) {
+			base_type::stats.itemcount -= extract_pareto_minima(base_type::root, prefix_minima, candidates, graph, prune);
+		} else {
+			find_pareto_minima(base_type::root, prefix_minima, updates, candidates, graph, prune);
+		}
+	}
+
+	/**
+	 * SPMD variant, to be called by all workers of a worker team: Worker 0 collects the subtrees
+	 * that may contain pareto minima, which are then processed by whichever worker is idle.
+	 */
+	template<typename Worker, typename Pruning>
+	void findParetoMinimaByTeam(Worker& worker, const Pruning& prune) {
+		findParetoMinimaByTeam(worker, min_label, prune);
+	}
+
+	template<typename Worker, typename Pruning>
+	void findParetoMinimaByTeam(Worker& worker, const Label& prefix_minima, const Pruning& prune) {
+		if (worker.id == 0) {
+			min_problem_size = std::max((base_type::size()/num_threads) / (log2(base_type::size()/num_threads + 1)+1), base_type::maxweight(1)*1.0);
+			minima_subtrees.clear();
+			minima_paths.clear();
+			next_minima_subtree = 0;
+
+			if (worker.size == 1 || base_type::size() <= min_problem_size) {
+				minima_subtrees.emplace_back(nullptr, prefix_minima); // the whole tree
+			} else {
+				collectMinimaSubtrees((inner_node*) base_type::root, prefix_minima);
+			}
+		}
+		worker.barrier();
+
+		for (size_t i = next_minima_subtree++; i < minima_subtrees.size(); i = next_minima_subtree++) {
+			inner_node_data* const slot = minima_subtrees[i].first;
+			if (slot == nullptr) {
+				const size_t minima_count = findParetoMinima(base_type::root, minima_subtrees[i].second, prune);
+				if (inplace_extraction) {
+					base_type::stats.itemcount -= minima_count;
+				}
+			} else if (findParetoMinima(child(*slot), minima_subtrees[i].second, prune) > 0 && inplace_extraction) {
+				base_type::fix_slot_after_removal(*slot);
+			}
+		}
+
+		if (inplace_extraction) {
+			worker.barrier();
+			if (worker.id == 0 && !minima_subtrees.empty() && minima_subtrees.front().first != nullptr) {
+				for (inner_node_data* const slot : minima_paths) {
+					base_type::fix_slot_after_removal(*slot);
+				}
+				fixRootAfterExtraction();
+			}
+		}
+	}
+
+	/** Returns the number of pareto minima found in the subtree. These are removed if in-place extraction is enabled */
+	template<typename Pruning>
+	inline size_t findParetoMinima(node* const in_node, const Label& prefix_minima, const Pruning& prune) {
 		auto& tl = tls_data.local();
-		find_pareto_minima(in_node, prefix_minima, tl.updates, tl.candidates, graph);
+		if (inplace_extraction) {
+			return extract_pareto_minima(in_node, prefix_minima, tl.candidates, graph, prune);
+		} else {
+			return find_pareto_minima(in_node, prefix_minima, tl.updates, tl.candidates, graph, prune);
+		}
+	}
+
+	/** A label of the smallest second weight, (MAX_WEIGHT, MAX_WEIGHT) if the queue is empty */
+	Label minimum() const {
+		Label min(MAX_WEIGHT, MAX_WEIGHT);
+		if (base_type::size() == 0) {
+			return min;
+		}
+		if (base_type::root->isleafnode()) {
+			const leaf_node* const leaf = (leaf_node*) base_type::root;
+			for (width_type i = 0; i < leaf->slotuse; ++i) {
+				const NodeLabel key = leaf->key(i);
+				if (key.second_weight < min.second_weight) {
+					min = key;
+				}
+			}
+		} else {
+			const inner_node* const inner = (inner_node*) base_type::root;
+			for (width_type i = 0; i < inner->slotuse; ++i) {
+				if (inner->slot[i].minimum.second_weight < min.second_weight) {
+					min = inner->slot[i].minimum;
+				}
+			}
+		}
+		return min;
+	}
+
+	/** Append all labels in increasing order */
+	void appendLabels(std::vector<NodeLabel>& out) const {
+		if (base_type::size() > 0) {
+			appendLabels(base_type::root, out);
+		}
 	}
 
 private:
 
-	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type>
-    inline void find_pareto_minima(const node* const node, const min_key_type& prefix_minima, upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph) const {
+	void appendLabels(const node* const in_node, std::vector<NodeLabel>& out) const {
+		if (in_node->isleafnode()) {
+			const leaf_node* const leaf = (leaf_node*) in_node;
+			for (width_type i = 0; i < leaf->slotuse; ++i) {
+				out.push_back(leaf->key(i));
+			}
+		} else {
+			const inner_node* const inner = (inner_node*) in_node;
+			for (width_type i = 0; i < inner->slotuse; ++i) {
+				appendLabels(child(inner->slot[i]), out);
+			}
+		}
+	}
+
+	/** Subtrees to be searched by the worker team (nullptr for the whole tree) and their prefix minima */
+	std::vector<std::pair<inner_node_data*, Label>> minima_subtrees;
+	/** Slots above the collected subtrees, children first */
+	std::vector<inner_node_data*> minima_paths;
+	tbb::atomic<size_t> next_minima_subtree;
+
+	/** Mirrors the recursive task decomposition of FindParetMinTask */
+	void collectMinimaSubtrees(inner_node* const inner, const Label& prefix_minima) {
+		assert(!inner->isleafnode());
+		Label min = prefix_minima;
+		for (width_type i = 0; i<inner->slotuse; ++i) {
+			const Label l = inner->slot[i].minimum;
+			if (l.second_weight < min.second_weight || (l.first_weight == min.first_weight && l.second_weight == min.second_weight)) {
+				if (inner->slot[i].weight <= min_problem_size) {
+					minima_subtrees.emplace_back(&inner->slot[i], min);
+				} else {
+					collectMinimaSubtrees((inner_node*) child(inner->slot[i]), min);
+					minima_paths.push_back(&inner->slot[i]);
+				}
+				min = l;
+			}
+		}
+	}
+
+	inline void fixRootAfterExtraction() {
+		const inner_node* const inner = (inner_node*) base_type::root;
+		base_type::stats.itemcount = 0;
+		for (width_type i = 0; i < inner->slotuse; ++i) {
+			base_type::stats.itemcount += inner->slot[i].weight;
+		}
+	}
+
+	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning>
+    inline size_t find_pareto_minima(const node* const node, const min_key_type& prefix_minima, upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) const {
         if (node->isleafnode()) {
             const leaf_node* const leaf = (leaf_node*) node;
-            const width_type slotuse = leaf->slotuse;
-
-            const min_key_type* min = &prefix_minima;
-            for (width_type i = 0; i<slotuse; ++i) {
-                const auto& l = leaf->slotkey[i]; 
-
-                if (l.second_weight < min->second_weight ||
-                        (l.first_weight == min->first_weight && l.second_weight == min->second_weight)) {
-
-                    // Generate Update that will delete the minima
-                    updates.emplace_back(Operation<key_type>::DELETE, l);
-                    // Derive all candidate labels 
-                    FORALL_EDGES(graph, l.node, eid) {
-                        const auto& edge = graph.getEdge(eid);
-                        candidates.emplace_back(edge.target, l.first_weight + edge.first_weight, 
-                                                             l.second_weight + edge.second_weight);
-                    }
-                   	min = &l;
-                }
-            }
+            return relaxLeafMinima<leafslotmax>(leaf->slotkey, leaf->slotuse, leaf->cached_staircase(), prefix_minima, updates, candidates, graph, prune);
         } else {
             const inner_node* const inner = (inner_node*) node;
             const width_type slotuse = inner->slotuse;
 
+            size_t minima_count = 0;
             const min_key_type* min = &prefix_minima;
             for (width_type i = 0; i<slotuse; ++i) {
                 const auto& l = inner->slot[i].minimum; 
 
                 if (l.second_weight < min->second_weight || (l.first_weight == min->first_weight && l.second_weight == min->second_weight)) {
-                    find_pareto_minima(inner->slot[i].childid, *min, updates, candidates, graph);
+                    minima_count += find_pareto_minima(child(inner->slot[i]), *min, updates, candidates, graph, prune);
                     min = &l;
                 }
             }
+            return minima_count;
         }
     }
 
+	/** As find_pareto_minima, but removes the minima from their leaves and fixes the slots above */
+	template<typename cand_sequence_type, typename graph_type, typename Pruning>
+    inline size_t extract_pareto_minima(node* const node, const min_key_type& prefix_minima, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) {
+        if (node->isleafnode()) {
+            leaf_node* const leaf = (leaf_node*) node;
+            const size_t minima_count = relaxLeafMinimaWith<leafslotmax>(leaf->slotkey, leaf->slotuse, leaf->cached_staircase(), prefix_minima,
+                [leaf](size_t slot, const NodeLabel&) { leaf->mark(slot); }, candidates, graph, prune);
+            if (minima_count > 0) {
+                leaf->remove_marked();
+            }
+            return minima_count;
+        } else {
+            inner_node* const inner = (inner_node*) node;
+            const width_type slotuse = inner->slotuse;
+
+            size_t minima_count = 0;
+            min_key_type min = prefix_minima;
+            for (width_type i = 0; i<slotuse; ++i) {
+                const min_key_type l = inner->slot[i].minimum; // copy, as fixing the slot overwrites it
+
+                if (l.second_weight < min.second_weight || (l.first_weight == min.first_weight && l.second_weight == min.second_weight)) {
+                    const size_t found = extract_pareto_minima(child(inner->slot[i]), min, candidates, graph, prune);
+                    if (found > 0) {
+                        base_type::fix_slot_after_removal(inner->slot[i]);
+                        minima_count += found;
+                    }
+                    min = l;
+                }
+            }
+            return minima_count;
+        }
+    }
+
+    /** Fixes the slot of its inner node once all FindParetMinTasks of the children are done */
+    class FixSlotTask : public tbb::task {
+        inner_node_data& slot;
+        BasicParallelBTreeParetoQueue* const tree;
+
+    public:
+        inline FixSlotTask(inner_node_data& _slot, BasicParallelBTreeParetoQueue* const _tree)
+            : slot(_slot), tree(_tree)
+        { }
+
+        tbb::task* execute() {
+            if (tree->inplace_extraction) {
+                tree->fix_slot_after_removal(slot);
+            }
+            return NULL;
+        }
+    };
+
+    template<typename Pruning>
     class FindParetMinTask : public tbb::task {
-       	const inner_node_data& slot;
-       	const Label* const prefix_minima;
-        ParallelBTreeParetoQueue* const tree;
+       	inner_node_data& slot;
+       	const Label prefix_minima; // by value, as sibling tasks may fix the slot it stems from
+        BasicParallelBTreeParetoQueue* const tree;
+        const Pruning& prune;
         tbb::task::affinity_id* affinity;
 
     public:
 		
-		inline FindParetMinTask(const inner_node_data& _slot, const Label* const _prefix_minima, ParallelBTreeParetoQueue* const _tree)
-			: slot(_slot), prefix_minima(_prefix_minima), tree(_tree), affinity(NULL)
+		inline FindParetMinTask(inner_node_data& _slot, const Label& _prefix_minima, BasicParallelBTreeParetoQueue* const _tree, const Pruning& _prune)
+			: slot(_slot), prefix_minima(_prefix_minima), tree(_tree), prune(_prune), affinity(NULL)
 		{ }
 
-		inline FindParetMinTask(const inner_node_data& _slot, const Label* const _prefix_minima, ParallelBTreeParetoQueue* const _tree, tbb::task::affinity_id* _affinity)
-			: slot(_slot), prefix_minima(_prefix_minima), tree(_tree), affinity(_affinity)
+		inline FindParetMinTask(inner_node_data& _slot, const Label& _prefix_minima, BasicParallelBTreeParetoQueue* const _tree, const Pruning& _prune, tbb::task::affinity_id* _affinity)
+			: slot(_slot), prefix_minima(_prefix_minima), tree(_tree), prune(_prune), affinity(_affinity)
 		{ 
 			set_affinity(*affinity);
 		}
@@ -177,24 +405,26 @@ private:
 
 		tbb::task* execute() {
 			if (slot.weight <= tree->min_problem_size) {
-				tree->findParetoMinima(slot.childid, *prefix_minima);
+				if (tree->findParetoMinima(tree->child(slot), prefix_minima, prune) > 0 && tree->inplace_extraction) {
+					tree->fix_slot_after_removal(slot);
+				}
 				return NULL;
 			} else {
-				assert(!slot.childid->isleafnode());
-				const inner_node* const inner = (inner_node*) slot.childid;
+				assert(!tree->child(slot)->isleafnode());
+				inner_node* const inner = (inner_node*) tree->child(slot);
 				const width_type slotuse = inner->slotuse;
 
 				tbb::task_list tasks;
 				width_type task_count = 0;
-				auto& c = *new(allocate_continuation()) tbb::empty_task(); // our parent will wait for this one
+				auto& c = *new(allocate_continuation()) FixSlotTask(slot, tree); // our parent will wait for this one
 
-				const Label* min = prefix_minima;
+				Label min = prefix_minima;
 				for (width_type i = 0; i<slotuse; ++i) {
-					const Label& l = inner->slot[i].minimum;
-					if (l.second_weight < min->second_weight || (l.first_weight == min->first_weight && l.second_weight == min->second_weight)) {
-						tasks.push_back(*new(c.allocate_child()) FindParetMinTask(inner->slot[i], min, tree));
+					const Label l = inner->slot[i].minimum;
+					if (l.second_weight < min.second_weight || (l.first_weight == min.first_weight && l.second_weight == min.second_weight)) {
+						tasks.push_back(*new(c.allocate_child()) FindParetMinTask(inner->slot[i], min, tree, prune));
 						++task_count;
-						min = &l;
+						min = l;
 					}
 				}
 				c.set_ref_count(task_count);
@@ -207,5 +437,428 @@ private:
 
 };
 
+/** Queue with the compile-time configured leaf layout, as used by the ParetoSearch */
+template<typename TLSData>
+using ParallelBTreeParetoQueue = BasicParallelBTreeParetoQueue<TLSData>;
+
+
+/**
+ * Bucket-parallel variant of the BucketParetoQueue (see ParetoBuckets.hpp): The minima of
+ * different buckets are extracted and relaxed in parallel, and the updates are split among
+ * the threads at the boundaries of their buckets. Only suited for small integer edge weights.
+ */
+template<typename TLSData>
+class ParallelBucketParetoQueue {
+private:
+	typedef ParetoBuckets::weight_type weight_type;
+	typedef tbb::enumerable_thread_specific<ParetoBuckets::Bucket, tbb::cache_aligned_allocator<ParetoBuckets::Bucket>, tbb::ets_key_per_instance> MergeBuffers;
+
+	/** Buckets with minima (and updates) handled in one go */
+	static const size_t minima_grainsize = 16;
+	static const size_t update_grainsize = 256;
+
+	const Graph& graph;
+	TLSData& tls_data;
+
+	ParetoBuckets buckets;
+	MergeBuffers merge_buffers;
+	std::vector<weight_type> minima_buckets;
+	tbb::atomic<size_t> next_minima_bucket;
+	tbb::atomic<size_t> label_count;
+
+public:
+	const unsigned short num_threads;
+
+	ParallelBucketParetoQueue(const Graph& _graph, const unsigned short _num_threads, TLSData& _tls_data)
+		: graph(_graph), tls_data(_tls_data), num_threads(_num_threads)
+	{
+		label_count = 0;
+	}
+
+	/** The minima are always removed in place */
+	void setInPlaceExtraction(const bool) {}
+
+	void init(const NodeLabel& data) {
+		Operation<NodeLabel> op = {Operation<NodeLabel>::INSERT, data};
+		auto ap = tbb::auto_partitioner();
+		applyUpdates(&op, 1, INSERTS_ONLY, ap);
+	}
+
+	template<typename Partitioner>
+	void applyUpdates(const Operation<NodeLabel>* updates, const size_t update_count, const OperationBatchType, Partitioner& partitioner) {
+		if (update_count == 0) {
+			return;
+		}
+		buckets.cover(updates[0].data.first_weight, updates[update_count-1].data.first_weight, label_count == 0);
+		if (update_count < SEQUENTIAL_FALLBACK_THRESHOLD) {
+			applyBucketUpdates(updates, 0, update_count, update_count);
+		} else {
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, update_count, update_grainsize),
+				[this, updates, update_count](const tbb::blocked_range<size_t>& r) {
+					applyBucketUpdates(updates, r.begin(), r.end(), update_count);
+				}, partitioner);
+		}
+	}
+
+	/** SPMD variant, to be called by all workers of a worker team */
+	template<typename Worker>
+	void applyUpdatesByTeam(const Operation<NodeLabel>* updates, const size_t update_count, const OperationBatchType, Worker& worker) {
+		if (update_count == 0) {
+			return;
+		}
+		if (worker.id == 0) {
+			buckets.cover(updates[0].data.first_weight, updates[update_count-1].data.first_weight, label_count == 0);
+		}
+		worker.barrier();
+		applyBucketUpdates(updates, worker.id * update_count / worker.size, (worker.id+1) * update_count / worker.size, update_count);
+		worker.barrier(); // label count is complete
+	}
+
+	template<typename Pruning=NoLabelPruning>
+	void findParetoMinima(const Pruning& prune=Pruning()) {
+		minima_buckets.clear();
+		buckets.collectMinimaBuckets(minima_buckets);
+
+		if (label_count < SEQUENTIAL_FALLBACK_THRESHOLD) {
+			extractMinima(0, minima_buckets.size(), prune);
+		} else {
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, minima_buckets.size(), minima_grainsize),
+				[this, &prune](const tbb::blocked_range<size_t>& r) {
+					extractMinima(r.begin(), r.end(), prune);
+				});
+		}
+	}
+
+	/** Sequential variant writing to the given sequence instead of the thread local write buffers */
+	template<typename upd_sequence_type, typename cand_sequence_type, typename Pruning>
+	void findParetoMinimaSequentially(upd_sequence_type&, cand_sequence_type& candidates, const Pruning& prune) {
+		minima_buckets.clear();
+		buckets.collectMinimaBuckets(minima_buckets);
+		for (const auto bucket : minima_buckets) {
+			label_count -= buckets.extractMinima(bucket, candidates, graph, prune);
+		}
+	}
+
+	/** SPMD variant, to be called by all workers of a worker team: Worker 0 collects the buckets with minima */
+	template<typename Worker, typename Pruning>
+	void findParetoMinimaByTeam(Worker& worker, const Pruning& prune) {
+		if (worker.id == 0) {
+			minima_buckets.clear();
+			buckets.collectMinimaBuckets(minima_buckets);
+			next_minima_bucket = 0;
+		}
+		worker.barrier();
+
+		const size_t bucket_count = minima_buckets.size();
+		for (size_t i = next_minima_bucket.fetch_and_add(minima_grainsize); i < bucket_count; i = next_minima_bucket.fetch_and_add(minima_grainsize)) {
+			extractMinima(i, std::min(i + minima_grainsize, bucket_count), prune);
+		}
+	}
+
+	void printStatistics() {
+		std::cout << "# ParallelBucketParetoQueue: " << buckets.capacity() << " buckets" << std::endl;
+	}
+
+	void clear() {
+		buckets.clear();
+		label_count = 0;
+	}
+
+	bool empty() const {
+		return label_count == 0;
+	}
+
+	size_t size() const {
+		return label_count;
+	}
+
+private:
+
+	/** Apply all runs of updates of a single bucket that start within [begin, end) */
+	void applyBucketUpdates(const Operation<NodeLabel>* updates, size_t begin, const size_t end, const size_t update_count) {
+		while (begin != 0 && begin < end && updates[begin].data.first_weight == updates[begin-1].data.first_weight) {
+			++begin; // the run belongs to the preceding range
+		}
+		ParetoBuckets::Bucket& merge_buffer = merge_buffers.local();
+		long delta = 0;
+		while (begin < end) {
+			size_t run_end = begin + 1;
+			while (run_end < update_count && updates[run_end].data.first_weight == updates[begin].data.first_weight) {
+				++run_end;
+			}
+			delta += buckets.applyBucketUpdates(updates + begin, updates + run_end, merge_buffer);
+			begin = run_end;
+		}
+		label_count += delta;
+	}
+
+	template<typename Pruning>
+	void extractMinima(const size_t begin, const size_t end, const Pruning& prune) {
+		auto& tl = tls_data.local();
+		size_t minima_count = 0;
+		for (size_t i = begin; i < end; ++i) {
+			minima_count += buckets.extractMinima(minima_buckets[i], tl.candidates, graph, prune);
+		}
+		label_count -= minima_count;
+	}
+};
+
+
+/**
+ * Pareto queue split by first weight into one ParallelBTreeParetoQueue per thread. Updates are
+ * routed to the parts by binary search over the splitters, so that changes of the tree height
+ * are handled within the parts instead of by a rewrite of a single shared root. The pareto minima
+ * of a part are those of its local staircase that undercut the prefix minimum of all preceding
+ * parts. Once the parts grow unbalanced, their labels are redistributed among new splitters.
+ * This serial O(n) rewrite is amortized over the updates applied since the previous one.
+ */
+template<typename TLSData>
+class ParallelPartitionedParetoQueue {
+private:
+	typedef ParallelBTreeParetoQueue<TLSData> Part;
+	typedef Label::weight_type weight_type;
+
+	const Label min_label;
+
+	std::vector<std::unique_ptr<Part>> parts;
+	/** Part i holds the labels with first weights in [splitters[i-1], splitters[i]) */
+	std::vector<weight_type> splitters;
+
+	/** Position of the updates of part i within the current batch, followed by the batch end */
+	std::vector<size_t> part_updates;
+	const Operation<NodeLabel>* part_batch;
+	OperationBatchType part_batch_type;
+
+	/** Parts holding pareto minima and the prefix minima of their preceding parts */
+	std::vector<std::pair<size_t, Label>> minima_parts;
+	tbb::atomic<size_t> next_part;
+
+	std::vector<NodeLabel> rebalance_labels;
+	std::vector<Operation<NodeLabel>> rebalance_buffer;
+	size_t updates_since_rebalance;
+	size_t rebalance_count;
+	double rebalance_time;
+
+public:
+	const unsigned short num_threads;
+
+	ParallelPartitionedParetoQueue(const Graph& _graph, const unsigned short _num_threads, TLSData& _tls_data)
+		: min_label(MIN_WEIGHT, MAX_WEIGHT), splitters(_num_threads-1, MAX_WEIGHT), part_updates(_num_threads+1),
+			updates_since_rebalance(0), rebalance_count(0), rebalance_time(0), num_threads(_num_threads)
+	{
+		for (unsigned short i = 0; i < num_threads; ++i) {
+			parts.emplace_back(new Part(_graph, num_threads, _tls_data));
+		}
+	}
+
+	void setInPlaceExtraction(const bool enabled) {
+		for (auto& part : parts) {
+			part->setInPlaceExtraction(enabled);
+		}
+	}
+
+	void init(const NodeLabel& data) {
+		Operation<NodeLabel> op = {Operation<NodeLabel>::INSERT, data};
+		auto ap = tbb::auto_partitioner();
+		applyUpdates(&op, 1, INSERTS_ONLY, ap);
+	}
+
+	template<typename Partitioner>
+	void applyUpdates(const Operation<NodeLabel>* updates, const size_t update_count, const OperationBatchType batch_type, Partitioner&) {
+		routeUpdates(updates, update_count, batch_type);
+		if (part_updates.back() < SEQUENTIAL_FALLBACK_THRESHOLD) {
+			for (size_t i = 0; i < parts.size(); ++i) {
+				applyPartUpdates(i);
+			}
+		} else {
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, parts.size(), 1),
+				[this](const tbb::blocked_range<size_t>& r) {
+					for (size_t i = r.begin(); i != r.end(); ++i) {
+						applyPartUpdates(i);
+					}
+				});
+		}
+	}
+
+	/** SPMD variant, to be called by all workers of a worker team: Each part is updated by a single worker */
+	template<typename Worker>
+	void applyUpdatesByTeam(const Operation<NodeLabel>* updates, const size_t update_count, const OperationBatchType batch_type, Worker& worker) {
+		if (worker.id == 0) {
+			routeUpdates(updates, update_count, batch_type);
+			next_part = 0;
+		}
+		worker.barrier();
+
+		worker_team::worker solo = worker_team::solo();
+		for (size_t i = next_part++; i < parts.size(); i = next_part++) {
+			if (part_updates[i] != part_updates[i+1]) {
+				parts[i]->applyUpdatesByTeam(part_batch + part_updates[i], part_updates[i+1] - part_updates[i], part_batch_type, solo);
+			}
+		}
+		worker.barrier(); // all parts are complete
+	}
+
+	template<typename Pruning=NoLabelPruning>
+	void findParetoMinima(const Pruning& prune=Pruning()) {
+		collectMinimaParts();
+		if (minima_parts.size() == 1 || size() < SEQUENTIAL_FALLBACK_THRESHOLD) {
+			for (const auto& minima_part : minima_parts) {
+				parts[minima_part.first]->findParetoMinima(minima_part.second, prune);
+			}
+		} else {
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, minima_parts.size(), 1),
+				[this, &prune](const tbb::blocked_range<size_t>& r) {
+					for (size_t i = r.begin(); i != r.end(); ++i) {
+						parts[minima_parts[i].first]->findParetoMinima(minima_parts[i].second, prune);
+					}
+				});
+		}
+	}
+
+	/** Sequential variant writing to the given sequences instead of the thread local write buffers */
+	template<typename upd_sequence_type, typename cand_sequence_type, typename Pruning>
+	void findParetoMinimaSequentially(upd_sequence_type& updates, cand_sequence_type& candidates, const Pruning& prune) {
+		collectMinimaParts();
+		for (const auto& minima_part : minima_parts) {
+			parts[minima_part.first]->findParetoMinimaSequentially(minima_part.second, updates, candidates, prune);
+		}
+	}
+
+	/** SPMD variant, to be called by all workers of a worker team: Each part is searched by a single worker */
+	template<typename Worker, typename Pruning>
+	void findParetoMinimaByTeam(Worker& worker, const Pruning& prune) {
+		if (worker.id == 0) {
+			collectMinimaParts();
+			next_part = 0;
+		}
+		worker.barrier();
+
+		worker_team::worker solo = worker_team::solo();
+		for (size_t i = next_part++; i < minima_parts.size(); i = next_part++) {
+			parts[minima_parts[i].first]->findParetoMinimaByTeam(solo, minima_parts[i].second, prune);
+		}
+	}
+
+	void printStatistics() {
+		std::cout << "# ParallelPartitionedParetoQueue: " << parts.size() << " parts, " << rebalance_count << " rebalancings taking "
+			<< rebalance_time << " [s]" << std::endl;
+		parts.front()->printStatistics();
+	}
+
+	void clear() {
+		for (auto& part : parts) {
+			part->clear();
+		}
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	size_t size() const {
+		size_t total = 0;
+		for (const auto& part : parts) {
+			total += part->size();
+		}
+		return total;
+	}
+
+private:
+
+	/**
+	 * The largest part exceeds twice the average. Small queues are never partitioned. Requires at least
+	 * as many updates since the last rebalancing as there are labels, so that rebalancing takes O(1)
+	 * amortized time per update even if the imbalance persists.
+	 */
+	bool unbalanced() const {
+		const size_t total = size();
+		if (parts.size() == 1 || total < parts.size() * SEQUENTIAL_FALLBACK_THRESHOLD || updates_since_rebalance < total) {
+			return false;
+		}
+		for (const auto& part : parts) {
+			if (part->size() > 2 * total / parts.size()) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Split the batch among the parts. If the parts are unbalanced, the batch is merged into their redistributed labels instead */
+	void routeUpdates(const Operation<NodeLabel>* updates, const size_t update_count, const OperationBatchType batch_type) {
+		part_batch = updates;
+		part_batch_type = batch_type;
+		size_t batch_size = update_count;
+		updates_since_rebalance += update_count;
+		if (unbalanced()) {
+			const tbb::tick_count start = tbb::tick_count::now();
+			mergeIntoRebalanceBuffer(updates, update_count);
+			batch_size = rebalance_buffer.size();
+			for (size_t i = 1; i < parts.size() && batch_size > 0; ++i) {
+				splitters[i-1] = rebalance_buffer[i * batch_size / parts.size()].data.first_weight;
+			}
+			part_batch = rebalance_buffer.data();
+			part_batch_type = INSERTS_ONLY;
+			updates_since_rebalance = 0;
+			++rebalance_count;
+			rebalance_time += (tbb::tick_count::now() - start).seconds();
+		}
+		const Operation<NodeLabel>* const end = part_batch + batch_size;
+		const Operation<NodeLabel>* begin = part_batch;
+		part_updates[0] = 0;
+		for (size_t i = 1; i < parts.size(); ++i) {
+			begin = std::lower_bound(begin, end, splitters[i-1],
+				[](const Operation<NodeLabel>& op, const weight_type splitter) { return op.data.first_weight < splitter; });
+			part_updates[i] = begin - part_batch;
+		}
+		part_updates[parts.size()] = end - part_batch;
+	}
+
+	/** Empty all parts and merge their labels with the (sorted) updates */
+	void mergeIntoRebalanceBuffer(const Operation<NodeLabel>* updates, const size_t update_count) {
+		rebalance_labels.clear();
+		for (auto& part : parts) {
+			part->appendLabels(rebalance_labels);
+			part->clear();
+		}
+		rebalance_buffer.clear();
+		GroupNodeLablesByWeightAndNodeComperator less;
+		auto label = rebalance_labels.cbegin();
+		for (const Operation<NodeLabel>* op = updates; op != updates + update_count; ++op) {
+			while (label != rebalance_labels.cend() && less(*label, op->data)) {
+				rebalance_buffer.emplace_back(Operation<NodeLabel>::INSERT, *label++);
+			}
+			if (op->type == Operation<NodeLabel>::DELETE) {
+				assert(label != rebalance_labels.cend() && label->node == op->data.node && !less(op->data, *label));
+				++label; // delete the element by jumping over it
+			} else {
+				rebalance_buffer.emplace_back(Operation<NodeLabel>::INSERT, op->data);
+			}
+		}
+		for (; label != rebalance_labels.cend(); ++label) {
+			rebalance_buffer.emplace_back(Operation<NodeLabel>::INSERT, *label);
+		}
+	}
+
+	inline void applyPartUpdates(const size_t i) {
+		if (part_updates[i] != part_updates[i+1]) {
+			auto ap = tbb::auto_partitioner();
+			parts[i]->applyUpdates(part_batch + part_updates[i], part_updates[i+1] - part_updates[i], part_batch_type, ap);
+		}
+	}
+
+	/** Exclusive prefix minimum over the second weights of the parts */
+	void collectMinimaParts() {
+		minima_parts.clear();
+		Label prefix_minima = min_label;
+		for (size_t i = 0; i < parts.size(); ++i) {
+			const Label part_minimum = parts[i]->minimum();
+			if (part_minimum.second_weight < prefix_minima.second_weight) {
+				minima_parts.emplace_back(i, prefix_minima);
+				prefix_minima = part_minimum;
+			}
+		}
+	}
+};
+
 
 #endif
@@ -10,6 +10,10 @@
 #include "../datastructures/btree/BTree_sequential.hpp"
 #undef COMPUTE_PARETO_MIN
 #include "../Label.hpp"
+#include "LabelPruning.hpp"
+#include "ParetoMinimaScan.hpp"
+#include "ParetoBuckets.hpp"
+#include "PrioritySearchTree.hpp"
 
 #include <algorithm>
 
@@ -52,10 +56,15 @@ public:
 		labels.insert(++labels.begin(), data);
 	}
 
-    template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type>
-	void findParetoMinima(upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph) const {
+	/** Not supported, the minima are always emitted as DELETE updates */
+	void setPositionalDeletion(const bool) {}
+
+	/** Returns the number of pareto minima */
+    template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning=NoLabelPruning>
+	size_t findParetoMinima(upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune=Pruning()) const {
 		const_iterator iter = ++labels.begin(); // ignore the sentinal
 		const_iterator end = --labels.end();  // ignore the sentinal
+		const size_t updates_before = updates.size();
 
 		const_iterator min = iter;
 		while (iter != end) {
@@ -63,14 +72,21 @@ public:
 					(iter->first_weight == min->first_weight && iter->second_weight == min->second_weight)) {
 				min = iter;
 				updates.emplace_back(Operation<NodeLabel>::DELETE, *iter);
+				if (prune(iter->node, *iter)) {
+					++iter;
+					continue; // retire the minimum without relaxing it
+				}
 				FORALL_EDGES(graph, iter->node, eid) {
                 	const auto& edge = graph.getEdge(eid);
-                    candidates.emplace_back(edge.target, iter->first_weight + edge.first_weight, 
-                    	                                 iter->second_weight + edge.second_weight);
+                	const Label candidate = extended(*iter, edge);
+                	if (!prune(edge.target, candidate)) {
+                    	candidates.emplace_back(edge.target, candidate);
+                    }
                 }
 			}
 			++iter;
 		}
+		return updates.size() - updates_before;
 	}
 
 	void applyUpdates(const std::vector<Operation<NodeLabel> >& updates) {
@@ -131,6 +147,11 @@ public:
 		#endif
 	}
 
+	/** Remove all labels but keep the sentinals */
+	void clear() {
+		labels.erase(++labels.begin(), --labels.end());
+	}
+
 	bool empty() {
 		return size() == 0;
 	}
@@ -141,23 +162,174 @@ public:
 };
 
 /**
- * Queue storing all temporary labels of all nodes.
+ * Queue storing all temporary labels of all nodes in buckets of equal first weight (see
+ * ParetoBuckets.hpp). Only suited for graphs with small integer edge weights.
+ */
+class BucketParetoQueue {
+private:
+	ParetoBuckets buckets;
+	std::vector<ParetoBuckets::weight_type> minima_buckets;
+	ParetoBuckets::Bucket merge_buffer;
+	size_t label_count;
+
+public:
+
+	BucketParetoQueue()
+		: label_count(0)
+	{}
+
+	void init(const NodeLabel& data) {
+		std::vector<Operation<NodeLabel>> upds;
+		upds.emplace_back(Operation<NodeLabel>::INSERT, data);
+		applyUpdates(upds);
+	}
+
+	/** The minima are always removed by position, no DELETE updates are emitted */
+	void setPositionalDeletion(const bool) {}
+
+	/** Returns the number of pareto minima */
+	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning=NoLabelPruning>
+	size_t findParetoMinima(upd_sequence_type&, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune=Pruning()) {
+		minima_buckets.clear();
+		buckets.collectMinimaBuckets(minima_buckets);
+
+		size_t minima_count = 0;
+		for (const ParetoBuckets::weight_type first_weight : minima_buckets) {
+			minima_count += buckets.extractMinima(first_weight, candidates, graph, prune);
+		}
+		label_count -= minima_count;
+		return minima_count;
+	}
+
+	void applyUpdates(const std::vector<Operation<NodeLabel>>& updates) {
+		if (updates.empty()) {
+			return;
+		}
+		buckets.cover(updates.front().data.first_weight, updates.back().data.first_weight, label_count == 0);
+
+		const Operation<NodeLabel>* const end = updates.data() + updates.size();
+		const Operation<NodeLabel>* run = updates.data();
+		while (run != end) {
+			const Operation<NodeLabel>* run_end = run + 1;
+			while (run_end != end && run_end->data.first_weight == run->data.first_weight) {
+				++run_end;
+			}
+			label_count += buckets.applyBucketUpdates(run, run_end, merge_buffer);
+			run = run_end;
+		}
+	}
+
+	void printStatistics() {
+		std::cout << "# BucketParetoQueue: " << buckets.capacity() << " buckets" << std::endl;
+	}
+
+	void clear() {
+		buckets.clear();
+		label_count = 0;
+	}
+
+	bool empty() {
+		return size() == 0;
+	}
+
+	size_t size() {
+		return label_count;
+	}
+};
+
+/**
+ * Queue storing all temporary labels of all nodes in a priority search tree (see PrioritySearchTree.hpp).
+ * Finding the pareto minima only visits subtrees that contain some.
  */
-class BTreeParetoQueue : public btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator> {
+class PSTParetoQueue {
 private:
+	PrioritySearchTree tree;
+
+public:
+
+	void init(const NodeLabel& data) {
+		const Operation<NodeLabel> op = {Operation<NodeLabel>::INSERT, data};
+		tree.applyUpdates(&op, &op + 1);
+	}
+
+	/** The minima are always removed by position, no DELETE updates are emitted */
+	void setPositionalDeletion(const bool) {}
+
+	/** Returns the number of pareto minima */
+	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning=NoLabelPruning>
+	size_t findParetoMinima(upd_sequence_type&, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune=Pruning()) {
+		return tree.extractMinima(candidates, graph, prune);
+	}
+
+	void applyUpdates(const std::vector<Operation<NodeLabel>>& updates) {
+		tree.applyUpdates(updates.data(), updates.data() + updates.size());
+	}
+
+	void printStatistics() {
+		std::cout << "# PSTParetoQueue: " << tree.capacity() << " nodes" << std::endl;
+	}
+
+	void clear() {
+		tree.clear();
+	}
+
+	bool empty() {
+		return size() == 0;
+	}
+
+	size_t size() {
+		return tree.size();
+	}
+};
+
+#ifdef BTREE_SOA_LEAVES
+typedef btree_soa_traits<NodeLabel, Label> pareto_queue_traits;
+#else
+typedef btree_default_traits<NodeLabel, Label> pareto_queue_traits;
+#endif
+
+/**
+ * Queue storing all temporary labels of all nodes. The traits select the leaf layout.
+ */
+template<typename queue_traits=pareto_queue_traits>
+class BasicBTreeParetoQueue : public btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator, queue_traits> {
+private:
+
+	typedef btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator, queue_traits> base_type;
+	typedef typename base_type::size_type size_type;
+	typedef typename base_type::min_key_type min_key_type;
+	typedef typename base_type::node node;
+	typedef typename base_type::inner_node inner_node;
+	typedef typename base_type::leaf_node leaf_node;
+	typedef typename base_type::width_type width_type;
+	using base_type::leafslotmax;
 
-	typedef btree<NodeLabel, Label, GroupNodeLablesByWeightAndNodeComperator> base_type;
 	const Label min_label;
 
+	bool positional_deletion;
+	/// Number of keys marked by findParetoMinima but not yet dropped by applyUpdates
+	size_type marked_count;
+
 	using base_type::apply_updates;
+	using base_type::child;
 
 
 public:
 
-	BTreeParetoQueue()
-		: min_label(MIN_WEIGHT, MAX_WEIGHT)
+	BasicBTreeParetoQueue()
+		: min_label(MIN_WEIGHT, MAX_WEIGHT), positional_deletion(false), marked_count(0)
 	{}
 
+	/**
+	 * If enabled, findParetoMinima marks the minima within their leaves instead of emitting DELETE
+	 * updates. The next applyUpdates then drops them while copying the leaves, so that the update
+	 * batch only holds the insertions of the label sets.
+	 */
+	void setPositionalDeletion(const bool enabled) {
+		assert(marked_count == 0);
+		positional_deletion = enabled;
+	}
+
 	void init(const NodeLabel& data) {
 		std::vector<Operation<NodeLabel>> upds;
 		upds.emplace_back(Operation<NodeLabel>::INSERT, data);
@@ -165,62 +337,58 @@ public:
 	}
 
 	void applyUpdates(const std::vector<Operation<NodeLabel>>& updates) {
+		base_type::stats.itemcount -= marked_count;
+		marked_count = 0;
 		apply_updates(updates, INSERTS_AND_DELETES);
 	}
 
-    template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type>
-	void findParetoMinima(upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph) const {
-		find_pareto_minima(min_label, updates, candidates, graph);
+	/** Returns the number of pareto minima. These are only emitted as DELETE updates if positional deletion is disabled */
+    template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning=NoLabelPruning>
+	size_t findParetoMinima(upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune=Pruning()) {
+		const size_t minima_count = find_pareto_minima(base_type::root, min_label, updates, candidates, graph, prune);
+		if (positional_deletion) {
+			marked_count += minima_count;
+		}
+		return minima_count;
 	}
 
 private:
 
-	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type>
-    inline void find_pareto_minima(const min_key_type& prefix_minima, upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph) const {    
-        find_pareto_minima(root, prefix_minima, updates, candidates, graph);
-    }
-
-	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type>
-    inline void find_pareto_minima(const node* const node, const min_key_type& prefix_minima, upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph) const {
+	template<typename upd_sequence_type, typename cand_sequence_type, typename graph_type, typename Pruning>
+    inline size_t find_pareto_minima(node* const node, const min_key_type& prefix_minima, upd_sequence_type& updates, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) {
         if (node->isleafnode()) {
-            const leaf_node* const leaf = (leaf_node*) node;
-            const width_type slotuse = leaf->slotuse;
-
-            const min_key_type* min = &prefix_minima;
-            for (width_type i = 0; i<slotuse; ++i) {
-                const auto& l = leaf->slotkey[i]; 
-
-                if (l.second_weight < min->second_weight ||
-                        (l.first_weight == min->first_weight && l.second_weight == min->second_weight)) {
-
-                    // Generate Update that will delete the minima
-                    updates.emplace_back(Operation<key_type>::DELETE, l);
-                    // Derive all candidate labels 
-                    FORALL_EDGES(graph, l.node, eid) {
-                        const auto& edge = graph.getEdge(eid);
-                        candidates.emplace_back(edge.target, l.first_weight + edge.first_weight, 
-                                                             l.second_weight + edge.second_weight);
-                    }
-                   	min = &l;
-                }
+            leaf_node* const leaf = (leaf_node*) node;
+            if (positional_deletion) {
+                return relaxLeafMinimaWith<leafslotmax>(leaf->slotkey, leaf->slotuse, leaf->cached_staircase(), prefix_minima,
+                    [leaf](size_t slot, const NodeLabel&) { leaf->mark(slot); }, candidates, graph, prune);
+            } else {
+                return relaxLeafMinima<leafslotmax>(leaf->slotkey, leaf->slotuse, leaf->cached_staircase(), prefix_minima, updates, candidates, graph, prune);
             }
         } else {
-            const inner_node* const inner = (inner_node*) node;
+            inner_node* const inner = (inner_node*) node;
             const width_type slotuse = inner->slotuse;
 
+            size_t minima_count = 0;
             const min_key_type* min = &prefix_minima;
             for (width_type i = 0; i<slotuse; ++i) {
                 const auto& l = inner->slot[i].minimum; 
 
                 if (l.second_weight < min->second_weight || (l.first_weight == min->first_weight && l.second_weight == min->second_weight)) {
-                    find_pareto_minima(inner->slot[i].childid, *min, updates, candidates, graph);
+                    const size_t found = find_pareto_minima(child(inner->slot[i]), *min, updates, candidates, graph, prune);
+                    if (positional_deletion) {
+                        inner->slot[i].marked += found;
+                    }
+                    minima_count += found;
                     min = &l;
                 }
             }
+            return minima_count;
         }
     }
 };
 
+typedef BasicBTreeParetoQueue<> BTreeParetoQueue;
+
 class ParetoQueue : public PARETO_QUEUE {
 public:
 	ParetoQueue():
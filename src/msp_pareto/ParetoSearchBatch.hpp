@@ -0,0 +1,138 @@
+/*
+ * Inter-query parallelism: Process a batch of independent queries by running several
+ * ParetoSearch instances concurrently, each within its own task arena. All instances
+ * share the same read-only graph. Optimized for throughput, not single-query latency.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef PARETO_SEARCH_BATCH_H_
+#define PARETO_SEARCH_BATCH_H_
+
+#ifndef TBB_PREVIEW_TASK_ARENA
+#define TBB_PREVIEW_TASK_ARENA 1
+#endif
+
+#include "ParetoSearch_parallel.hpp"
+
+#include "tbb/task_arena.h"
+#include "tbb/tbb_thread.h"
+#include "tbb/atomic.h"
+#include "tbb/tick_count.h"
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+
+template<typename labelset_slot=ParetoLabelSet>
+class ParetoSearchBatch {
+public:
+	typedef ParetoSearch<labelset_slot> Search;
+
+private:
+	/** Queries timed per candidate split (at least one per thread) */
+	static const size_t MIN_CALIBRATION_SAMPLE = 16;
+
+	const Graph& graph;
+	const unsigned short num_threads;
+	const unsigned short num_arenas;
+	unsigned short calibrated_arenas;
+
+public:
+	/**
+	 * Runs up to num_arenas searches concurrently and splits the num_threads among them.
+	 * Use num_arenas=0 to calibrate the split between inter-query and intra-query
+	 * parallelism on the queries of the first batch (see calibrate()).
+	 */
+	ParetoSearchBatch(const Graph& graph_, const unsigned short num_threads_, const unsigned short num_arenas_=0):
+		graph(graph_),
+		num_threads(num_threads_),
+		num_arenas(num_arenas_),
+		calibrated_arenas(0)
+	{}
+
+	/** Concurrent searches used for a batch of the given size */
+	unsigned short arenaCount(const size_t query_count) const {
+		const unsigned short arenas = num_arenas > 0 ? num_arenas : calibrated_arenas;
+		return std::max<size_t>(1, std::min<size_t>(std::min(arenas, num_threads), query_count));
+	}
+
+	/**
+	 * Pick the split for num_arenas=0: Time a sample of the queries, spread over the whole batch,
+	 * with num_threads, num_threads/2, ..., 1 concurrent searches and keep the split with the
+	 * highest throughput. Throughput is measured as the queries per time the searches spend
+	 * in queries, so that searches idling at the end of the sample do not count.
+	 * The sample queries are executed once per candidate split.
+	 */
+	template<typename Query>
+	void calibrate(const size_t query_count, const Query& query) {
+		const size_t sample_count = std::min<size_t>(query_count, std::max<size_t>(num_threads, MIN_CALIBRATION_SAMPLE));
+		if (sample_count == 0) {
+			return;
+		}
+		std::vector<size_t> sample(sample_count);
+		for (size_t i = 0; i < sample_count; ++i) {
+			sample[i] = i * query_count / sample_count;
+		}
+		const auto sample_query = [&sample, &query](Search& search, const size_t i) { query(search, sample[i]); };
+
+		double best_throughput = 0;
+		calibrated_arenas = 1;
+		for (unsigned short arenas = std::min<size_t>(num_threads, sample_count); arenas > 0; arenas /= 2) {
+			const double busy_time = runConcurrently(arenas, sample_count, sample_query);
+			const double throughput = sample_count * arenas / busy_time;
+			if (throughput > best_throughput) {
+				best_throughput = throughput;
+				calibrated_arenas = arenas;
+			}
+		}
+	}
+
+	/**
+	 * Execute query(search, i) for all i in [0, query_count). Queries are handed out
+	 * dynamically to the concurrent searches. Each search instance is reset in between.
+	 */
+	template<typename Query>
+	void run(const size_t query_count, const Query& query) {
+		if (num_arenas == 0 && calibrated_arenas == 0) {
+			calibrate(query_count, query);
+		}
+		runConcurrently(arenaCount(query_count), query_count, query);
+	}
+
+private:
+
+	/** Returns the total time the searches spent in queries */
+	template<typename Query>
+	double runConcurrently(const unsigned short arenas, const size_t query_count, const Query& query) {
+		tbb::atomic<size_t> next_query;
+		next_query = 0;
+		std::vector<double> busy_time(arenas, 0.0);
+
+		std::vector<std::unique_ptr<tbb::tbb_thread>> threads;
+		for (unsigned short a = 0; a < arenas; ++a) {
+			// Distribute the remaining threads evenly among the arenas
+			const unsigned short arena_threads = num_threads / arenas + (a < num_threads % arenas ? 1 : 0);
+			double& busy = busy_time[a];
+
+			threads.emplace_back(new tbb::tbb_thread([this, arena_threads, query_count, &query, &next_query, &busy]() {
+				tbb::task_arena arena(arena_threads);
+				arena.execute([this, arena_threads, query_count, &query, &next_query, &busy]() {
+					Search search(graph, arena_threads);
+					for (size_t i = next_query++; i < query_count; i = next_query++) {
+						const tbb::tick_count start = tbb::tick_count::now();
+						query(search, i);
+						search.reset();
+						busy += (tbb::tick_count::now() - start).seconds();
+					}
+				});
+			}));
+		}
+		for (auto& thread : threads) {
+			thread->join();
+		}
+		return std::accumulate(busy_time.begin(), busy_time.end(), 0.0);
+	}
+};
+
+#endif
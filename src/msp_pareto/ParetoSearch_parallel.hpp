@@ -20,8 +20,11 @@
 #include "ParetoQueue_parallel.hpp"
 #include "ParetoSearchStatistics.hpp"
 #include "ParetoLabelSet.hpp"
+#include "LabelPruning.hpp"
+#include "PathUnpacking.hpp"
 
 #include "../tbx/parallel_sort.hpp"
+#include "../tbx/worker_team.h"
 
 #include "tbb/parallel_sort.h"
 #include "tbb/concurrent_vector.h"
@@ -34,6 +37,7 @@
 
 #include "assert.h"
 #include "algorithm"
+#include <cmath>
 
 
 #ifdef GATHER_SUBCOMPNENT_TIMING
@@ -55,7 +59,20 @@
 #endif
 
 
-template<typename labelset_slot=ParetoLabelSet>
+/** Write buffer of the queue updates that notes whether any of them is a DELETE */
+struct QueueUpdateBuffer : public ThreadLocalWriteBuffer<Operation<NodeLabel>> {
+	bool has_deletes = false;
+
+	using ThreadLocalWriteBuffer<Operation<NodeLabel>>::ThreadLocalWriteBuffer;
+
+	template<typename ...Args>
+	inline void emplace_back(const Operation<NodeLabel>::OpType type, Args&& ...args) {
+		has_deletes |= type == Operation<NodeLabel>::DELETE;
+		ThreadLocalWriteBuffer<Operation<NodeLabel>>::emplace_back(type, std::forward<Args>(args)...);
+	}
+};
+
+template<typename labelset_slot=ParetoLabelSet, template<typename> class paretoqueue_slot=PARALLEL_PARETO_QUEUE>
 class ParetoSearch {
 private:
 
@@ -66,8 +83,9 @@ private:
 
 	struct ThreadData {
 		ThreadLocalWriteBuffer<NodeLabel> candidates;
-		ThreadLocalWriteBuffer<Operation<NodeLabel>> updates;
+		QueueUpdateBuffer updates;
 		typename LabelSet::ThreadLocalLSData labelset_data;
+		std::vector<NodeID> touched_nodes;
 
 		ThreadData(ParetoSearch* algo) 
 		:	candidates(algo->candidates, algo->candidate_counter,
@@ -79,7 +97,7 @@ private:
 	};	
 	typedef tbb::enumerable_thread_specific< ThreadData, tbb::cache_aligned_allocator<ThreadData>, tbb::ets_key_per_instance > TLSData; 
 
-	typedef ParallelBTreeParetoQueue<TLSData> ParetoQueue;
+	typedef paretoqueue_slot<TLSData> ParetoQueue;
 	typedef Operation<NodeLabel> Updates; 
 
 	CACHE_ALIGNED Updates*   const updates;
@@ -93,30 +111,176 @@ private:
 
 	ParetoSearchStatistics<Label> stats;
 	const Graph& graph;
+	ReverseGraph reverse_graph;
+	LowerBounds lower_bounds;
+	NodeID source;
+	double hop_epsilon;
 
 	GroupOperationsByWeightAndNodeComperator<Operation<NodeLabel>> groupByWeight;
 	GroupNodeLabelsByNodeComperator groupCandidates;
 	GroupLabelsByWeightComperator groupLabels;
 
+	// Worker team execution mode (created on first use)
+	const bool use_worker_team;
+	std::unique_ptr<worker_team> team;
+	Updates*   update_buffer;
+	NodeLabel* candidate_buffer;
+	team_sort<Updates, GroupOperationsByWeightAndNodeComperator<Operation<NodeLabel>>> sortUpdatesByTeam;
+	team_sort<NodeLabel, GroupNodeLabelsByNodeComperator> sortCandidatesByTeam;
+	size_t team_update_count;
+	OperationBatchType team_batch_type;
+	size_t team_candidate_count;
+	enum TeamIteration { TEAM_DONE, TEAM_SOLO, TEAM_SPMD };
+	TeamIteration team_iterations[2];
+
+	// Plain buffers of small iterations, which are run by a single thread (see iterationSolo)
+	std::vector<Updates> solo_updates;
+	std::vector<NodeLabel> solo_candidates;
+
 public:
-	ParetoSearch(const Graph& graph_, const unsigned short num_threads):
+	/**
+	 * With use_worker_team, the search loop is executed SPMD-style by a persistent team of
+	 * num_threads pinned threads that synchronize via spin barriers instead of spawning tasks.
+	 */
+	ParetoSearch(const Graph& graph_, const unsigned short num_threads, const bool use_worker_team_=false):
 		updates((Updates*) scalable_malloc(LARGE_ENOUGH_FOR_EVERYTHING * sizeof(Updates))),
 		candidates((NodeLabel*) scalable_malloc(LARGE_ENOUGH_FOR_EVERYTHING * sizeof(NodeLabel))),
 		labelsets(graph_.numberOfNodes()),
 		tls_data([this](){ return this; }),
 		pq(graph_, num_threads, tls_data),
-		graph(graph_)
+		graph(graph_),
+		reverse_graph(graph_),
+		lower_bounds(reverse_graph),
+		source(0),
+		hop_epsilon(0),
+		use_worker_team(use_worker_team_),
+		update_buffer(NULL),
+		candidate_buffer(NULL),
+		sortUpdatesByTeam(groupByWeight),
+		sortCandidatesByTeam(groupCandidates)
 		#ifdef GATHER_DATASTRUCTURE_MODIFICATION_LOG
 			,set_changes(101)
 		#endif
-	{ }
+	{
+		#ifdef INPLACE_MINIMA_EXTRACTION
+			pq.setInPlaceExtraction(true);
+		#endif
+	}
+
+	/** Plain new ignores the alignment of the cache aligned members before C++17 */
+	static void* operator new(size_t size) {
+		void* const p = scalable_aligned_malloc(size, alignof(ParetoSearch));
+		if (p == NULL) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	static void operator delete(void* p) {
+		scalable_aligned_free(p);
+	}
 
 	~ParetoSearch() {
 		scalable_free(updates);
 		scalable_free(candidates);
+		if (team) {
+			scalable_free(update_buffer);
+			scalable_free(candidate_buffer);
+		}
 	}
 
+	/** One-to-all search: Compute the pareto optimal labels of all nodes */
 	void run(const NodeID node) {
+		search(node, NoLabelPruning());
+	}
+
+	/** 
+	 * One-to-one search: Only the label set of the target is guaranteed to be complete. 
+	 * Labels dominated by the current target labels are not relaxed any further.
+	 */
+	void run(const NodeID node, const NodeID target) {
+		search(node, TargetDominancePruning<LabelSet>(labelsets[target], hop_epsilon));
+	}
+
+	/** 
+	 * Goal-directed one-to-one search: Labels are pruned if their sum with the lower bounds
+	 * of their node (i.e., the best possible extension to the target) is already dominated.
+	 */
+	void runGoalDirected(const NodeID node, const NodeID target) {
+		lower_bounds.compute(target);
+		search(node, LowerBoundPruning<LabelSet>(labelsets[target], lower_bounds, hop_epsilon));
+	}
+
+	/**
+	 * Resource-constrained one-to-one search: Find the lexicographically smallest label of the target
+	 * whose weights do not exceed max_weights (use MAX_WEIGHT to leave a criterion unconstrained).
+	 * Returns false if there is no such label. The search is always exact.
+	 */
+	bool runConstrained(const NodeID node, const NodeID target, const Label& max_weights, Label& best) {
+		lower_bounds.compute(target);
+		search(node, ResourceConstrainedPruning<LabelSet>(labelsets[target], lower_bounds, max_weights));
+		if (labelsets[target].size() == 0) {
+			return false;
+		}
+		best = labelsets[target].front();
+		return true;
+	}
+
+	/** One-to-one search with a custom pruning predicate (see LabelPruning.hpp) */
+	template<typename Pruning>
+	void runPruned(const NodeID node, const Pruning& prune) {
+		search(node, prune);
+	}
+
+	/** 
+	 * Reconstruct a path of the last query that ends in the given label of the node.
+	 * The nodes are written in order, starting with the source node.
+	 */
+	bool unpackPath(const NodeID node, const Label& label, std::vector<NodeID>& path) {
+		reverse_graph.init();
+		return unpackParetoPath(reverse_graph, labelsets, source, node, label, path);
+	}
+
+	/** 
+	 * Approximate all following searches: Each pareto optimal path to a node (of at most max_hops 
+	 * edges) is dominated by a reported label scaled by (1+epsilon). A label is discarded if another
+	 * label of its node (or of the target, for one-to-one searches) is within a factor of 
+	 * (1+epsilon)^(1/max_hops) in both criteria, as the errors of successive discards along a path
+	 * multiply. Pareto optimal paths are simple, so max_hops=0 uses n-1. Use 0 for exact searches (default).
+	 */
+	void setEpsilon(const double epsilon, const size_t max_hops=0) {
+		const size_t hops = max_hops > 0 ? max_hops : std::max<size_t>(graph.numberOfNodes(), 2) - 1;
+		hop_epsilon = epsilon > 0 ? std::pow(1.0 + epsilon, 1.0 / hops) - 1.0 : 0;
+	}
+
+	/** Prepare for the next query by clearing all label sets touched since the last reset */
+	void reset() {
+		for (auto& tl : tls_data) {
+			for (const NodeID node : tl.touched_nodes) {
+				labelsets[node].reset();
+			}
+			tl.touched_nodes.clear();
+		}
+	}
+
+private:
+
+	template<typename Pruning>
+	void search(const NodeID node, const Pruning& prune) {
+		source = node;
+		pq.init(NodeLabel(node, Label(0,0)));
+		labelsets[node].init(Label(0,0), tls_data.local().labelset_data);
+		tls_data.local().touched_nodes.push_back(node);
+
+		if (use_worker_team) {
+			searchByTeam(prune);
+		} else {
+			searchByTasks(prune);
+		}
+	}
+
+	template<typename Pruning>
+	void searchByTasks(const Pruning& prune) {
 		#ifdef GATHER_SUBCOMPNENT_TIMING
 			tbb::tick_count stop, start = tbb::tick_count::now();
 		#endif
@@ -125,58 +289,171 @@ public:
 		tbb::affinity_partitioner candidates_part;
 		tbb::auto_partitioner tree_part;
 
-		pq.init(NodeLabel(node, Label(0,0)));
-		labelsets[node].init(Label(0,0), tls_data.local().labelset_data);
-
 		while (!pq.empty()) {
+			if (pq.size() < SEQUENTIAL_FALLBACK_THRESHOLD) {
+				iterationSolo(prune);
+				TIME_COMPONENT(timings[SOLO_ITERATIONS]);
+				continue;
+			}
 			update_counter = 0;
 			candidate_counter = 0;
 			stats.report(ITERATION, pq.size());
 
-			pq.findParetoMinima(); // write pareto minima to updates & candidates vectors
+			pq.findParetoMinima(prune); // write pareto minima to updates (unless extracted in place) & candidates vectors
 			TIME_COMPONENT(timings[FIND_PARETO_MIN]);
 
 			sortByNode(candidates, candidate_counter, auto_part, min_problem_size(candidate_counter, 512));
 			TIME_COMPONENT(timings[SORT_CANDIDATES]);
 			candidate_counter -= countGapsInThreadLocalCandidateBuckets();
 
-			tbb::parallel_for(node_based_range(candidates, candidate_counter, min_problem_size(candidate_counter, 64)),
-			[this](const node_based_range& r) {				
-				#ifdef GATHER_SUB_SUBCOMPNENT_TIMING
-					typename TLSTimings::reference subtimings = tls_timings.local();
-					tbb::tick_count stop, start = tbb::tick_count::now();
-				#endif
-				typename TLSData::reference tl = tls_data.local();
-
-				size_t i = r.begin();
-				const size_t end = r.end();
-				while(i != end) {
-					const size_t range_start = i;
-					const NodeID node = candidates[i].node;
-					auto& ls = labelsets[node];
-					ls.prefetch(); // fetch label set while we prepare its candidate labels
-
-					while (i != end && candidates[i].node == node) {
-						++i;
-					}
-					std::sort(candidates+range_start, candidates+i, groupLabels);
-					TIME_SUBCOMPONENT(subtimings.candidates_sort);
-
-					ls.updateLabelSet(node, candidates+range_start, candidates+i, tl.updates, tl.labelset_data, stats);
-					TIME_SUBCOMPONENT(subtimings.update_labelsets);
-				}
-			}, candidates_part);
+			const auto update_labelsets = [this](const node_based_range& r) {
+				updateLabelSets(candidates, r.begin(), r.end(), tls_data.local().updates);
+			};
+			const node_based_range candidate_range(candidates, candidate_counter, min_problem_size(candidate_counter, 64));
+			if (candidate_range.is_divisible()) {
+				tbb::parallel_for(candidate_range, update_labelsets, candidates_part);
+			} else {
+				update_labelsets(candidate_range);
+			}
 			TIME_COMPONENT(timings[UPDATE_LABELSETS]);
 
 			parallel_sort(updates, updates+update_counter, groupByWeight, auto_part, min_problem_size(update_counter, 512));
 			TIME_COMPONENT(timings[SORT_UPDATES]);
+			const OperationBatchType batch_type = updateBatchType();
 			update_counter -= countGapsInThreadLocalUpdateBuckets();
 
-			pq.applyUpdates(updates, update_counter, tree_part);
+			pq.applyUpdates(updates, update_counter, batch_type, tree_part);
 			TIME_COMPONENT(timings[PQ_UPDATE]);
 		}		
 	}
 
+	template<typename Pruning>
+	void searchByTeam(const Pruning& prune) {
+		if (!team) {
+			team.reset(new worker_team(pq.num_threads));
+			update_buffer = (Updates*) scalable_malloc(LARGE_ENOUGH_FOR_EVERYTHING * sizeof(Updates));
+			candidate_buffer = (NodeLabel*) scalable_malloc(LARGE_ENOUGH_FOR_EVERYTHING * sizeof(NodeLabel));
+		}
+		team_iterations[0] = nextTeamIteration();
+		team->run([this, &prune](worker_team::worker& worker) {
+			for (size_t i = 0; team_iterations[i % 2] != TEAM_DONE; ++i) {
+				if (team_iterations[i % 2] == TEAM_SOLO) {
+					// Small iteration: worker 0 handles it alone while the others wait at the barrier
+					if (worker.id == 0) {
+						iterationSolo(prune);
+					}
+				} else {
+					iterationByTeam(worker, prune);
+				}
+				// Double buffered, as worker 0 may already run the next iteration while others still read
+				if (worker.id == 0) {
+					team_iterations[(i+1) % 2] = nextTeamIteration();
+				}
+				worker.barrier();
+			}
+		});
+	}
+
+	inline TeamIteration nextTeamIteration() const {
+		if (pq.empty()) {
+			return TEAM_DONE;
+		}
+		return pq.size() < SEQUENTIAL_FALLBACK_THRESHOLD ? TEAM_SOLO : TEAM_SPMD;
+	}
+
+	/** A single iteration of the search loop, executed by all workers of the team */
+	template<typename Pruning>
+	void iterationByTeam(worker_team::worker& worker, const Pruning& prune) {
+		if (worker.id == 0) {
+			update_counter = 0;
+			candidate_counter = 0;
+			stats.report(ITERATION, pq.size());
+		}
+		pq.findParetoMinimaByTeam(worker, prune);
+		worker.barrier();
+
+		if (worker.id == 0) {
+			team_candidate_count = candidate_counter - countGapsInThreadLocalCandidateBuckets();
+		}
+		sortCandidatesByTeam(worker, candidates, candidate_counter, candidate_buffer, SEQUENTIAL_FALLBACK_THRESHOLD);
+		worker.barrier();
+
+		updateLabelSets(candidates, nodeAlignedBoundary(worker.id, worker.size), nodeAlignedBoundary(worker.id+1, worker.size), tls_data.local().updates);
+		worker.barrier();
+
+		if (worker.id == 0) {
+			team_batch_type = updateBatchType();
+			team_update_count = update_counter - countGapsInThreadLocalUpdateBuckets();
+		}
+		sortUpdatesByTeam(worker, updates, update_counter, update_buffer, SEQUENTIAL_FALLBACK_THRESHOLD);
+		worker.barrier();
+
+		pq.applyUpdatesByTeam(updates, team_update_count, team_batch_type, worker);
+	}
+
+	/**
+	 * A small iteration, run sequentially by the calling thread. Minima, candidates and updates are
+	 * written to plain vectors instead of the atomically reserved buckets of the thread local
+	 * write buffers, so that no gaps have to be counted and no TBB tasks are spawned.
+	 */
+	template<typename Pruning>
+	void iterationSolo(const Pruning& prune) {
+		stats.report(ITERATION, pq.size());
+		solo_updates.clear();
+		solo_candidates.clear();
+
+		pq.findParetoMinimaSequentially(solo_updates, solo_candidates, prune);
+		std::sort(solo_candidates.begin(), solo_candidates.end(), groupCandidates);
+		updateLabelSets(solo_candidates.data(), 0, solo_candidates.size(), solo_updates);
+
+		std::sort(solo_updates.begin(), solo_updates.end(), groupByWeight);
+		const bool has_deletes = std::any_of(solo_updates.begin(), solo_updates.end(),
+			[](const Updates& op) { return op.type == Updates::DELETE; });
+		worker_team::worker solo = worker_team::solo();
+		pq.applyUpdatesByTeam(solo_updates.data(), solo_updates.size(), has_deletes ? INSERTS_AND_DELETES : INSERTS_ONLY, solo);
+	}
+
+	/** Split the sorted candidates into equally sized parts, so that each label set belongs to a single part */
+	inline size_t nodeAlignedBoundary(const size_t part, const size_t parts) const {
+		size_t i = part * team_candidate_count / parts;
+		while (i != 0 && i < team_candidate_count && candidates[i].node == candidates[i-1].node) {
+			++i;
+		}
+		return i;
+	}
+
+	/** Merge the (sorted) candidates in [i, end) into their label sets. Candidates of a node must not be split */
+	template<typename upd_sequence_type>
+	void updateLabelSets(NodeLabel* const candidates, size_t i, const size_t end, upd_sequence_type& pq_updates) {
+		#ifdef GATHER_SUB_SUBCOMPNENT_TIMING
+			typename TLSTimings::reference subtimings = tls_timings.local();
+			tbb::tick_count stop, start = tbb::tick_count::now();
+		#endif
+		typename TLSData::reference tl = tls_data.local();
+
+		while(i != end) {
+			const size_t range_start = i;
+			const NodeID node = candidates[i].node;
+			auto& ls = labelsets[node];
+			ls.prefetch(); // fetch label set while we prepare its candidate labels
+			if (ls.size() == 0) {
+				// a label set cannot become empty once it has received a candidate
+				tl.touched_nodes.push_back(node);
+			}
+
+			while (i != end && candidates[i].node == node) {
+				++i;
+			}
+			std::sort(candidates+range_start, candidates+i, groupLabels);
+			TIME_SUBCOMPONENT(subtimings.candidates_sort);
+
+			ls.updateLabelSet(node, candidates+range_start, candidates+i, pq_updates, tl.labelset_data, stats, hop_epsilon);
+			TIME_SUBCOMPONENT(subtimings.update_labelsets);
+		}
+	}
+
+public:
+
 	inline void sortByNode(NodeLabel* candidates, const AtomicCounter& candidate_counter, tbb::auto_partitioner& auto_part, const size_t min_prob_size) {
 		#ifdef RADIX_SORT
 			parallel_radix_sort(candidates, candidate_counter, [](const NodeLabel& x) { return x.node; }, auto_part, min_prob_size);
@@ -185,6 +462,16 @@ public:
 		#endif
 	}
 
+	/** Without DELETE updates (e.g., the queue extracts its minima in place), the cheaper INSERTS_ONLY path can be used */
+	inline OperationBatchType updateBatchType() {
+		bool has_deletes = false;
+		for (auto& tl : tls_data) {
+			has_deletes |= tl.updates.has_deletes;
+			tl.updates.has_deletes = false;
+		}
+		return has_deletes ? INSERTS_AND_DELETES : INSERTS_ONLY;
+	}
+
 	inline size_t countGapsInThreadLocalUpdateBuckets() {
 		size_t update_counter_size_diff = 0;
 		for (auto& tl : tls_data) {
@@ -201,7 +488,11 @@ public:
 		return update_counter_size_diff;
 	}
 
+	/** Grainsize of the parallel phases. Small iterations are not split at all (sequential fallback) */
 	inline size_t min_problem_size(const size_t total, const double max=1.0) const {
+		if (total < SEQUENTIAL_FALLBACK_THRESHOLD) {
+			return total + 1;
+		}
 		return std::max((total/pq.num_threads) / (log2(total/pq.num_threads + 1)+1), max);
 	}
 
@@ -273,6 +564,7 @@ public:
 			#endif
 			std::cout << "#   " << timings[SORT_UPDATES] << " Sort Updates"  << std::endl;
 			std::cout << "#   " << timings[PQ_UPDATE]    << " Update PQ " << std::endl;
+			std::cout << "#   " << timings[SOLO_ITERATIONS] << " Small Iterations (sequential)" << std::endl;
 		#endif
 		pq.printStatistics();
 	}
@@ -283,6 +575,7 @@ public:
 		#endif
 	}
 
+	const LabelSet& labelSet(NodeID node) const { return labelsets[node]; }
 	size_t size(NodeID node) const { return labelsets[node].size(); }
 	typename LabelSet::iterator begin(NodeID node) { return labelsets[node].begin(); }
 	typename LabelSet::iterator end(NodeID node) { return labelsets[node].end(); }
@@ -293,8 +586,8 @@ private:
 
 	#ifdef GATHER_SUBCOMPNENT_TIMING
 		enum Component {FIND_PARETO_MIN=0, UPDATE_LABELSETS=1, SORT_CANDIDATES=2, SORT_UPDATES=3, PQ_UPDATE=4,
-						TL_CANDIDATES_SORT=5, TL_UPDATE_LABELSETS=6 };
-		double timings[7] = {0, 0, 0, 0, 0, 0, 0};
+						TL_CANDIDATES_SORT=5, TL_UPDATE_LABELSETS=6, SOLO_ITERATIONS=7 };
+		double timings[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 
 		#ifdef GATHER_SUB_SUBCOMPNENT_TIMING
 			struct tls_tim {
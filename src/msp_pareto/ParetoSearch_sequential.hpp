@@ -15,8 +15,11 @@
 #include "ParetoQueue_sequential.hpp"
 #include "ParetoLabelSet.hpp"
 #include "ParetoSearchStatistics.hpp"
+#include "LabelPruning.hpp"
+#include "PathUnpacking.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include "../utility/radix_sort.hpp"
 
 #ifdef GATHER_SUBCOMPNENT_TIMING
@@ -48,10 +51,15 @@ private:
 	std::vector<Operation<NodeLabel> > updates;
 	std::vector<NodeID> affected_nodes;
 	std::vector<NodeLabel> candidates;
+	std::vector<NodeID> touched_nodes;
 
 	const Graph& graph;
 	SequentialParetoQueue pq;
 	ParetoSearchStatistics<Label> stats;
+	ReverseGraph reverse_graph;
+	LowerBounds lower_bounds;
+	NodeID source;
+	double hop_epsilon;
 
 	#ifdef GATHER_SUBCOMPNENT_TIMING
 		enum Component {FIND_PARETO_MIN=0, CANDIDATE_SORT=1, UPDATE_LABELSETS=2, UPDATES_SORT=3, PQ_UPDATE=4};
@@ -70,6 +78,10 @@ public:
 	ParetoSearch(const Graph& graph_):
 		labels(graph_.numberOfNodes()), 
 		graph(graph_),
+		reverse_graph(graph_),
+		lower_bounds(reverse_graph),
+		source(0),
+		hop_epsilon(0),
 		labelset_data(labels[0])
 		#ifdef GATHER_DATASTRUCTURE_MODIFICATION_LOG
 			,set_insertions(101)
@@ -78,11 +90,91 @@ public:
 	{
 		updates.reserve(LARGE_ENOUGH_FOR_MOST);
 		candidates.reserve(LARGE_ENOUGH_FOR_MOST);
+		#ifdef POSITIONAL_MINIMA_DELETION
+			pq.setPositionalDeletion(true);
+		#endif
 	 }
 
+	/** One-to-all search: Compute the pareto optimal labels of all nodes */
 	void run(const NodeID node) {
+		search(node, NoLabelPruning());
+	}
+
+	/** 
+	 * One-to-one search: Only the label set of the target is guaranteed to be complete. 
+	 * Labels dominated by the current target labels are not relaxed any further.
+	 */
+	void run(const NodeID node, const NodeID target) {
+		search(node, TargetDominancePruning<LabelSet>(labels[target], hop_epsilon));
+	}
+
+	/** 
+	 * Goal-directed one-to-one search: Labels are pruned if their sum with the lower bounds
+	 * of their node (i.e., the best possible extension to the target) is already dominated.
+	 */
+	void runGoalDirected(const NodeID node, const NodeID target) {
+		lower_bounds.compute(target);
+		search(node, LowerBoundPruning<LabelSet>(labels[target], lower_bounds, hop_epsilon));
+	}
+
+	/**
+	 * Resource-constrained one-to-one search: Find the lexicographically smallest label of the target
+	 * whose weights do not exceed max_weights (use MAX_WEIGHT to leave a criterion unconstrained).
+	 * Returns false if there is no such label. The search is always exact.
+	 */
+	bool runConstrained(const NodeID node, const NodeID target, const Label& max_weights, Label& best) {
+		lower_bounds.compute(target);
+		search(node, ResourceConstrainedPruning<LabelSet>(labels[target], lower_bounds, max_weights));
+		if (labels[target].size() == 0) {
+			return false;
+		}
+		best = labels[target].front();
+		return true;
+	}
+
+	/** One-to-one search with a custom pruning predicate (see LabelPruning.hpp) */
+	template<typename Pruning>
+	void runPruned(const NodeID node, const Pruning& prune) {
+		search(node, prune);
+	}
+
+	/** 
+	 * Reconstruct a path of the last query that ends in the given label of the node.
+	 * The nodes are written in order, starting with the source node.
+	 */
+	bool unpackPath(const NodeID node, const Label& label, std::vector<NodeID>& path) {
+		reverse_graph.init();
+		return unpackParetoPath(reverse_graph, labels, source, node, label, path);
+	}
+
+	/** 
+	 * Approximate all following searches: Each pareto optimal path to a node (of at most max_hops 
+	 * edges) is dominated by a reported label scaled by (1+epsilon). A label is discarded if another
+	 * label of its node (or of the target, for one-to-one searches) is within a factor of 
+	 * (1+epsilon)^(1/max_hops) in both criteria, as the errors of successive discards along a path
+	 * multiply. Pareto optimal paths are simple, so max_hops=0 uses n-1. Use 0 for exact searches (default).
+	 */
+	void setEpsilon(const double epsilon, const size_t max_hops=0) {
+		const size_t hops = max_hops > 0 ? max_hops : std::max<size_t>(graph.numberOfNodes(), 2) - 1;
+		hop_epsilon = epsilon > 0 ? std::pow(1.0 + epsilon, 1.0 / hops) - 1.0 : 0;
+	}
+
+	/** Prepare for the next query by clearing all label sets touched since the last reset */
+	void reset() {
+		for (const NodeID node : touched_nodes) {
+			labels[node].reset();
+		}
+		touched_nodes.clear();
+	}
+
+private:
+
+	template<typename Pruning>
+	void search(const NodeID node, const Pruning& prune) {
+		source = node;
 		pq.init(NodeLabel(node, Label(0,0)));
 		labels[node].init(Label(0,0), labelset_data);
+		touched_nodes.push_back(node);
 
 		#ifdef GATHER_SUBCOMPNENT_TIMING
 			tbb::tick_count stop, start = tbb::tick_count::now();
@@ -91,8 +183,8 @@ public:
 		while (!pq.empty()) {
 			stats.report(ITERATION, pq.size());
 
-			pq.findParetoMinima(updates, candidates, graph);
-			const size_t minima_count = updates.size();
+			const size_t minima_count = pq.findParetoMinima(updates, candidates, graph, prune);
+			const size_t delete_count = updates.size(); // zero if the queue deletes its minima by position
 			stats.report(MINIMA_COUNT, minima_count);
 			TIME_COMPONENT(timings[FIND_PARETO_MIN]);
 
@@ -106,22 +198,26 @@ public:
 				auto range_start = cand_iter;
 				auto& ls = labels[range_start->node];
 				ls.prefetch();
+				if (ls.size() == 0) {
+					// a label set cannot become empty once it has received a candidate
+					touched_nodes.push_back(range_start->node);
+				}
 				while (cand_iter != cand_end && range_start->node == cand_iter->node) {
 					++cand_iter;
 				}
 				std::sort(range_start, cand_iter, groupLabels);
-				ls.updateLabelSet(range_start->node, range_start, cand_iter, updates, labelset_data, stats);
+				ls.updateLabelSet(range_start->node, range_start, cand_iter, updates, labelset_data, stats, hop_epsilon);
 			}
 			TIME_COMPONENT(timings[UPDATE_LABELSETS]);
 
 			// Sort sequence for batch update
-			std::sort(updates.begin()+minima_count, updates.end(), groupOpsByWeight);
-			std::inplace_merge(updates.begin(), updates.begin()+minima_count, updates.end(), groupOpsByWeight);
+			std::sort(updates.begin()+delete_count, updates.end(), groupOpsByWeight);
+			std::inplace_merge(updates.begin(), updates.begin()+delete_count, updates.end(), groupOpsByWeight);
 			TIME_COMPONENT(timings[UPDATES_SORT]);
 
 			const size_t pre_update_size = pq.size();
 			pq.applyUpdates(updates);
-			stats.report(UPDATE_COUNT, updates.size());
+			stats.report(UPDATE_COUNT, updates.size() + minima_count - delete_count); // including positional deletions
 			stats.report(PQ_SIZE_DELTA, std::abs((signed long)pq.size()-(signed long)pre_update_size));
 			TIME_COMPONENT(timings[PQ_UPDATE]);
 
@@ -130,6 +226,8 @@ public:
 		}		
 	}
 
+public:
+
 	inline void sort(std::vector<NodeLabel>& candidates) {
 		#ifdef RADIX_SORT
 			radix_sort(candidates.data(), candidates.size(), [](const NodeLabel& x) { return x.node; });
@@ -169,6 +267,7 @@ public:
 		#endif
 	}
 
+	const LabelSet& labelSet(NodeID node) const { return labels[node]; }
 	size_t size(NodeID node) const { return labels[node].size(); }
 	std::vector<Label>::iterator begin(NodeID node) { return labels[node].begin(); }
 	std::vector<Label>::const_iterator begin(NodeID node) const { return labels[node].begin(); }
@@ -0,0 +1,69 @@
+/*
+ * Reconstruction of pareto optimal paths from the final label sets of a search.
+ *
+ * No predecessors are stored during the search. Every label that has been relaxed is
+ * pareto optimal and therefore still part of the final label set of its node. The
+ * parent of a label at node v is thus found by probing the label sets of the
+ * incoming neighbors u for the label minus the weight of the edge (u, v).
+ *
+ * Author: Stephan Erb
+ */
+#ifndef PATH_UNPACKING_H_
+#define PATH_UNPACKING_H_
+
+#include "../Label.hpp"
+#include "ReverseGraph.hpp"
+
+#include <vector>
+#include <set>
+#include <tuple>
+
+/**
+ * Write the nodes of a path from the source to the given label of the node. 
+ * Returns false if the label is not the result of the last search.
+ *
+ * Parents are probed depth-first. Across zero weight edges, a parent can carry the same label
+ * as its child, so (node, label) states are tried only once and dead ends are backtracked.
+ */
+template<typename LabelSets>
+bool unpackParetoPath(const ReverseGraph& reverse_graph, const LabelSets& labelsets, const NodeID source,
+		const NodeID node, const Label label, std::vector<NodeID>& path) {
+	struct Step {
+		NodeID node;
+		Label label;
+		EdgeID next_edge;
+	};
+	typedef std::tuple<NodeID, Label::weight_type, Label::weight_type> State;
+
+	path.clear();
+	if (!labelsets[node].contains(label)) {
+		return false;
+	}
+	std::vector<Step> steps(1, Step{node, label, reverse_graph.edgeBegin(node)});
+	std::set<State> visited{State(node, label.first_weight, label.second_weight)};
+
+	while (steps.back().node != source || steps.back().label != Label(0,0)) {
+		Step& step = steps.back();
+		if (step.next_edge == reverse_graph.edgeEnd(step.node)) {
+			steps.pop_back(); // no parent left to probe
+			if (steps.empty()) {
+				return false;
+			}
+			continue;
+		}
+		const Edge& edge = reverse_graph.getEdge(step.next_edge++);
+		if (edge.first_weight <= step.label.first_weight && edge.second_weight <= step.label.second_weight) {
+			const Label parent(step.label.first_weight - edge.first_weight, step.label.second_weight - edge.second_weight);
+			if (labelsets[edge.target].contains(parent)
+					&& visited.insert(State(edge.target, parent.first_weight, parent.second_weight)).second) {
+				steps.push_back(Step{edge.target, parent, reverse_graph.edgeBegin(edge.target)});
+			}
+		}
+	}
+	for (auto step = steps.rbegin(); step != steps.rend(); ++step) {
+		path.push_back(step->node);
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,271 @@
+/*
+ * Storage of the PSTParetoQueue: A priority search tree over the labels in lexicographic order.
+ * Every node is annotated with the leftmost label of the smallest second weight within its
+ * subtree, i.e., the heap order on the second weight. A subtree can only hold pareto minima
+ * if this label undercuts the minimum of all labels before it, so that the minima are enumerated
+ * in O(k log n) without touching subtrees of dominated labels.
+ *
+ * The tree is kept balanced as a treap (random node priorities). The nodes are stored in a
+ * single array and referenced by 32 bit indices. Index 0 is a sentinel for missing children.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef PRIORITY_SEARCH_TREE_H_
+#define PRIORITY_SEARCH_TREE_H_
+
+#include "../options.hpp"
+#include "../Label.hpp"
+#include "../Graph.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+class PrioritySearchTree {
+public:
+	typedef Label::weight_type weight_type;
+
+private:
+	typedef uint32_t node_ref;
+	static const node_ref nil = 0;
+
+	struct Node {
+		NodeLabel label;
+		Label minimum; // leftmost label of the smallest second weight within the subtree
+		uint32_t priority;
+		node_ref left;
+		node_ref right;
+	};
+
+	std::vector<Node> nodes;
+	node_ref root;
+	node_ref free_list; // chained via the left child
+	std::vector<node_ref> path; // ancestors of a deleted node
+	size_t label_count;
+	uint32_t random_state;
+
+	static inline bool less(const NodeLabel& i, const NodeLabel& j) {
+		return i.first_weight < j.first_weight || (i.first_weight == j.first_weight &&
+			(i.second_weight < j.second_weight || (i.second_weight == j.second_weight && i.node < j.node)));
+	}
+
+	/** Same rule as in the B-tree: Undercut the second weight of the prefix minimum or equal its weights */
+	static inline bool undercuts(const Label& l, const Label& prefix_minima) {
+		return l.second_weight < prefix_minima.second_weight
+			|| (l.first_weight == prefix_minima.first_weight && l.second_weight == prefix_minima.second_weight);
+	}
+
+	inline uint32_t nextPriority() {
+		// xorshift32
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+		return random_state;
+	}
+
+	inline node_ref allocate(const NodeLabel& label) {
+		node_ref n = free_list;
+		if (n != nil) {
+			free_list = nodes[n].left;
+		} else {
+			n = nodes.size();
+			nodes.emplace_back();
+		}
+		Node& node = nodes[n];
+		node.label = label;
+		node.minimum = label;
+		node.priority = nextPriority();
+		node.left = nil;
+		node.right = nil;
+		return n;
+	}
+
+	inline void release(const node_ref n) {
+		nodes[n].left = free_list;
+		free_list = n;
+	}
+
+	/** Restore the subtree minimum of the node from its children */
+	inline void fix(const node_ref n) {
+		Node& node = nodes[n];
+		const Label* min = &nodes[node.left].minimum; // the sentinel holds the largest label
+		if (node.label.second_weight < min->second_weight) {
+			min = &node.label;
+		}
+		if (nodes[node.right].minimum.second_weight < min->second_weight) {
+			min = &nodes[node.right].minimum;
+		}
+		node.minimum = *min;
+	}
+
+	/** Split the subtree into the labels smaller than the key and the remaining ones */
+	void split(const node_ref n, const NodeLabel& key, node_ref& smaller, node_ref& larger) {
+		if (n == nil) {
+			smaller = larger = nil;
+		} else if (less(nodes[n].label, key)) {
+			split(nodes[n].right, key, nodes[n].right, larger);
+			smaller = n;
+			fix(n);
+		} else {
+			split(nodes[n].left, key, smaller, nodes[n].left);
+			larger = n;
+			fix(n);
+		}
+	}
+
+	/** Join two subtrees, where all labels of the first are smaller */
+	node_ref merge(const node_ref smaller, const node_ref larger) {
+		if (smaller == nil) {
+			return larger;
+		}
+		if (larger == nil) {
+			return smaller;
+		}
+		if (nodes[smaller].priority > nodes[larger].priority) {
+			nodes[smaller].right = merge(nodes[smaller].right, larger);
+			fix(smaller);
+			return smaller;
+		} else {
+			nodes[larger].left = merge(smaller, nodes[larger].left);
+			fix(larger);
+			return larger;
+		}
+	}
+
+	/** The label replaces the minimum of a subtree it is added to */
+	static inline bool precedes(const Label& l, const Label& minimum) {
+		return l.second_weight < minimum.second_weight || (l.second_weight == minimum.second_weight && l.first_weight < minimum.first_weight);
+	}
+
+	void insert(const NodeLabel& label) {
+		const node_ref new_node = allocate(label); // may move the nodes
+		const uint32_t priority = nodes[new_node].priority;
+
+		// Descend until the priority of the new node is reached, fixing the minima on the way
+		node_ref* link = &root;
+		while (*link != nil && nodes[*link].priority >= priority) {
+			Node& node = nodes[*link];
+			if (precedes(label, node.minimum)) {
+				node.minimum = label;
+			}
+			link = less(label, node.label) ? &node.left : &node.right;
+		}
+		split(*link, label, nodes[new_node].left, nodes[new_node].right);
+		fix(new_node);
+		*link = new_node;
+	}
+
+	void erase(const NodeLabel& label) {
+		path.clear();
+		node_ref* link = &root;
+		while (*link != nil && (less(label, nodes[*link].label) || less(nodes[*link].label, label))) {
+			path.push_back(*link);
+			link = less(label, nodes[*link].label) ? &nodes[*link].left : &nodes[*link].right;
+		}
+		assert(*link != nil && "deleted label has to be in the queue");
+		if (*link == nil) {
+			return;
+		}
+		const node_ref n = *link;
+		*link = merge(nodes[n].left, nodes[n].right);
+		release(n);
+
+		// Only subtrees whose minimum had the weights of the label are affected
+		for (auto it = path.rbegin(); it != path.rend(); ++it) {
+			const Label& minimum = nodes[*it].minimum;
+			if (minimum.first_weight != label.first_weight || minimum.second_weight != label.second_weight) {
+				break;
+			}
+			fix(*it);
+		}
+	}
+
+	/** Remove and relax the minima of the subtree in lexicographic order. Returns the new subtree */
+	template<typename cand_sequence_type, typename graph_type, typename Pruning>
+	node_ref extract(const node_ref n, Label& prefix_minima, size_t& count, cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) {
+		if (n == nil || !undercuts(nodes[n].minimum, prefix_minima)) {
+			return n;
+		}
+		nodes[n].left = extract(nodes[n].left, prefix_minima, count, candidates, graph, prune);
+
+		const NodeLabel label = nodes[n].label;
+		const bool is_minimum = undercuts(label, prefix_minima);
+		if (is_minimum) {
+			prefix_minima = label;
+			++count;
+			if (!prune(label.node, label)) {
+				FORALL_EDGES(graph, label.node, eid) {
+					const auto& edge = graph.getEdge(eid);
+					const Label candidate = extended(label, edge);
+					if (!prune(edge.target, candidate)) {
+						candidates.emplace_back(edge.target, candidate);
+					}
+				}
+			}
+		}
+		nodes[n].right = extract(nodes[n].right, prefix_minima, count, candidates, graph, prune);
+
+		if (is_minimum) {
+			const node_ref merged = merge(nodes[n].left, nodes[n].right);
+			release(n);
+			return merged;
+		}
+		fix(n);
+		return n;
+	}
+
+public:
+	PrioritySearchTree():
+		root(nil),
+		free_list(nil),
+		label_count(0),
+		random_state(2463534242u)
+	{
+		nodes.emplace_back(); // sentinel
+		nodes[nil].minimum = Label(MAX_WEIGHT, MAX_WEIGHT);
+	}
+
+	/** Apply the sorted updates */
+	void applyUpdates(const Operation<NodeLabel>* const begin, const Operation<NodeLabel>* const end) {
+		for (const Operation<NodeLabel>* op = begin; op != end; ++op) {
+			switch (op->type) {
+			case Operation<NodeLabel>::DELETE:
+				erase(op->data);
+				--label_count;
+				continue;
+			case Operation<NodeLabel>::INSERT:
+				insert(op->data);
+				++label_count;
+				continue;
+			}
+		}
+	}
+
+	/** Remove all pareto minima and relax those that are not pruned. Returns their number */
+	template<typename cand_sequence_type, typename graph_type, typename Pruning>
+	size_t extractMinima(cand_sequence_type& candidates, const graph_type& graph, const Pruning& prune) {
+		Label prefix_minima(MIN_WEIGHT, MAX_WEIGHT);
+		size_t count = 0;
+		root = extract(root, prefix_minima, count, candidates, graph, prune);
+		label_count -= count;
+		return count;
+	}
+
+	void clear() {
+		nodes.resize(1);
+		root = nil;
+		free_list = nil;
+		label_count = 0;
+	}
+
+	size_t size() const {
+		return label_count;
+	}
+
+	/** Allocated nodes (including free ones) */
+	size_t capacity() const {
+		return nodes.size() - 1;
+	}
+};
+
+#endif
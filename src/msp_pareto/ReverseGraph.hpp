@@ -0,0 +1,61 @@
+/*
+ * Reverse adjacency array of a graph, i.e., the incoming edges of each node.
+ * The target of a reverse edge is the source node of the original edge. 
+ * Used for backward searches and path unpacking. Built on first use.
+ *
+ * Author: Stephan Erb
+ */
+#ifndef REVERSE_GRAPH_H_
+#define REVERSE_GRAPH_H_
+
+#include "../Graph.hpp"
+
+#include <vector>
+
+class ReverseGraph {
+private:
+	const Graph& graph;
+	std::vector<EdgeID> edge_begin;
+	std::vector<Edge> edges;
+
+public:
+	ReverseGraph(const Graph& graph_):
+		graph(graph_)
+	{}
+
+	void init() {
+		if (!edge_begin.empty()) {
+			return;
+		}
+		edge_begin.assign(graph.numberOfNodes() + 1, 0);
+		FORALL_NODES(graph, node) {
+			FORALL_EDGES(graph, node, eid) {
+				++edge_begin[graph.getEdge(eid).target + 1];
+			}
+		}
+		for (size_t i = 1; i < edge_begin.size(); ++i) {
+			edge_begin[i] += edge_begin[i-1];
+		}
+		edges.resize(graph.numberOfEdges());
+		std::vector<EdgeID> insert_pos(edge_begin.begin(), edge_begin.end()-1);
+		FORALL_NODES(graph, node) {
+			FORALL_EDGES(graph, node, eid) {
+				const Edge& edge = graph.getEdge(eid);
+				Edge& reverse = edges[insert_pos[edge.target]++];
+				reverse = edge;
+				reverse.target = node;
+			}
+		}
+	}
+
+	/** The graph whose edges are reversed */
+	const Graph& original() const { return graph; }
+
+	size_t numberOfNodes() const { return graph.numberOfNodes(); }
+
+	inline EdgeID edgeBegin(const NodeID node) const { return edge_begin[node]; }
+	inline EdgeID edgeEnd(const NodeID node) const { return edge_begin[node+1]; }
+	inline const Edge& getEdge(const EdgeID eid) const { return edges[eid]; }
+};
+
+#endif
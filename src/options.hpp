@@ -5,6 +5,7 @@
 #include <sstream>
 #include <iostream>
 #include <string.h>
+#include <cstdint>
 
 #define QUOTE(name) #name
 #define STR(macro) QUOTE(macro)
@@ -46,18 +47,33 @@
 
 
 /**
- * Configure the ParetoQueue implementation used by the ParetoSearch algorithm.
+ * Configure the ParetoQueue implementations used by the sequential and the parallel ParetoSearch algorithm.
  */
 #ifndef PARETO_QUEUE
   //#define PARETO_QUEUE VectorParetoQueue
+  //#define PARETO_QUEUE BucketParetoQueue // small integer edge weights only
+  //#define PARETO_QUEUE PSTParetoQueue
   #define PARETO_QUEUE BTreeParetoQueue
 #endif
+#ifndef PARALLEL_PARETO_QUEUE
+  //#define PARALLEL_PARETO_QUEUE ParallelBucketParetoQueue // small integer edge weights only
+  //#define PARALLEL_PARETO_QUEUE ParallelPartitionedParetoQueue // one B-tree per thread, split by first weight
+  #define PARALLEL_PARETO_QUEUE ParallelBTreeParetoQueue
+#endif
 
 /**
  * Within the ParetoSearch algorithm, use either a std::vector-based or a B-tree-based Labelset
  */
 //#define BTREE_PARETO_LABELSET
 
+/**
+ * Width of the edge and label weights: uint16_t, uint32_t or uint64_t. Narrow weights shrink the
+ * label sets, the pareto queue and its updates, but path weights must not exceed their range.
+ */
+#ifndef WEIGHT_TYPE
+#define WEIGHT_TYPE uint32_t
+#endif
+
 /**
  * Keep this defined to gather runtime stats during label setting
  */
@@ -79,6 +95,11 @@
  */
 #define PREFETCH_LABELSETS
 //#define RADIX_SORT
+#define SIMD_PARETO_MINIMA // AVX-512 / AVX2 scan of the B-tree leaves for pareto minima
+//#define BTREE_SOA_LEAVES // ParetoQueue leaves store first weights, second weights and nodes in separate arrays
+#define POSITIONAL_MINIMA_DELETION // The sequential BTreeParetoQueue marks its minima in the leaves instead of emitting DELETE updates
+#define INPLACE_MINIMA_EXTRACTION // The ParallelBTreeParetoQueue removes its minima from the leaves while searching them
+#define CACHED_LEAF_STAIRCASE // ParetoQueue leaves remember their local pareto minima when scanned in full, so the next minima search skips all other keys
 
 /**
  * A suitable size for dynamic but pre-allocated data structures where we want
@@ -91,6 +112,25 @@
 
 #define DCACHE_LINESIZE 128
 
+/**
+ * Parallel ParetoSearch: Iterations with fewer candidates (or pareto queue updates) are
+ * processed by the sequential code paths, as they cannot amortize the task scheduling overhead.
+ */
+#ifndef SEQUENTIAL_FALLBACK_THRESHOLD
+#define SEQUENTIAL_FALLBACK_THRESHOLD 2048
+#endif
+
+/**
+ * AlgorithmSelector: Budget of the probing search (in checked labels) and the thresholds on the
+ * weight correlation, the extrapolated label set size and the estimated edge relaxations of a query.
+ */
+#ifndef SELECTOR_PROBE_BUDGET
+#define SELECTOR_PROBE_BUDGET 20000
+#endif
+#define SELECTOR_CLASSIC_CORRELATION 0.9
+#define SELECTOR_BTREE_LABELSET_SIZE 500
+#define SELECTOR_PARALLEL_RELAXATIONS 2500000
+
 /** 
  * Buffer size: How much buffer space to allocate when writing to shared data structures
  */
@@ -111,7 +151,7 @@
 
 	if (strcmp(STR(LABEL_SETTING_ALGORITHM), "ParetoSearch") == 0) {
 		#ifdef PARALLEL_BUILD
-			out_stream << "ParallelBTreeParetoQueue";
+			out_stream << STR(PARALLEL_PARETO_QUEUE);
 		#else 
 			out_stream << STR(PARETO_QUEUE);
 		#endif
@@ -131,6 +171,7 @@
 		#ifdef PREFETCH_LABELSETS
 			out_stream << ", prefetching";
 		#endif
+		out_stream << ", " << STR(WEIGHT_TYPE);
 		out_stream << ")";
 
 	} else {
@@ -0,0 +1,32 @@
+#ifndef _TBB_EXT_THREAD_PINNING_
+#define _TBB_EXT_THREAD_PINNING_
+
+#include <pthread.h>
+#include <sched.h>
+
+
+/** 
+ * Pin the calling thread to the n-th core of the current process' cpu set (modulo its size).
+ * Returns the pthread error code (0 on success).
+ */
+inline int pin_current_thread(const int n) {
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+		return -1;
+	}
+	int remaining = n % CPU_COUNT(&allowed);
+	int cpu = 0;
+	for (; cpu < CPU_SETSIZE; ++cpu) {
+		if (CPU_ISSET(cpu, &allowed) && remaining-- == 0) {
+			break;
+		}
+	}
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(cpu, &cpuset);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+}
+
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "tbb/task_scheduler_observer.h"
 #include <pthread.h>
+#include "thread_pinning.h"
 
 
 /** 
@@ -24,13 +25,9 @@
 		void on_scheduler_entry(bool) {
 			int myID = threadID.fetch_and_increment();
 
-			cpu_set_t cpuset;
-			CPU_ZERO(&cpuset);
-			CPU_SET(myID, &cpuset);
-
 			std::cout << myID << " on pthread " <<  (unsigned int) pthread_self() << std::endl;
 
-			int error = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+			int error = pin_current_thread(myID);
 			if (error) {
 				std::cout << "bad affinity for " << threadID << ". Errno: " << error << std::endl; 
 				exit(1);
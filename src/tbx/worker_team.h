@@ -0,0 +1,250 @@
+#ifndef _TBB_EXT_WORKER_TEAM_
+#define _TBB_EXT_WORKER_TEAM_
+
+#include "tbb/atomic.h"
+#include "tbb/tbb_machine.h"
+#include "tbb/tbb_thread.h"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <utility>
+
+#include "thread_pinning.h"
+
+
+/**
+ * Sense-reversing centralized barrier. Waiting threads spin (with exponential backoff,
+ * eventually yielding) on a single flag that is flipped by the last arriving thread.
+ */
+class spin_barrier {
+	const unsigned short participants;
+	tbb::atomic<unsigned short> arrived;
+	tbb::atomic<bool> sense;
+
+public:
+	spin_barrier(const unsigned short participants_) : participants(participants_) {
+		arrived = 0;
+		sense = false;
+	}
+
+	/** Each participant has to pass its own local sense flag, initialized to false */
+	void wait(bool& local_sense) {
+		local_sense = !local_sense;
+		if (arrived.fetch_and_increment() == participants-1) {
+			arrived = 0;
+			sense = local_sense; // release all waiting threads
+		} else {
+			tbb::internal::atomic_backoff backoff;
+			while (sense != local_sense) {
+				backoff.pause();
+			}
+		}
+	}
+};
+
+
+/**
+ * A fixed team of threads executing a function SPMD-style. The calling thread participates
+ * as worker 0, so a team of size p only owns p-1 threads. These are (optionally) pinned to
+ * the cores 1..p-1, remain alive in between calls to run(), and wait for the next job on a
+ * condition variable. The calling thread is left unpinned.
+ */
+class worker_team {
+public:
+
+	/** Handle passed to the SPMD function. Identifies the worker within its team */
+	class worker {
+		friend class worker_team;
+		spin_barrier* const team_barrier;
+		bool sense;
+
+	public:
+		const unsigned short id;
+		const unsigned short size;
+
+		worker(const unsigned short id_, const unsigned short size_, spin_barrier* const barrier_)
+			: team_barrier(barrier_), sense(false), id(id_), size(size_)
+		{}
+
+		/** Wait until all workers of the team have reached the barrier */
+		inline void barrier() {
+			if (size > 1) {
+				team_barrier->wait(sense);
+			}
+		}
+	};
+
+	/** A worker that is not part of a team and executes everything by itself */
+	static worker solo() {
+		return worker(0, 1, NULL);
+	}
+
+private:
+	spin_barrier team_barrier;
+	worker leader;
+	std::vector<std::unique_ptr<tbb::tbb_thread>> threads;
+
+	std::mutex mutex;
+	std::condition_variable job_available;
+	const std::function<void(worker&)>* job;
+	size_t epoch;
+	bool shutdown;
+
+	void work(const unsigned short id, const bool pin) {
+		if (pin) {
+			pin_current_thread(id);
+		}
+		worker self(id, leader.size, &team_barrier);
+		size_t seen_epoch = 0;
+		while (true) {
+			const std::function<void(worker&)>* current_job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				job_available.wait(lock, [this, seen_epoch](){ return shutdown || epoch != seen_epoch; });
+				if (shutdown) {
+					return;
+				}
+				seen_epoch = epoch;
+				current_job = job;
+			}
+			(*current_job)(self);
+			self.barrier(); // job completed
+		}
+	}
+
+public:
+	worker_team(const unsigned short size, const bool pin=true)
+		: team_barrier(std::max<unsigned short>(size, 1)), leader(0, std::max<unsigned short>(size, 1), &team_barrier), job(NULL), epoch(0), shutdown(false)
+	{
+		for (unsigned short id = 1; id < leader.size; ++id) {
+			threads.emplace_back(new tbb::tbb_thread([this, id, pin]() { work(id, pin); }));
+		}
+	}
+
+	~worker_team() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			shutdown = true;
+		}
+		job_available.notify_all();
+		for (auto& thread : threads) {
+			thread->join();
+		}
+	}
+
+	unsigned short size() const {
+		return leader.size;
+	}
+
+	/** Execute body(worker) on all workers of the team. Returns once all of them are done */
+	template<typename Body>
+	void run(const Body& body) {
+		const std::function<void(worker&)> f(std::cref(body));
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = &f;
+			++epoch;
+		}
+		job_available.notify_all();
+		f(leader);
+		leader.barrier();
+	}
+};
+
+
+/**
+ * Sort [data, data+n) with all workers of a team (sample sort). The buffer needs room for n
+ * elements. The sorted sequence is only complete once all workers have passed another barrier.
+ * Problems smaller than min_problem_size are sorted sequentially by worker 0.
+ */
+template<typename T, typename Compare>
+class team_sort {
+	typedef std::pair<T*, T*> Run;
+
+	const Compare comp;
+	std::vector<T> splitters;
+	std::vector<T> samples;
+	/** The runs merged by each worker, kept to avoid allocations in every call */
+	std::vector<std::vector<Run>> worker_runs;
+
+	static inline size_t chunk_begin(const size_t chunk, const size_t n, const unsigned short chunks) {
+		return chunk * n / chunks;
+	}
+
+public:
+	team_sort(const Compare& comp_) : comp(comp_) {}
+
+	void operator()(worker_team::worker& w, T* const data, const size_t n, T* const buffer, const size_t min_problem_size) {
+		const unsigned short p = w.size;
+		if (p == 1 || n < min_problem_size || n < (size_t) p * p) {
+			if (w.id == 0) {
+				std::sort(data, data+n, comp);
+			}
+			return;
+		}
+
+		// Sort own chunk and draw regular samples from it
+		const size_t begin = chunk_begin(w.id, n, p);
+		const size_t end = chunk_begin(w.id+1, n, p);
+		std::sort(data+begin, data+end, comp);
+		w.barrier();
+
+		if (w.id == 0) {
+			samples.clear();
+			for (unsigned short c = 0; c < p; ++c) {
+				const size_t c_begin = chunk_begin(c, n, p);
+				const size_t c_size = chunk_begin(c+1, n, p) - c_begin;
+				for (unsigned short s = 0; s < p; ++s) {
+					samples.push_back(data[c_begin + s * c_size / p]);
+				}
+			}
+			std::sort(samples.begin(), samples.end(), comp);
+			splitters.clear();
+			for (unsigned short s = 1; s < p; ++s) {
+				splitters.push_back(samples[s * p]);
+			}
+			if (worker_runs.size() < p) {
+				worker_runs.resize(p);
+			}
+		}
+		w.barrier();
+
+		// Worker i collects all elements in [splitters[i-1], splitters[i]) of all chunks
+		std::vector<Run>& runs = worker_runs[w.id];
+		runs.clear();
+		size_t out = 0;
+		for (unsigned short c = 0; c < p; ++c) {
+			T* const c_begin = data + chunk_begin(c, n, p);
+			T* const c_end = data + chunk_begin(c+1, n, p);
+			T* const lo = w.id == 0 ? c_begin : std::lower_bound(c_begin, c_end, splitters[w.id-1], comp);
+			T* const hi = w.id == p-1 ? c_end : std::lower_bound(lo, c_end, splitters[w.id], comp);
+			out += lo - c_begin;
+			if (lo != hi) {
+				runs.emplace_back(lo, hi);
+			}
+		}
+		// Merge the runs into the buffer, using a heap over their heads (smallest on top)
+		const size_t out_begin = out;
+		const auto later_head = [this](const Run& a, const Run& b) { return comp(*b.first, *a.first); };
+		std::make_heap(runs.begin(), runs.end(), later_head);
+		while (!runs.empty()) {
+			std::pop_heap(runs.begin(), runs.end(), later_head);
+			Run& run = runs.back();
+			buffer[out++] = *run.first++;
+			if (run.first == run.second) {
+				runs.pop_back();
+			} else {
+				std::push_heap(runs.begin(), runs.end(), later_head);
+			}
+		}
+		w.barrier();
+		std::copy(buffer+out_begin, buffer+out, data+out_begin);
+	}
+};
+
+
+#endif
@@ -24,6 +24,7 @@ struct btree_test_set_traits {
     static const bool   selfverify = true;
     static const unsigned int    leafparameter_k = 8;
     static const unsigned int    branchingparameter_b = 8;
+    static const bool            soa_leaves = false;
 };
 
 void assertTrue(bool cond, std::string msg) {
@@ -11,10 +11,17 @@
 #define GATHER_STATS
 #define GATHER_SUBCOMPNENT_TIMING
 #define GATHER_SUB_SUBCOMPNENT_TIMING
+#define SEQUENTIAL_FALLBACK_THRESHOLD 128 // exercise the parallel code paths on small instances
 
 #include <iostream>
+#include <deque>
+#include <sstream>
 #include "../BiCritShortestPathAlgorithm.hpp"
+#include "../AlgorithmSelector.hpp"
 #include "../GraphGenerator.hpp"
+#include "../msp_pareto/MultiCriteriaParetoSearch.hpp"
+#include "../msp_pareto/ContractionHierarchy.hpp"
+#include "../msp_pareto/GraphCompression.hpp"
 
 void assertTrue(bool cond, std::string msg) {
 	BOOST_REQUIRE_MESSAGE(cond, msg);
@@ -76,6 +83,18 @@ void testGrid(LabelSettingAlgorithm&& algo, NodeID target_node, size_t expected_
 	assertTrue(algo.size(target_node) == expected_labels, "Expected num of labels");
 }
 
+template<class LabelSettingAlgorithm>
+void testGridOneToOne(LabelSettingAlgorithm&& algo, NodeID target_node, size_t expected_labels) {
+	algo.run(NodeID(0), target_node);
+	assertTrue(algo.size(target_node) == expected_labels, "Expected num of labels at the target");
+}
+
+template<class LabelSettingAlgorithm>
+void testGridGoalDirected(LabelSettingAlgorithm&& algo, NodeID target_node, size_t expected_labels) {
+	algo.runGoalDirected(NodeID(0), target_node);
+	assertTrue(algo.size(target_node) == expected_labels, "Expected num of labels at the target");
+}
+
 template<class LabelSettingAlgorithm1, class LabelSettingAlgorithm2>
 void assertEqualResultCount(Graph& graph, LabelSettingAlgorithm1& algo1, LabelSettingAlgorithm2& algo2) {
 	FORALL_NODES(graph, node) {
@@ -128,6 +147,19 @@ BOOST_AUTO_TEST_CASE(testParetoSearch_BTree_ManyLabels) {
 	#endif
 }
 
+BOOST_AUTO_TEST_CASE(testParetoSearch_BTree_OneToOne) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.8);
+	#ifdef PARALLEL_BUILD
+		testGridOneToOne(ParetoSearch<BTREE_LS>(graph, my_default_thread_count), graph.numberOfNodes()-1, 794);
+		testGridGoalDirected(ParetoSearch<BTREE_LS>(graph, my_default_thread_count), graph.numberOfNodes()-1, 794);
+	#else 
+		testGridOneToOne(ParetoSearch<BTREE_LS>(graph), graph.numberOfNodes()-1, 794);
+		testGridGoalDirected(ParetoSearch<BTREE_LS>(graph), graph.numberOfNodes()-1, 794);
+	#endif
+}
+
 
 #define VECTOR_LS VectorParetoLabelSet<std::allocator<Label>>
 #define VECTOR_PQ VectorParetoQueue
@@ -171,6 +203,17 @@ BOOST_AUTO_TEST_CASE(testParetoSearch_Vector_ManyLabels) {
 		testGrid(ParetoSearch<VECTOR_LS, VECTOR_PQ>(graph), graph.numberOfNodes()-1, 794);
 	#endif
 }
+BOOST_AUTO_TEST_CASE(testParetoSearch_Vector_OneToOne) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.8);
+	#ifdef PARALLEL_BUILD
+		testGridOneToOne(ParetoSearch<VECTOR_LS>(graph, my_default_thread_count), graph.numberOfNodes()-1, 794);
+	#else 
+		testGridOneToOne(ParetoSearch<VECTOR_LS, VECTOR_PQ>(graph), graph.numberOfNodes()-1, 794);
+		testGridOneToOne(ParetoSearch<VECTOR_LS, BTreeParetoQueue>(graph), graph.numberOfNodes()-1, 794);
+	#endif
+}
 
 
 BOOST_AUTO_TEST_CASE(testSharedHeapLabelSettingAlgorithm_Simple) {
@@ -261,4 +304,994 @@ BOOST_AUTO_TEST_CASE(crossValidateShortestPathSearch_Vector) {
 
 	assertEqualResultCount(graph, algo1, algo2);
 	assertEqualResult(graph, algo1, algo2);
-}
\ No newline at end of file
+}
+
+/** Leaves with separate weight arrays, independent of BTREE_SOA_LEAVES */
+#ifdef PARALLEL_BUILD
+template<typename TLSData>
+using SoABTreeParetoQueue = BasicParallelBTreeParetoQueue<TLSData, btree_soa_traits<NodeLabel, Label>>;
+#else
+typedef BasicBTreeParetoQueue<btree_soa_traits<NodeLabel, Label>> SoABTreeParetoQueue;
+#endif
+
+BOOST_AUTO_TEST_CASE(crossValidateShortestPathSearch_SoABtree) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.4);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS, SoABTreeParetoQueue> algo2(graph, my_default_thread_count);
+		ParetoSearch<VECTOR_LS, SoABTreeParetoQueue> algo3(graph, 4, /*use_worker_team*/true);
+		algo3.run(NodeID(0));
+		assertEqualResult(graph, algo1, algo3);
+	#else
+		ParetoSearch<VECTOR_LS, SoABTreeParetoQueue> algo2(graph);
+	#endif
+	for (unsigned int round = 0; round < 2; ++round) {
+		algo2.run(NodeID(0));
+		assertEqualResultCount(graph, algo1, algo2);
+		assertEqualResult(graph, algo1, algo2);
+		algo2.reset();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateShortestPathSearch_Bucket) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.4);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS, ParallelBucketParetoQueue> algo2(graph, my_default_thread_count);
+		ParetoSearch<VECTOR_LS, ParallelBucketParetoQueue> algo3(graph, 4, /*use_worker_team*/true);
+		algo3.run(NodeID(0));
+		assertEqualResult(graph, algo1, algo3);
+	#else 
+		ParetoSearch<VECTOR_LS, BucketParetoQueue> algo2(graph);
+	#endif
+	for (unsigned int round = 0; round < 2; ++round) {
+		algo2.run(NodeID(0));
+		assertEqualResultCount(graph, algo1, algo2);
+		assertEqualResult(graph, algo1, algo2);
+		algo2.reset();
+	}
+}
+
+#ifndef PARALLEL_BUILD
+BOOST_AUTO_TEST_CASE(crossValidateShortestPathSearch_PST) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.8);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	ParetoSearch<VECTOR_LS, PSTParetoQueue> algo2(graph);
+	for (unsigned int round = 0; round < 2; ++round) {
+		algo2.run(NodeID(0));
+		assertEqualResultCount(graph, algo1, algo2);
+		assertEqualResult(graph, algo1, algo2);
+		algo2.reset();
+	}
+	const NodeID target = NodeID(graph.numberOfNodes()-1);
+	algo2.run(NodeID(0), target);
+	BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo2.begin(target), algo2.end(target));
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(crossValidateOneToOneShortestPathSearch_Vector) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, 0);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	const NodeID targets[] = {NodeID(1), NodeID(4242), NodeID(5050), NodeID(graph.numberOfNodes()-1)};
+	for (const NodeID target : targets) {
+		#ifdef PARALLEL_BUILD
+			ParetoSearch<VECTOR_LS> algo2(graph, my_default_thread_count);
+		#else 
+			ParetoSearch<VECTOR_LS, VECTOR_PQ> algo2(graph);
+		#endif
+		algo2.run(NodeID(0), target);
+
+		BOOST_REQUIRE_EQUAL(algo1.size(target), algo2.size(target));
+		BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo2.begin(target), algo2.end(target));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateGoalDirectedShortestPathSearch_Vector) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.4);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	const NodeID targets[] = {NodeID(1), NodeID(4242), NodeID(5050), NodeID(graph.numberOfNodes()-1)};
+	for (const NodeID target : targets) {
+		#ifdef PARALLEL_BUILD
+			ParetoSearch<VECTOR_LS> algo2(graph, my_default_thread_count);
+		#else 
+			ParetoSearch<VECTOR_LS, VECTOR_PQ> algo2(graph);
+		#endif
+		algo2.runGoalDirected(NodeID(0), target);
+
+		BOOST_REQUIRE_EQUAL(algo1.size(target), algo2.size(target));
+		BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo2.begin(target), algo2.end(target));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateReusedShortestPathSearch) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 60, 60, -0.4);
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS> algo2(graph, my_default_thread_count);
+		ParetoSearch<BTREE_LS> algo3(graph, my_default_thread_count);
+	#else 
+		ParetoSearch<VECTOR_LS, VECTOR_PQ> algo2(graph);
+		ParetoSearch<BTREE_LS> algo3(graph);
+	#endif
+	const NodeID sources[] = {NodeID(0), NodeID(1234), NodeID(graph.numberOfNodes()-1)};
+	for (const NodeID source : sources) {
+		SharedHeapLabelSettingAlgorithm algo1(graph);
+		algo1.run(source);
+
+		// pruned queries leave behind partial label sets that must not leak into the next query
+		algo2.runGoalDirected(source, NodeID(42));
+		algo2.reset();
+		algo2.run(source);
+		algo3.run(source, NodeID(42));
+		algo3.reset();
+		algo3.run(source);
+
+		assertEqualResultCount(graph, algo1, algo2);
+		assertEqualResult(graph, algo1, algo2);
+		assertEqualResultCount(graph, algo1, algo3);
+		algo2.reset();
+		algo3.reset();
+	}
+}
+
+template<class LabelSettingAlgorithm>
+void assertValidPaths(const Graph& graph, LabelSettingAlgorithm& algo, const NodeID source, const NodeID target, 
+		const std::vector<Label>& target_labels) {
+	std::vector<NodeID> path;
+	for (const Label& label : target_labels) {
+		BOOST_REQUIRE(algo.unpackPath(target, label, path));
+		BOOST_REQUIRE_EQUAL(path.front(), source);
+		BOOST_REQUIRE_EQUAL(path.back(), target);
+
+		Label path_weight(0, 0);
+		for (size_t i = 1; i < path.size(); ++i) {
+			bool found = false;
+			FORALL_EDGES(graph, path[i-1], eid) {
+				const Edge& edge = graph.getEdge(eid);
+				if (edge.target == path[i]) {
+					path_weight.first_weight += edge.first_weight;
+					path_weight.second_weight += edge.second_weight;
+					found = true;
+					break;
+				}
+			}
+			BOOST_REQUIRE(found);
+		}
+		BOOST_REQUIRE_EQUAL(path_weight, label);
+	}
+	BOOST_REQUIRE(!algo.unpackPath(target, Label(0, 0), path));
+}
+
+template<class ExactAlgorithm, class ApproximateAlgorithm>
+size_t assertRealLabels(const Graph& graph, ExactAlgorithm& exact, ApproximateAlgorithm& approx) {
+	size_t count = 0;
+	FORALL_NODES(graph, node) {
+		for (auto label = approx.begin(node); label != approx.end(node); ++label) {
+			const bool dominated = std::any_of(exact.begin(node), exact.end(node), [&label](const Label& l) {
+				return l.first_weight <= label->first_weight && l.second_weight <= label->second_weight; });
+			BOOST_REQUIRE_MESSAGE(dominated, "Label " << *label << " of node " << node << " is not a path label");
+			++count;
+		}
+	}
+	return count;
+}
+
+/** Each exact label of the node is dominated by an approximate label scaled by (1+epsilon) */
+template<class ExactAlgorithm, class ApproximateAlgorithm>
+void assertApproximatedLabels(const NodeID node, const ExactAlgorithm& exact, const ApproximateAlgorithm& approx, const double epsilon) {
+	for (auto label = exact.begin(node); label != exact.end(node); ++label) {
+		const bool approximated = std::any_of(approx.begin(node), approx.end(node), [&label, epsilon](const Label& l) {
+			return l.first_weight <= (1+epsilon) * label->first_weight && l.second_weight <= (1+epsilon) * label->second_weight; });
+		BOOST_REQUIRE_MESSAGE(approximated, "Label " << *label << " of node " << node << " is not approximated");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testParetoSearch_Approximation) {
+	const double epsilon = 0.1;
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 40, 40, -0.8, 1000);
+	const NodeID target = NodeID(graph.numberOfNodes()-1);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+	size_t exact_count = 0;
+	FORALL_NODES(graph, node) {
+		exact_count += algo1.size(node);
+	}
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS> algo2(graph, my_default_thread_count);
+		ParetoSearch<BTREE_LS> algo3(graph, my_default_thread_count);
+	#else 
+		ParetoSearch<VECTOR_LS, VECTOR_PQ> algo2(graph);
+		ParetoSearch<BTREE_LS> algo3(graph);
+	#endif
+	algo2.setEpsilon(epsilon);
+	algo3.setEpsilon(epsilon);
+	algo2.run(NodeID(0));
+	algo3.run(NodeID(0));
+
+	// The errors of all discards along a path stay within the requested factor
+	BOOST_REQUIRE_LT(assertRealLabels(graph, algo1, algo2), exact_count);
+	FORALL_NODES(graph, node) {
+		assertApproximatedLabels(node, algo1, algo2, epsilon);
+	}
+	size_t approx_count = 0;
+	FORALL_NODES(graph, node) {
+		approx_count += algo3.size(node);
+	}
+	BOOST_REQUIRE_LT(approx_count, exact_count);
+	BOOST_REQUIRE_GT(algo3.size(target), 0);
+
+	// One-to-one: also epsilon-prunes the pareto queue against the target labels
+	algo2.reset();
+	algo2.run(NodeID(0), target);
+	assertRealLabels(graph, algo1, algo2);
+	assertApproximatedLabels(target, algo1, algo2, epsilon);
+	BOOST_REQUIRE_LT(algo2.size(target), algo1.size(target));
+
+	// Exact again
+	algo2.reset();
+	algo2.setEpsilon(0);
+	algo2.run(NodeID(0));
+	assertEqualResult(graph, algo1, algo2);
+}
+
+BOOST_AUTO_TEST_CASE(testParetoSearch_ApproximationAlongChain) {
+	// Each stage offers two incomparable paths of two edges. Both arrive at the stage node in the same
+	// iteration, so that one epsilon-dominates and discards the other. With a tolerance of epsilon per
+	// discard, the second weight of the kept labels would grow by a factor of (1+epsilon) per stage.
+	const double epsilon = 0.5;
+	const unsigned int stages = 6;
+	Graph graph;
+	for (unsigned int i = 0; i < 2 + 3*stages; ++i) {
+		graph.addNode();
+	}
+	graph.addEdge(NodeID(0), Edge(NodeID(1), Edge::edge_data(64, 64)));
+	Label::weight_type second_weight = 64;
+	for (unsigned int i = 0; i < stages; ++i) {
+		const NodeID stage(1 + 3*i);
+		graph.addEdge(stage, Edge(NodeID(stage+1), Edge::edge_data(32, 0)));
+		graph.addEdge(stage, Edge(NodeID(stage+2), Edge::edge_data(0, second_weight/2)));
+		graph.addEdge(NodeID(stage+1), Edge(NodeID(stage+3), Edge::edge_data(0, 0)));
+		graph.addEdge(NodeID(stage+2), Edge(NodeID(stage+3), Edge::edge_data(0, 0)));
+		second_weight += second_weight/2;
+	}
+	graph.finalize();
+
+	SharedHeapLabelSettingAlgorithm exact(graph);
+	exact.run(NodeID(0));
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS> algo1(graph, my_default_thread_count);
+		ParetoSearch<VECTOR_LS> algo2(graph, my_default_thread_count);
+	#else 
+		ParetoSearch<VECTOR_LS, VECTOR_PQ> algo1(graph);
+		ParetoSearch<VECTOR_LS> algo2(graph);
+	#endif
+	// Certified for the longest path, and with the default bound on the number of hops
+	algo1.setEpsilon(epsilon, 1 + 2*stages);
+	algo2.setEpsilon(epsilon);
+	algo1.run(NodeID(0));
+	algo2.run(NodeID(0));
+	assertRealLabels(graph, exact, algo1);
+	assertRealLabels(graph, exact, algo2);
+	FORALL_NODES(graph, node) {
+		assertApproximatedLabels(node, exact, algo1, epsilon);
+		assertApproximatedLabels(node, exact, algo2, epsilon);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateResourceConstrainedShortestPathSearch) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.4);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS> algo2(graph, my_default_thread_count);
+		ParetoSearch<BTREE_LS> algo3(graph, my_default_thread_count);
+	#else 
+		ParetoSearch<VECTOR_LS, VECTOR_PQ> algo2(graph);
+		ParetoSearch<BTREE_LS> algo3(graph);
+	#endif
+
+	const NodeID target = NodeID(5050);
+	algo1.run(NodeID(0));
+	std::vector<Label> exact(algo1.begin(target), algo1.end(target));
+	BOOST_REQUIRE_GT(exact.size(), 2);
+
+	const Label& median = exact[exact.size()/2];
+	const Label constraints[] = {
+		Label(MAX_WEIGHT, MAX_WEIGHT), Label(MAX_WEIGHT, median.second_weight), Label(MAX_WEIGHT, median.second_weight-1),
+		Label(median.first_weight, median.second_weight), Label(exact.back().first_weight-1, MAX_WEIGHT), Label(0, 0)};
+	for (const Label& max_weights : constraints) {
+		Label expected, best2, best3;
+		const bool feasible = algo1.runConstrained(NodeID(0), target, max_weights, expected);
+		BOOST_REQUIRE_EQUAL(feasible, algo2.runConstrained(NodeID(0), target, max_weights, best2));
+		BOOST_REQUIRE_EQUAL(feasible, algo3.runConstrained(NodeID(0), target, max_weights, best3));
+		if (feasible) {
+			BOOST_REQUIRE_EQUAL(expected, best2);
+			BOOST_REQUIRE_EQUAL(expected, best3);
+			BOOST_REQUIRE(std::find(exact.begin(), exact.end(), best2) != exact.end());
+		}
+		algo1.reset();
+		algo2.reset();
+		algo3.reset();
+	}
+}
+
+#ifndef PARALLEL_BUILD
+BOOST_AUTO_TEST_CASE(crossValidateBidirectionalShortestPathSearch) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.4);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	BidirectionalParetoSearch<> algo2(graph);
+	ParetoSearch<VECTOR_LS, VECTOR_PQ> algo3(graph);
+	BidirectionalParetoSearch<VECTOR_LS, VECTOR_PQ> algo4(graph);
+
+	const NodeID sources[] = {NodeID(0), NodeID(4242)};
+	const NodeID targets[] = {NodeID(0), NodeID(1), NodeID(5050), NodeID(graph.numberOfNodes()-1)};
+	for (const NodeID source : sources) {
+		algo1.run(source);
+		for (const NodeID target : targets) {
+			algo2.run(source, target);
+			BOOST_REQUIRE_EQUAL(algo1.size(target), algo2.size(target));
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo2.begin(target), algo2.end(target));
+			algo4.run(source, target);
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo4.begin(target), algo4.end(target));
+
+			// explores no more labels than the unidirectional goal-directed search
+			algo3.runGoalDirected(source, target);
+			size_t unidirectional_labels = 0;
+			FORALL_NODES(graph, node) {
+				unidirectional_labels += algo3.size(node);
+			}
+			BOOST_REQUIRE_LE(algo2.exploredLabels(), unidirectional_labels + 1);
+			algo2.reset();
+			algo3.reset();
+			algo4.reset();
+		}
+		algo1.reset();
+	}
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(crossValidateContractionHierarchyShortestPathSearch) {
+	for (const double correlation : {0.4, -0.4}) {
+		Graph graph;
+		GraphGenerator<Graph> generator;
+		generator.generateRandomGridGraphWithCostCorrleation(graph, 40, 40, correlation);
+
+		SharedHeapLabelSettingAlgorithm algo1(graph);
+		// default parameters, an early core and witness searches that give up early
+		ContractionHierarchy hierarchy1(graph);
+		ContractionHierarchy hierarchy2(graph, 5);
+		ContractionHierarchy hierarchy3(graph, 24, 2);
+		BOOST_REQUIRE(hierarchy1.coreSize() < hierarchy2.coreSize());
+		ContractionHierarchyQuery<LabelSettingAlgorithm> algo2(hierarchy1);
+		ContractionHierarchyQuery<LabelSettingAlgorithm> algo3(hierarchy2);
+		ContractionHierarchyQuery<LabelSettingAlgorithm> algo4(hierarchy3);
+
+		const NodeID sources[] = {NodeID(0), NodeID(777)};
+		const NodeID targets[] = {NodeID(0), NodeID(1), NodeID(820), NodeID(graph.numberOfNodes()-1)};
+		for (const NodeID source : sources) {
+			algo1.run(source);
+			for (const NodeID target : targets) {
+				algo2.run(source, target);
+				BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo2.begin(target), algo2.end(target));
+				algo3.run(source, target);
+				BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo3.begin(target), algo3.end(target));
+				algo4.run(source, target);
+				BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo4.begin(target), algo4.end(target));
+				algo2.reset();
+				algo3.reset();
+				algo4.reset();
+			}
+			algo1.reset();
+		}
+	}
+}
+
+/** Grid whose links are subdivided into chains, with dead-end trees, one-way links and parallel paths */
+void createChainGraph(Graph& graph) {
+	Graph grid;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(grid, 15, 15, -0.4);
+
+	unsigned int seed = 42;
+	auto random = [&seed](const unsigned int max) { seed = seed * 1103515245 + 12345; return (seed >> 16) % max; };
+	auto weight = [&random]() { return Edge::edge_data(1 + random(5), 1 + random(5)); };
+	std::vector<std::vector<Edge>> edges(grid.numberOfNodes());
+	auto link = [&edges, &random, &weight](const NodeID from, const NodeID to) {
+		edges[from].push_back(Edge(to, weight()));
+		if (random(8) != 0) {
+			edges[to].push_back(Edge(from, weight()));
+		}
+	};
+	FORALL_NODES(grid, node) {
+		FORALL_EDGES(grid, node, eid) {
+			const NodeID target = grid.getEdge(eid).target;
+			if (target < node) {
+				continue; // subdivide each link once
+			}
+			const unsigned int length = random(4);
+			NodeID previous = node;
+			for (unsigned int i = 0; i < length; ++i) {
+				edges.emplace_back();
+				link(previous, NodeID(edges.size()-1));
+				previous = NodeID(edges.size()-1);
+			}
+			link(previous, target);
+			if (length > 0 && random(10) == 0) {
+				edges[node].push_back(Edge(target, Edge::edge_data(1, 50))); // incomparable to the chain
+			}
+		}
+		if (node % 7 == 0) {
+			const NodeID root = NodeID(edges.size());
+			edges.resize(edges.size() + 3);
+			link(node, root);
+			link(root, root+1);
+			link(root, root+2);
+		}
+	}
+	for (size_t node = 0; node < edges.size(); ++node) {
+		graph.addNode();
+		for (const Edge& edge : edges[node]) {
+			graph.addEdge(NodeID(node), edge);
+		}
+	}
+	graph.finalize();
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateCompressedGraphShortestPathSearch) {
+	Graph graph;
+	createChainGraph(graph);
+	GraphCompression compression(graph);
+	BOOST_REQUIRE(compression.removedNodes() > graph.numberOfNodes() / 2);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	#ifdef PARALLEL_BUILD
+		CompressedGraphQuery<ParetoSearch<VECTOR_LS>> algo2(compression, my_default_thread_count);
+	#else
+		CompressedGraphQuery<ParetoSearch<VECTOR_LS, VECTOR_PQ>> algo2(compression);
+	#endif
+	for (NodeID source = NodeID(0); source < graph.numberOfNodes(); source += 97) {
+		algo1.run(source);
+		std::vector<NodeID> targets = {source, NodeID(source+1), NodeID(source+2)}; // often within the same chain or tree
+		for (NodeID target = NodeID(3); target < graph.numberOfNodes(); target += 89) {
+			targets.push_back(target);
+		}
+		for (const NodeID target : targets) {
+			if (target >= graph.numberOfNodes()) {
+				continue;
+			}
+			algo2.run(source, target);
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo2.begin(target), algo2.end(target));
+			if (source != target) {
+				assertValidPaths(graph, algo2, source, target, std::vector<Label>(algo2.begin(target), algo2.end(target)));
+			}
+			algo2.reset();
+		}
+		algo1.reset();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testCheckWeightRange) {
+	std::ostringstream warnings;
+	Graph graph;
+	for (unsigned int i = 0; i < 3; ++i) {
+		graph.addNode();
+	}
+	// Only the largest outgoing edge of each node counts
+	graph.addEdge(NodeID(0), Edge(NodeID(1), Edge::edge_data(MAX_WEIGHT/4, 1)));
+	graph.addEdge(NodeID(0), Edge(NodeID(2), Edge::edge_data(MAX_WEIGHT/2, 1)));
+	graph.addEdge(NodeID(1), Edge(NodeID(2), Edge::edge_data(MAX_WEIGHT/4, 1)));
+	graph.finalize();
+	BOOST_REQUIRE(checkWeightRange(graph, warnings));
+	BOOST_REQUIRE(warnings.str().empty());
+
+	Graph heavy;
+	for (unsigned int i = 0; i < 3; ++i) {
+		heavy.addNode();
+	}
+	heavy.addEdge(NodeID(0), Edge(NodeID(1), Edge::edge_data(1, MAX_WEIGHT/2 + 1)));
+	heavy.addEdge(NodeID(1), Edge(NodeID(2), Edge::edge_data(1, MAX_WEIGHT/2 + 1)));
+	heavy.finalize();
+	BOOST_REQUIRE(!checkWeightRange(heavy, warnings));
+	BOOST_REQUIRE(!warnings.str().empty());
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateRegisteredAlgorithms) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 50, 50, -0.4);
+	const NodeID target = NodeID(1275);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	BOOST_REQUIRE(AlgorithmRegistry::find("unknown") == nullptr);
+	for (const AlgorithmRegistry::Variant& variant : AlgorithmRegistry::variants()) {
+		BOOST_TEST_MESSAGE("Algorithm " << variant.name);
+		std::unique_ptr<ShortestPathEngine> algo2 = AlgorithmRegistry::create(variant.name, graph);
+		BOOST_REQUIRE(algo2);
+
+		algo2->run(NodeID(0));
+		std::vector<Label> labels;
+		FORALL_NODES(graph, node) {
+			BOOST_REQUIRE_EQUAL(algo1.size(node), algo2->size(node));
+			if (algo2->iterable()) {
+				labels.clear();
+				algo2->labels(node, labels);
+				BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(node), algo1.end(node), labels.begin(), labels.end());
+			}
+		}
+		algo2->reset();
+
+		algo2->runGoalDirected(NodeID(0), target);
+		BOOST_REQUIRE_EQUAL(algo1.size(target), algo2->size(target));
+		if (algo2->iterable()) {
+			labels.clear();
+			algo2->labels(target, labels);
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), labels.begin(), labels.end());
+		}
+	}
+}
+
+/** Road-like graph: Every edge becomes a chain of three copies via two nodes of out-degree one */
+void createChainGraph(const Graph& graph, Graph& chains) {
+	std::vector<std::pair<NodeID, Edge>> edges;
+	NodeID next = NodeID(graph.numberOfNodes());
+	FORALL_NODES(graph, node) {
+		FORALL_EDGES(graph, node, eid) {
+			const Edge& edge = graph.getEdge(eid);
+			const Edge::edge_data weights(edge.first_weight, edge.second_weight);
+			edges.push_back(std::make_pair(node, Edge(next, weights)));
+			edges.push_back(std::make_pair(next, Edge(NodeID(next+1), weights)));
+			edges.push_back(std::make_pair(NodeID(next+1), Edge(edge.target, weights)));
+			next = NodeID(next+2);
+		}
+	}
+	GraphGenerator<Graph> generator;
+	generator.buildGraphFromEdges(chains, edges);
+}
+
+BOOST_AUTO_TEST_CASE(testAlgorithmSelector) {
+	GraphGenerator<Graph> generator;
+	Graph correlated;
+	generator.generateRandomGridGraphWithCostCorrleation(correlated, 30, 30, 0.9);
+	AlgorithmSelector selector1(correlated, 8);
+	BOOST_REQUIRE_EQUAL(selector1.features().nodes, 900);
+	BOOST_REQUIRE_EQUAL(selector1.features().max_degree, 4);
+	BOOST_REQUIRE(selector1.features().weight_correlation > SELECTOR_CLASSIC_CORRELATION);
+	BOOST_REQUIRE_EQUAL(selector1.select(NodeID(0)).variant->name, "sharedheap");
+
+	Graph small;
+	generator.generateRandomGridGraphWithCostCorrleation(small, 10, 10, -0.8);
+	AlgorithmSelector selector2(small, 8);
+	BOOST_REQUIRE(selector2.features().weight_correlation < 0);
+	const AlgorithmSelection selection2 = selector2.select(NodeID(0));
+	BOOST_REQUIRE(selection2.probe.exhausted);
+	BOOST_REQUIRE_EQUAL(selection2.probe.reached_nodes, 100);
+	BOOST_REQUIRE_EQUAL(selection2.variant->name, "sharedheap");
+
+	// Large uncorrelated instance: worth to parallelize, but not for a single thread
+	Graph graph;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.8);
+	const NodeID target = NodeID(5050);
+	AlgorithmSelector selector3(graph, 8);
+	const AlgorithmSelection selection3 = selector3.select(NodeID(0));
+	BOOST_REQUIRE(!selection3.probe.exhausted);
+	#ifdef PARALLEL_BUILD
+		BOOST_REQUIRE_EQUAL(selection3.variant->name, "pareto-vector");
+		BOOST_REQUIRE_EQUAL(selection3.num_threads, 8);
+	#else
+		BOOST_REQUIRE_EQUAL(selection3.variant->name, "sharedheap"); // never parallel
+	#endif
+	BOOST_REQUIRE_EQUAL(AlgorithmSelector(graph, 1).select(NodeID(0)).variant->name, "sharedheap");
+
+	// The same instance with chains instead of edges: hardly any work per iteration to parallelize
+	Graph chains;
+	createChainGraph(graph, chains);
+	AlgorithmSelector selector4(chains, 8);
+	BOOST_REQUIRE_GT(selector4.features().degreeShare(2), 0.8);
+	const AlgorithmSelection selection4 = selector4.select(NodeID(0));
+	BOOST_REQUIRE(!selection4.probe.exhausted);
+	BOOST_REQUIRE_EQUAL(selection4.variant->name, "sharedheap");
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+	std::unique_ptr<ShortestPathEngine> algo2 = AlgorithmSelector(graph, my_default_thread_count).select(NodeID(0)).create(graph);
+	algo2->runGoalDirected(NodeID(0), target);
+	std::vector<Label> labels;
+	algo2->labels(target, labels);
+	BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), labels.begin(), labels.end());
+}
+
+/** Copy of the bi-criteria graph where each edge gains D-2 further random criteria */
+template<unsigned short D>
+void createMultiCriteriaGraph(const Graph& graph, MultiCriteriaGraph<D>& multi_graph, const unsigned int max_cost = 10) {
+	typedef typename MultiCriteriaGraph<D>::Edge MultiEdge;
+	std::vector<std::pair<NodeID, MultiEdge>> edges;
+	unsigned int seed = 42;
+	FORALL_NODES(graph, node) {
+		FORALL_EDGES(graph, node, eid) {
+			const Edge& edge = graph.getEdge(eid);
+			std::array<typename MultiEdge::edge_data::weight_type, D> weights;
+			weights[0] = edge.first_weight;
+			weights[1] = edge.second_weight;
+			for (unsigned short i = 2; i < D; ++i) {
+				seed = seed * 1103515245 + 12345;
+				weights[i] = 1 + (seed >> 16) % max_cost;
+			}
+			edges.push_back(std::make_pair(node, MultiEdge(edge.target, typename MultiEdge::edge_data(weights))));
+		}
+	}
+	GraphGenerator<MultiCriteriaGraph<D>> generator;
+	generator.buildGraphFromEdges(multi_graph, edges);
+}
+
+/** Textbook label correcting search with a FIFO queue and unsorted label sets */
+template<unsigned short D>
+std::vector<std::vector<MultiCriteriaLabel<D>>> naiveMultiCriteriaSearch(const MultiCriteriaGraph<D>& graph, const NodeID source) {
+	typedef MultiCriteriaLabel<D> L;
+	std::vector<std::vector<L>> labels(graph.numberOfNodes());
+	std::deque<std::pair<NodeID, L>> queue;
+	labels[source].push_back(L());
+	queue.push_back(std::make_pair(source, L()));
+	while (!queue.empty()) {
+		const std::pair<NodeID, L> current = queue.front();
+		queue.pop_front();
+		auto& current_labels = labels[current.first];
+		if (std::find(current_labels.begin(), current_labels.end(), current.second) == current_labels.end()) {
+			continue; // dominated in the meantime
+		}
+		FORALL_EDGES(graph, current.first, eid) {
+			const auto& edge = graph.getEdge(eid);
+			const L label = CriteriaTraits<D>::extended(current.second, edge);
+			auto& target_labels = labels[edge.target];
+			if (std::any_of(target_labels.begin(), target_labels.end(), [&label](const L& l) { return CriteriaTraits<D>::dominates(l, label); })) {
+				continue;
+			}
+			target_labels.erase(std::remove_if(target_labels.begin(), target_labels.end(), [&label](const L& l) { 
+				return CriteriaTraits<D>::dominates(label, l); }), target_labels.end());
+			target_labels.push_back(label);
+			queue.push_back(std::make_pair(edge.target, label));
+		}
+	}
+	for (auto& node_labels : labels) {
+		std::sort(node_labels.begin(), node_labels.end(), GroupMultiCriteriaLabelsByWeightComperator<D>());
+	}
+	return labels;
+}
+
+static MultiCriteriaLabel<3> label3(const Label::weight_type a, const Label::weight_type b, const Label::weight_type c) {
+	return MultiCriteriaLabel<3>(std::array<Label::weight_type, 3>{{a, b, c}});
+}
+
+BOOST_AUTO_TEST_CASE(testSkylineLabelSet) {
+	typedef MultiCriteriaLabel<3> L;
+	SkylineLabelSet<3> set;
+	std::vector<L> removed;
+
+	BOOST_REQUIRE(set.add(label3(5, 5, 5), removed));
+	BOOST_REQUIRE(!set.add(label3(5, 5, 5), removed));
+	BOOST_REQUIRE(!set.add(label3(6, 5, 5), removed));
+	BOOST_REQUIRE(set.add(label3(6, 4, 9), removed));
+	BOOST_REQUIRE(set.add(label3(7, 9, 1), removed));
+	BOOST_REQUIRE(set.add(label3(1, 9, 9), removed));
+	BOOST_REQUIRE(removed.empty());
+	BOOST_REQUIRE_EQUAL(set.size(), 4);
+
+	// dominates (6,4,9) and (7,9,1), but not (5,5,5) and (1,9,9)
+	BOOST_REQUIRE(set.add(label3(6, 4, 1), removed));
+	BOOST_REQUIRE_EQUAL(removed.size(), 2);
+	BOOST_REQUIRE_EQUAL(removed[0], label3(6, 4, 9));
+	BOOST_REQUIRE_EQUAL(removed[1], label3(7, 9, 1));
+	BOOST_REQUIRE_EQUAL(set.size(), 3);
+	BOOST_REQUIRE(set.dominates(label3(6, 5, 2)));
+	BOOST_REQUIRE(!set.dominates(label3(4, 9, 8)));
+	BOOST_REQUIRE(std::is_sorted(set.begin(), set.end(), GroupMultiCriteriaLabelsByWeightComperator<3>()));
+}
+
+BOOST_AUTO_TEST_CASE(testSkylineLabelSet_Large) {
+	// Labels close to the plane w1 + w2 + w3 = 3000 form large skylines
+	typedef MultiCriteriaLabel<3> L;
+	typedef CriteriaTraits<3> Dominance;
+	SkylineLabelSet<3> set;
+	std::vector<L> expected;
+	std::vector<L> removed;
+	unsigned int seed = 42;
+	auto random = [&seed](const unsigned int max) { seed = seed * 1103515245 + 12345; return (seed >> 8) % max; };
+
+	for (unsigned int round = 0; round < 2; ++round) {
+		size_t removed_count = 0;
+		for (unsigned int i = 0; i < 20000; ++i) {
+			const Label::weight_type a = random(1500);
+			const Label::weight_type b = random(1500);
+			const L label = label3(a, b, 3000 - a - b + random(100));
+			const bool dominated = std::any_of(expected.begin(), expected.end(), [&label](const L& l) {
+				return Dominance::dominates(l, label); });
+			BOOST_REQUIRE_EQUAL(set.dominates(label), dominated);
+			BOOST_REQUIRE_EQUAL(set.add(label, removed), !dominated);
+			if (dominated) {
+				continue;
+			}
+			const auto dominated_end = std::stable_partition(expected.begin(), expected.end(), [&label](const L& l) {
+				return !Dominance::dominates(label, l); });
+			std::sort(dominated_end, expected.end(), GroupMultiCriteriaLabelsByWeightComperator<3>());
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(removed.begin(), removed.end(), dominated_end, expected.end());
+			removed_count += removed.size();
+			removed.clear();
+			expected.erase(dominated_end, expected.end());
+			expected.push_back(label);
+			BOOST_REQUIRE_EQUAL(set.size(), expected.size());
+
+			if (i % 4096 == 0) {
+				std::sort(expected.begin(), expected.end(), GroupMultiCriteriaLabelsByWeightComperator<3>());
+				BOOST_REQUIRE_EQUAL_COLLECTIONS(set.begin(), set.end(), expected.begin(), expected.end());
+			}
+		}
+		BOOST_REQUIRE_GT(set.size(), 1000);
+		BOOST_REQUIRE_GT(removed_count, 1000);
+		std::sort(expected.begin(), expected.end(), GroupMultiCriteriaLabelsByWeightComperator<3>());
+		BOOST_REQUIRE_EQUAL_COLLECTIONS(set.begin(), set.end(), expected.begin(), expected.end());
+
+		set.reset();
+		expected.clear();
+		BOOST_REQUIRE_EQUAL(set.size(), 0);
+		BOOST_REQUIRE(!set.dominates(label3(MAX_WEIGHT, MAX_WEIGHT, MAX_WEIGHT)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testParetoMinimaFilter_ThreeCriteria) {
+	ParetoMinimaFilter<3> minima;
+	BOOST_REQUIRE(!minima.isDominated(label3(1, 5, 5)));
+	minima.add(label3(1, 5, 5));
+	minima.add(label3(2, 7, 2));
+	minima.add(label3(3, 2, 8));
+	BOOST_REQUIRE(!minima.isDominated(label3(1, 5, 5))); // equal weights
+	BOOST_REQUIRE(minima.isDominated(label3(4, 5, 5)));
+	BOOST_REQUIRE(minima.isDominated(label3(4, 6, 6)));
+	BOOST_REQUIRE(minima.isDominated(label3(4, 9, 2)));
+	BOOST_REQUIRE(!minima.isDominated(label3(4, 4, 6)));
+	BOOST_REQUIRE(!minima.isDominated(label3(4, 9, 1)));
+
+	// replaces the steps (1,5,5) and (2,7,2)
+	minima.add(label3(4, 4, 2));
+	minima.add(label3(4, 4, 2));
+	BOOST_REQUIRE(!minima.isDominated(label3(4, 4, 2)));
+	BOOST_REQUIRE(minima.isDominated(label3(5, 4, 2)));
+	BOOST_REQUIRE(minima.isDominated(label3(5, 3, 8)));
+	BOOST_REQUIRE(!minima.isDominated(label3(5, 3, 7)));
+
+	minima.clear();
+	BOOST_REQUIRE(!minima.isDominated(label3(5, 4, 2)));
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateMultiCriteriaShortestPathSearch_TwoCriteria) {
+	static_assert(std::is_same<MultiCriteriaLabel<2>, Label>::value, "bi-criteria labels are specialized");
+	static_assert(std::is_same<MultiCriteriaGraph<2>, Graph>::value, "bi-criteria graphs are specialized");
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 60, 60, -0.4);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+	#ifdef PARALLEL_BUILD
+		MultiCriteriaParetoSearch<2> algo2(graph, my_default_thread_count);
+	#else
+		MultiCriteriaParetoSearch<2> algo2(graph);
+	#endif
+	algo2.run(NodeID(0));
+	SkylineParetoSearch<2, Graph> algo3(graph); // the generic search on the bi-criteria types
+	algo3.run(NodeID(0));
+
+	FORALL_NODES(graph, node) {
+		BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(node), algo1.end(node), algo2.begin(node), algo2.end(node));
+		BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(node), algo1.end(node), algo3.begin(node), algo3.end(node));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateMultiCriteriaShortestPathSearch_ThreeCriteria) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 12, 12, -0.4);
+	MultiCriteriaGraph<3> multi_graph;
+	createMultiCriteriaGraph<3>(graph, multi_graph);
+
+	const auto expected = naiveMultiCriteriaSearch<3>(multi_graph, NodeID(0));
+	MultiCriteriaParetoSearch<3> algo(multi_graph);
+	for (unsigned int round = 0; round < 2; ++round) {
+		algo.run(NodeID(0));
+		FORALL_NODES(multi_graph, node) {
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(expected[node].begin(), expected[node].end(), algo.begin(node), algo.end(node));
+		}
+		algo.reset();
+	}
+	const NodeID target = NodeID(multi_graph.numberOfNodes()-1);
+	algo.run(NodeID(0), target);
+	BOOST_REQUIRE_GT(algo.size(target), 1);
+	BOOST_REQUIRE_EQUAL_COLLECTIONS(expected[target].begin(), expected[target].end(), algo.begin(target), algo.end(target));
+}
+
+BOOST_AUTO_TEST_CASE(testParetoSearch_UnpackPaths) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 60, 60, -0.4);
+	const NodeID source = NodeID(42);
+	const NodeID target = NodeID(graph.numberOfNodes()-1);
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS> algo1(graph, my_default_thread_count);
+		ParetoSearch<BTREE_LS> algo2(graph, my_default_thread_count);
+	#else 
+		ParetoSearch<VECTOR_LS, VECTOR_PQ> algo1(graph);
+		ParetoSearch<BTREE_LS> algo2(graph);
+	#endif
+	algo1.run(source);
+	const std::vector<Label> target_labels(algo1.begin(target), algo1.end(target));
+	BOOST_REQUIRE(target_labels.size() > 1);
+	assertValidPaths(graph, algo1, source, target, target_labels);
+
+	algo2.runGoalDirected(source, target);
+	assertValidPaths(graph, algo2, source, target, target_labels);
+}
+
+BOOST_AUTO_TEST_CASE(testParetoSearch_UnpackPathsAcrossZeroWeightCycle) {
+	// nodes 1 and 2 form a zero weight cycle. Node 2 is the first parent probed for node 1.
+	Graph graph;
+	for (unsigned int i = 0; i < 4; ++i) {
+		graph.addNode();
+	}
+	graph.addEdge(NodeID(1), Edge(NodeID(2), Edge::edge_data(0,0)));
+	graph.addEdge(NodeID(2), Edge(NodeID(1), Edge::edge_data(0,0)));
+	graph.addEdge(NodeID(2), Edge(NodeID(0), Edge::edge_data(1,2)));
+	graph.addEdge(NodeID(3), Edge(NodeID(1), Edge::edge_data(2,1)));
+	graph.finalize();
+	const NodeID source = NodeID(3);
+	const NodeID target = NodeID(0);
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS> algo(graph, my_default_thread_count);
+	#else
+		ParetoSearch<VECTOR_LS, VECTOR_PQ> algo(graph);
+	#endif
+	algo.run(source);
+	const std::vector<Label> target_labels(algo.begin(target), algo.end(target));
+	BOOST_REQUIRE_EQUAL(target_labels.size(), 1);
+	assertValidPaths(graph, algo, source, target, target_labels);
+
+	std::vector<NodeID> path;
+	BOOST_REQUIRE(algo.unpackPath(target, target_labels[0], path));
+	const NodeID expected[] = {NodeID(3), NodeID(1), NodeID(2), NodeID(0)};
+	BOOST_REQUIRE_EQUAL_COLLECTIONS(path.begin(), path.end(), std::begin(expected), std::end(expected));
+}
+
+#ifdef PARALLEL_BUILD
+BOOST_AUTO_TEST_CASE(crossValidateBatchShortestPathSearch) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 60, 60, -0.4);
+
+	std::vector<std::pair<NodeID, NodeID>> queries;
+	for (unsigned int i = 0; i < 16; ++i) {
+		queries.emplace_back(NodeID((i * 977) % graph.numberOfNodes()), NodeID((i * 1931 + 7) % graph.numberOfNodes()));
+	}
+	std::vector<std::vector<Label>> batch_results(queries.size());
+	auto query = [&queries, &batch_results](ParetoSearchBatch<VECTOR_LS>::Search& search, const size_t i) {
+		search.run(queries[i].first, queries[i].second);
+		batch_results[i].assign(search.begin(queries[i].second), search.end(queries[i].second));
+	};
+	for (unsigned short arenas : {0, 1, 3, 16}) { // 0: calibrated split
+		ParetoSearchBatch<VECTOR_LS> batch(graph, my_default_thread_count, arenas);
+		batch.run(queries.size(), query);
+		BOOST_REQUIRE_GE(batch.arenaCount(queries.size()), 1);
+		BOOST_REQUIRE_LE(batch.arenaCount(queries.size()), my_default_thread_count);
+
+		for (size_t i = 0; i < queries.size(); ++i) {
+			SharedHeapLabelSettingAlgorithm algo(graph);
+			algo.run(queries[i].first);
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(algo.begin(queries[i].second), algo.end(queries[i].second), batch_results[i].begin(), batch_results[i].end());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(crossValidatePartitionedQueueShortestPathSearch) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.8);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	// Enough labels to rebalance the parts repeatedly
+	ParetoSearch<VECTOR_LS, ParallelPartitionedParetoQueue> algo2(graph, 4);
+	ParetoSearch<VECTOR_LS, ParallelPartitionedParetoQueue> algo3(graph, 4, /*use_worker_team*/true);
+	for (unsigned int round = 0; round < 2; ++round) {
+		algo2.run(NodeID(0));
+		algo3.run(NodeID(0));
+		assertEqualResult(graph, algo1, algo2);
+		assertEqualResult(graph, algo1, algo3);
+		algo2.reset();
+		algo3.reset();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(crossValidateWorkerTeamShortestPathSearch) {
+	Graph graph;
+	GraphGenerator<Graph> generator;
+	generator.generateRandomGridGraphWithCostCorrleation(graph, 100, 100, -0.4);
+
+	SharedHeapLabelSettingAlgorithm algo1(graph);
+	algo1.run(NodeID(0));
+
+	ParetoSearch<VECTOR_LS> algo2(graph, 4, /*use_worker_team*/true);
+	ParetoSearch<BTREE_LS> algo3(graph, 4, /*use_worker_team*/true);
+	for (unsigned int round = 0; round < 2; ++round) {
+		algo2.run(NodeID(0));
+		algo3.run(NodeID(0));
+		assertEqualResultCount(graph, algo1, algo2);
+		assertEqualResultCount(graph, algo1, algo3);
+		assertEqualResult(graph, algo1, algo2);
+		algo2.reset();
+		algo3.reset();
+	}
+
+	const NodeID target = NodeID(5050);
+	algo2.runGoalDirected(NodeID(0), target);
+	BOOST_REQUIRE_EQUAL_COLLECTIONS(algo1.begin(target), algo1.end(target), algo2.begin(target), algo2.end(target));
+}
+
+BOOST_AUTO_TEST_CASE(testTeamSort) {
+	worker_team team(4);
+	team_sort<unsigned int, std::less<unsigned int>> sort((std::less<unsigned int>()));
+	for (const size_t n : {10, 1000, 100000}) {
+		std::vector<unsigned int> data(n), buffer(n);
+		unsigned int seed = 42;
+		for (auto& x : data) {
+			seed = seed * 1103515245 + 12345;
+			x = (seed >> 16) % (n / 4 + 1); // with duplicates
+		}
+		std::vector<unsigned int> expected(data);
+		std::sort(expected.begin(), expected.end());
+
+		team.run([&](worker_team::worker& worker) {
+			sort(worker, data.data(), n, buffer.data(), 0);
+			worker.barrier();
+		});
+		BOOST_REQUIRE_EQUAL_COLLECTIONS(expected.begin(), expected.end(), data.begin(), data.end());
+	}
+}
+#endif
@@ -12,6 +12,8 @@
 #include "../Label.hpp"
 #include <iostream>
 #include <algorithm>
+#include <set>
+#include <tuple>
 
 #define BRANCHING_PARAMETER_B 8
 #define LEAF_PARAMETER_K 8 
@@ -108,6 +110,72 @@ void testParetoMinInInternalNode(ParetoQueue&& pq) {
 }
 
 
+/** Random lexicographically sorted leaf keys. Few distinct weights to get equal labels */
+static std::vector<NodeLabel> randomLeaf(const size_t n, const unsigned int max_weight) {
+	std::vector<NodeLabel> keys;
+	for (size_t i = 0; i < n; ++i) {
+		keys.push_back(NodeLabel(NodeID(rand() % 5), rand() % max_weight, rand() % max_weight));
+	}
+	std::sort(keys.begin(), keys.end(), GroupNodeLablesByWeightAndNodeComperator());
+	return keys;
+}
+
+BOOST_AUTO_TEST_CASE(testParetoMinimaScan) {
+	Graph empty_graph;
+	std::vector<NodeLabel> empty_candidates;
+	for (NodeID i = NodeID(0); i < 5; ++i) {
+		empty_graph.addNode();
+	}
+	empty_graph.finalize();
+
+	std::vector<Operation<NodeLabel>> minima;
+	std::vector<NodeLabel> expected;
+	aos_leaf_slots<NodeLabel, 300> aos_slots;
+	soa_leaf_slots<NodeLabel, 300> soa_slots;
+	for (size_t n = 0; n < 300; ++n) {
+		for (const unsigned int max_weight : {3u, 50u, 100000u}) {
+			// The prefix minimum stems from the keys before the leaf
+			const Label prefix_minima = n % 3 == 0 ? Label(0, std::numeric_limits<Label::weight_type>::max()) : Label(rand() % max_weight, rand() % max_weight);
+			std::vector<NodeLabel> keys = randomLeaf(n, max_weight);
+			keys.erase(std::remove_if(keys.begin(), keys.end(), [&](const NodeLabel& l) { return l.lexLess(prefix_minima); }), keys.end());
+
+			expected.clear();
+			const Label* min = &prefix_minima;
+			for (const NodeLabel& l : keys) {
+				if (l.second_weight < min->second_weight || (l.first_weight == min->first_weight && l.second_weight == min->second_weight)) {
+					expected.push_back(l);
+					min = &l;
+				}
+			}
+			// Pareto minima of the leaf on its own, as cached by the B-tree leaves
+			uint64_t staircase[(300 + 63) / 64] = {0};
+			const NodeLabel* local = NULL;
+			for (size_t i = 0; i < keys.size(); ++i) {
+				aos_slots.set(i, keys[i]);
+				soa_slots.set(i, keys[i]);
+				if (i == 0 || keys[i].second_weight < local->second_weight || (keys[i].first_weight == local->first_weight && keys[i].second_weight == local->second_weight)) {
+					staircase[i / 64] |= uint64_t(1) << (i % 64);
+					local = &keys[i];
+				}
+			}
+			for (const bool soa : {false, true}) for (const uint64_t* const cached : {(const uint64_t*) NULL, (const uint64_t*) staircase}) {
+				minima.clear();
+				if (soa) {
+					relaxLeafMinima<300>(soa_slots, keys.size(), cached, prefix_minima, minima, empty_candidates, empty_graph, NoLabelPruning());
+				} else {
+					relaxLeafMinima<300>(aos_slots, keys.size(), cached, prefix_minima, minima, empty_candidates, empty_graph, NoLabelPruning());
+				}
+				BOOST_REQUIRE_EQUAL(expected.size(), minima.size());
+				for (size_t i = 0; i < minima.size(); ++i) {
+					BOOST_REQUIRE(minima[i].type == Operation<NodeLabel>::DELETE);
+					BOOST_REQUIRE_EQUAL(expected[i], minima[i].data);
+					BOOST_REQUIRE_EQUAL(expected[i].node, minima[i].data.node);
+				}
+			}
+		}
+	}
+}
+
 #ifdef PARALLEL_BUILD
 
 	/**
@@ -135,4 +203,174 @@ void testParetoMinInInternalNode(ParetoQueue&& pq) {
 		testParetoMinInInternalNode(BTreeParetoQueue());
 	}
 
+	/** Leaves with separate weight arrays, independent of BTREE_SOA_LEAVES */
+	typedef BasicBTreeParetoQueue<btree_soa_traits<NodeLabel, Label>> SoABTreeParetoQueue;
+
+	BOOST_AUTO_TEST_CASE(testParetoMinInLeaf_SoABtree) {
+		testParetoMinInLeaf(SoABTreeParetoQueue());
+	}
+	BOOST_AUTO_TEST_CASE(testParetoMinInInternalNode_SoABtree) {
+		testParetoMinInInternalNode(SoABTreeParetoQueue());
+	}
+
+	/** Marking the minima in the leaves must yield the same queue contents as deleting them via DELETE updates */
+	template<typename BTreeQueue>
+	void testPositionalDeletion() {
+		// Each label is relaxed to itself, so that the candidates reveal the found minima
+		Graph graph;
+		for (int i = 0; i < 5; ++i) {
+			graph.addNode();
+			graph.addEdge(NodeID(i), Edge(NodeID(i), Edge::edge_data(0, 0)));
+		}
+		graph.finalize();
+
+		BTreeQueue positional;
+		BTreeQueue reference;
+		positional.setPositionalDeletion(true);
+		GroupOperationsByWeightAndNodeComperator<Operation<NodeLabel>> groupOpsByWeight;
+
+		std::vector<Operation<NodeLabel>> updates, reference_updates;
+		std::vector<NodeLabel> candidates, reference_candidates;
+		std::set<std::tuple<int, int, int>> used; // the B-tree does not support duplicate keys
+		srand(42);
+
+		for (int round = 0; round < 300 || !reference.empty(); ++round) {
+			if (!reference.empty()) {
+				const size_t minima_count = positional.findParetoMinima(updates, candidates, graph);
+				reference.findParetoMinima(reference_updates, reference_candidates, graph);
+
+				BOOST_REQUIRE(updates.empty());
+				BOOST_REQUIRE_EQUAL(minima_count, reference_updates.size());
+				BOOST_REQUIRE_EQUAL(candidates.size(), reference_candidates.size());
+				for (size_t i = 0; i < candidates.size(); ++i) {
+					BOOST_REQUIRE_EQUAL(candidates[i], reference_candidates[i]);
+					BOOST_REQUIRE_EQUAL(candidates[i].node, reference_candidates[i].node);
+				}
+			}
+			// Mix small batches with large ones (rebuilding the root) and drain the queue at the end
+			const size_t minima_count = reference_updates.size();
+			const int insertions = round >= 300 ? 0 : rand() % (round % 25 == 0 ? 2000 : 100);
+			for (int i = 0; i < insertions; ++i) {
+				const int node = rand() % 5, first_weight = rand() % 1000, second_weight = rand() % 1000;
+				if (!used.insert(std::make_tuple(node, first_weight, second_weight)).second) {
+					continue;
+				}
+				const Operation<NodeLabel> op = {Operation<NodeLabel>::INSERT, NodeLabel(NodeID(node), first_weight, second_weight)};
+				updates.push_back(op);
+				reference_updates.push_back(op);
+			}
+			std::sort(updates.begin(), updates.end(), groupOpsByWeight);
+			std::sort(reference_updates.begin()+minima_count, reference_updates.end(), groupOpsByWeight);
+			std::inplace_merge(reference_updates.begin(), reference_updates.begin()+minima_count, reference_updates.end(), groupOpsByWeight);
+
+			positional.applyUpdates(updates);
+			reference.applyUpdates(reference_updates);
+			BOOST_REQUIRE_EQUAL(positional.size(), reference.size());
+
+			updates.clear();
+			reference_updates.clear();
+			candidates.clear();
+			reference_candidates.clear();
+		}
+		BOOST_REQUIRE(positional.empty());
+	}
+
+	BOOST_AUTO_TEST_CASE(testPositionalDeletion_Btree) {
+		testPositionalDeletion<BTreeParetoQueue>();
+	}
+	BOOST_AUTO_TEST_CASE(testPositionalDeletion_SoABtree) {
+		testPositionalDeletion<SoABTreeParetoQueue>();
+	}
+
+	/** Queues extracting their minima in place have to find the same minima as the B-tree */
+	template<typename ParetoQueue>
+	void crossValidateInPlaceExtraction(ParetoQueue&& queue) {
+		Graph graph;
+		for (int i = 0; i < 5; ++i) {
+			graph.addNode();
+			graph.addEdge(NodeID(i), Edge(NodeID(i), Edge::edge_data(0, 0)));
+		}
+		graph.finalize();
+
+		BTreeParetoQueue reference;
+		GroupOperationsByWeightAndNodeComperator<Operation<NodeLabel>> groupOpsByWeight;
+
+		std::vector<Operation<NodeLabel>> updates, reference_updates;
+		std::vector<NodeLabel> candidates, reference_candidates;
+		std::set<std::tuple<int, int, int>> used; // the B-tree does not support duplicate keys
+		std::set<std::tuple<int, int, int>> present; // labels within the queues
+		srand(42);
+
+		int lowest = 0;
+		for (int round = 0; round < 300 || !reference.empty(); ++round) {
+			if (!reference.empty()) {
+				const size_t minima_count = queue.findParetoMinima(updates, candidates, graph);
+				reference.findParetoMinima(reference_updates, reference_candidates, graph);
+
+				BOOST_REQUIRE(updates.empty());
+				BOOST_REQUIRE_EQUAL(minima_count, reference_updates.size());
+				BOOST_REQUIRE_EQUAL(candidates.size(), reference_candidates.size());
+				for (size_t i = 0; i < candidates.size(); ++i) {
+					BOOST_REQUIRE_EQUAL(candidates[i], reference_candidates[i]);
+					BOOST_REQUIRE_EQUAL(candidates[i].node, reference_candidates[i].node);
+				}
+				for (const NodeLabel& minimum : candidates) {
+					present.erase(std::make_tuple((int) minimum.node, (int) minimum.first_weight, (int) minimum.second_weight));
+				}
+				lowest = candidates.front().first_weight;
+			}
+			const size_t minima_count = reference_updates.size();
+
+			// Like the labels of a search, new labels do not undercut the current minima. Wide
+			// rounds exceed the initial capacity of the bucket queue
+			const int spread = round % 50 == 0 ? 5000 : 300;
+			const int insertions = round >= 300 ? 0 : rand() % 100;
+			for (int i = 0; i < insertions; ++i) {
+				const int node = rand() % 5, first_weight = lowest + rand() % spread, second_weight = rand() % 1000;
+				if (!used.insert(std::make_tuple(node, first_weight, second_weight)).second) {
+					continue;
+				}
+				const Operation<NodeLabel> op = {Operation<NodeLabel>::INSERT, NodeLabel(NodeID(node), first_weight, second_weight)};
+				updates.push_back(op);
+				reference_updates.push_back(op);
+			}
+			// Delete some of the remaining labels, as done by the label sets
+			for (int i = 0; i < 10 && !present.empty(); ++i) {
+				auto it = present.begin();
+				std::advance(it, rand() % present.size());
+				const NodeLabel label(NodeID(std::get<0>(*it)), std::get<1>(*it), std::get<2>(*it));
+				const Operation<NodeLabel> op = {Operation<NodeLabel>::DELETE, label};
+				present.erase(it);
+				updates.push_back(op);
+				reference_updates.push_back(op);
+			}
+			std::sort(updates.begin(), updates.end(), groupOpsByWeight);
+			std::sort(reference_updates.begin()+minima_count, reference_updates.end(), groupOpsByWeight);
+			std::inplace_merge(reference_updates.begin(), reference_updates.begin()+minima_count, reference_updates.end(), groupOpsByWeight);
+
+			queue.applyUpdates(updates);
+			reference.applyUpdates(reference_updates);
+			BOOST_REQUIRE_EQUAL(queue.size(), reference.size());
+			for (const Operation<NodeLabel>& op : updates) {
+				if (op.type == Operation<NodeLabel>::INSERT) {
+					present.insert(std::make_tuple((int) op.data.node, (int) op.data.first_weight, (int) op.data.second_weight));
+				}
+			}
+
+			updates.clear();
+			reference_updates.clear();
+			candidates.clear();
+			reference_candidates.clear();
+		}
+		BOOST_REQUIRE(queue.empty());
+	}
+
+	/** Also covers the growth of the circular bucket array */
+	BOOST_AUTO_TEST_CASE(testBucketQueue) {
+		crossValidateInPlaceExtraction(BucketParetoQueue());
+	}
+	BOOST_AUTO_TEST_CASE(testPrioritySearchTreeQueue) {
+		crossValidateInPlaceExtraction(PSTParetoQueue());
+	}
+
 #endif
\ No newline at end of file
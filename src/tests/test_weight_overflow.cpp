@@ -0,0 +1,107 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE weight_overflow_tests
+#include <boost/test/auto_unit_test.hpp>
+
+// Narrow weights, so that short paths already exceed them. Unlike the other tests, this one keeps
+// NDEBUG: overflows have to be detected in release builds, too.
+#define WEIGHT_TYPE uint16_t
+
+#include <stdexcept>
+#include <vector>
+#include <sstream>
+#include "../BiCritShortestPathAlgorithm.hpp"
+#include "../GraphGenerator.hpp"
+#include "../msp_pareto/MultiCriteriaParetoSearch.hpp"
+
+#define BTREE_LS BtreeParetoLabelSet<std::allocator<Label>>
+#define VECTOR_LS VectorParetoLabelSet<std::allocator<Label>>
+#define VECTOR_PQ VectorParetoQueue
+
+/** Path 0 -> 1 -> 2 -> 3 whose weights only fit WEIGHT_TYPE up to node 2 */
+void createPath(Graph& graph, const Label::weight_type edge_weight) {
+	for (unsigned int i = 0; i < 4; ++i) {
+		graph.addNode();
+	}
+	graph.addEdge(NodeID(0), Edge(NodeID(1), Edge::edge_data(edge_weight, 1)));
+	graph.addEdge(NodeID(1), Edge(NodeID(2), Edge::edge_data(1, edge_weight)));
+	graph.addEdge(NodeID(2), Edge(NodeID(3), Edge::edge_data(edge_weight, edge_weight)));
+	graph.finalize();
+}
+
+BOOST_AUTO_TEST_CASE(testCheckedAdd) {
+	BOOST_REQUIRE_EQUAL(checkedAdd<Label::weight_type>(MAX_WEIGHT - 1, 1), MAX_WEIGHT);
+	BOOST_REQUIRE_THROW(checkedAdd<Label::weight_type>(MAX_WEIGHT, 1), std::overflow_error);
+	BOOST_REQUIRE_THROW(extended(Label(1, MAX_WEIGHT/2 + 1), Label(1, MAX_WEIGHT/2 + 1)), std::overflow_error);
+	BOOST_REQUIRE_EQUAL(extended(Label(1, MAX_WEIGHT/2), Label(1, MAX_WEIGHT/2 + 1)), Label(2, MAX_WEIGHT));
+}
+
+BOOST_AUTO_TEST_CASE(testWeightRange) {
+	Graph graph;
+	createPath(graph, MAX_WEIGHT/3);
+	BOOST_REQUIRE(checkWeightRange(graph));
+
+	Graph overflowing_graph;
+	createPath(overflowing_graph, MAX_WEIGHT/2 + 1);
+	std::ostringstream warning;
+	BOOST_REQUIRE(!checkWeightRange(overflowing_graph, warning));
+	BOOST_REQUIRE(!warning.str().empty());
+}
+
+template<class Algorithm>
+void testOverflowDetected(Algorithm&& algo) {
+	BOOST_REQUIRE_THROW(algo.run(NodeID(0)), std::overflow_error);
+}
+
+BOOST_AUTO_TEST_CASE(testSearchesDetectOverflows) {
+	Graph graph;
+	createPath(graph, MAX_WEIGHT/2 + 1);
+
+	testOverflowDetected(SharedHeapLabelSettingAlgorithm(graph));
+	testOverflowDetected(NodeHeapLabelSettingAlgorithm(graph));
+	#ifdef PARALLEL_BUILD
+		testOverflowDetected(ParetoSearch<VECTOR_LS>(graph, my_default_thread_count));
+		testOverflowDetected(ParetoSearch<BTREE_LS>(graph, my_default_thread_count));
+	#else
+		testOverflowDetected(ParetoSearch<VECTOR_LS, VECTOR_PQ>(graph));
+		testOverflowDetected(ParetoSearch<BTREE_LS>(graph));
+	#endif
+
+	// The backward Dijkstra searches of the lower bounds overflow, too
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<> algo(graph, my_default_thread_count);
+	#else
+		ParetoSearch<> algo(graph);
+	#endif
+	BOOST_REQUIRE_THROW(algo.runGoalDirected(NodeID(0), NodeID(3)), std::overflow_error);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiCriteriaSearchDetectsOverflows) {
+	typedef MultiCriteriaGraph<3>::Edge MultiEdge;
+	MultiCriteriaGraph<3> graph;
+	std::vector<std::pair<NodeID, MultiEdge>> edges;
+	const std::array<Label::weight_type, 3> weights = {{1, 1, MAX_WEIGHT/2 + 1}};
+	const std::array<Label::weight_type, 3> back_weights = {{1, 1, 1}};
+	edges.push_back(std::make_pair(NodeID(0), MultiEdge(NodeID(1), MultiEdge::edge_data(weights))));
+	edges.push_back(std::make_pair(NodeID(1), MultiEdge(NodeID(2), MultiEdge::edge_data(weights))));
+	edges.push_back(std::make_pair(NodeID(2), MultiEdge(NodeID(0), MultiEdge::edge_data(back_weights))));
+	GraphGenerator<MultiCriteriaGraph<3>> generator;
+	generator.buildGraphFromEdges(graph, edges);
+
+	MultiCriteriaParetoSearch<3> algo(graph);
+	BOOST_REQUIRE_THROW(algo.run(NodeID(0)), std::overflow_error);
+}
+
+BOOST_AUTO_TEST_CASE(testSearchWithinWeightRange) {
+	Graph graph;
+	createPath(graph, MAX_WEIGHT/3);
+
+	#ifdef PARALLEL_BUILD
+		ParetoSearch<VECTOR_LS> algo(graph, my_default_thread_count);
+	#else
+		ParetoSearch<VECTOR_LS, VECTOR_PQ> algo(graph);
+	#endif
+	algo.run(NodeID(0));
+	const Label::weight_type w = MAX_WEIGHT/3;
+	const std::vector<Label> expected = {Label(2*w + 1, 2*w + 1)};
+	BOOST_REQUIRE_EQUAL_COLLECTIONS(algo.begin(NodeID(3)), algo.end(NodeID(3)), expected.begin(), expected.end());
+}
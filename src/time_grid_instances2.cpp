@@ -17,7 +17,7 @@
 #define BATCH_SIZE 0 
 #endif
 
-void timeGrid(int num, int height, int width, bool verbose, int iterations, double q, int p, int max_costs, bool subcomponent_timings) {
+void timeGrid(int num, int height, int width, bool verbose, int iterations, double q, int p, int max_costs, double epsilon, bool subcomponent_timings) {
 	GraphGenerator<Graph> generator;
 	double timings[iterations];
 	double label_count[iterations];
@@ -28,6 +28,7 @@ void timeGrid(int num, int height, int width, bool verbose, int iterations, doub
 		generator.generateRandomGridGraphWithCostCorrleation(graph, height, width, q, max_costs);
 
 		LabelSettingAlgorithm algo(graph, p);
+		algo.setEpsilon(epsilon);
 
 		tbb::tick_count start = tbb::tick_count::now();
 		algo.run(NodeID(0));
@@ -58,11 +59,12 @@ int main(int argc, char ** args) {
 	double q = 0;
 	int p = tbb::task_scheduler_init::default_num_threads();
 	int max_costs = 10;
+	double epsilon = 0;
 	int n = 0;
 	bool subcomponent_timings = false;
 
 	int c;
-	while( (c = getopt( argc, args, "c:q:p:m:n:vs") ) != -1  ){
+	while( (c = getopt( argc, args, "c:q:p:m:n:e:vs") ) != -1  ){
 		switch(c){
 		case 'c':
 			iterations = atoi(optarg);
@@ -76,6 +78,9 @@ int main(int argc, char ** args) {
 		case 'm':
 			max_costs = atoi(optarg);
 			break;
+		case 'e':
+			epsilon = atof(optarg);
+			break;
 		case 'p':
 			p = atoi(optarg);
 			break;
@@ -108,27 +113,27 @@ int main(int argc, char ** args) {
 
 
 	if (n != 0) {
-		timeGrid(0, n, n, verbose, iterations, q, p, max_costs, subcomponent_timings);
+		timeGrid(0, n, n, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
 	} else {
-		timeGrid(1,  100, 100, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(2,  125, 125, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(3,  150, 150, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(4,  175, 175, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(5,  200, 200, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(6,  225, 225, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(7,  250, 250, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(8,  275, 275, verbose, iterations, q, p, max_costs, subcomponent_timings);
-		timeGrid(9,  300, 300, verbose, iterations, q, p, max_costs, subcomponent_timings);
+		timeGrid(1,  100, 100, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(2,  125, 125, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(3,  150, 150, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(4,  175, 175, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(5,  200, 200, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(6,  225, 225, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(7,  250, 250, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(8,  275, 275, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+		timeGrid(9,  300, 300, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
 		if (q > -0.4 || max_costs < 100) {
-			timeGrid(10,  325, 325, verbose, iterations, q, p, max_costs, subcomponent_timings);
-			timeGrid(11, 350, 350, verbose, iterations, q, p, max_costs, subcomponent_timings);
-			timeGrid(12, 375, 375, verbose, iterations, q, p, max_costs, subcomponent_timings);
-			timeGrid(13, 400, 400, verbose, iterations, q, p, max_costs, subcomponent_timings);
+			timeGrid(10,  325, 325, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+			timeGrid(11, 350, 350, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+			timeGrid(12, 375, 375, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+			timeGrid(13, 400, 400, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
 			if (q > 0.4 || max_costs < 100) {
-				timeGrid(14, 425, 425, verbose, iterations, q, p, max_costs, subcomponent_timings);
-				timeGrid(15, 450, 450, verbose, iterations, q, p, max_costs, subcomponent_timings);
-				timeGrid(16, 475, 475, verbose, iterations, q, p, max_costs, subcomponent_timings);
-				timeGrid(17, 500, 500, verbose, iterations, q, p, max_costs, subcomponent_timings);
+				timeGrid(14, 425, 425, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+				timeGrid(15, 450, 450, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+				timeGrid(16, 475, 475, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
+				timeGrid(17, 500, 500, verbose, iterations, q, p, max_costs, epsilon, subcomponent_timings);
 			}
 		}
 	}
@@ -0,0 +1,119 @@
+//#undef NDEBUG // uncomment to enable assertions
+
+/**
+ * Head-to-head comparison of the sequential ParetoQueue implementations on queues dominated
+ * by labels that are not pareto minima: Each iteration extracts the minima and inserts k random
+ * labels, whose first weights grow from iteration to iteration (as in the label setting algorithm).
+ */
+
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+#include <ostream>
+
+#include "tbb/tick_count.h"
+
+#include "msp_pareto/ParetoQueue_sequential.hpp"
+#include "Graph.hpp"
+
+#include "utility/timing.h"
+#include "utility/memory.h"
+#include "algorithm"
+#include "limits"
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+
+const unsigned int node_count = 1 << 16;
+const unsigned int max_weight = 1 << 20;
+
+boost::mt19937 gen;
+GroupOperationsByWeightAndNodeComperator<Operation<NodeLabel>> opCmp;
+
+/** Random labels with first weights in [lowest, lowest + max_weight) */
+void randomInsertions(std::vector<Operation<NodeLabel>>& updates, const size_t k, const Label::weight_type lowest) {
+	boost::uniform_int<unsigned int> node_dist(0, node_count-1);
+	boost::uniform_int<unsigned int> weight_dist(0, max_weight-1);
+	for (size_t j = 0; j < k; ++j) {
+		updates.emplace_back(Operation<NodeLabel>::INSERT, NodeID(node_dist(gen)), lowest + weight_dist(gen), weight_dist(gen));
+	}
+}
+
+template<typename ParetoQueue>
+void timeParetoQueue(const std::string& name, const Graph& graph, const size_t n, const size_t k, const size_t iterations) {
+	std::vector<double> timings(iterations);
+	std::vector<Operation<NodeLabel>> updates;
+	std::vector<NodeLabel> candidates;
+	size_t minima = 0;
+
+	gen.seed(42);
+	ParetoQueue pq;
+	pq.setPositionalDeletion(true);
+	randomInsertions(updates, n, 0);
+	std::sort(updates.begin(), updates.end(), opCmp);
+	pq.applyUpdates(updates);
+	updates.clear();
+
+	Label::weight_type lowest = 0;
+	for (size_t i = 0; i < iterations; ++i) {
+		tbb::tick_count start = tbb::tick_count::now();
+
+		const size_t minima_count = pq.findParetoMinima(updates, candidates, graph);
+		randomInsertions(updates, k, lowest);
+		std::sort(updates.begin(), updates.end(), opCmp);
+		pq.applyUpdates(updates);
+
+		tbb::tick_count stop = tbb::tick_count::now();
+		timings[i] = (stop-start).seconds() * 1000.0 * 1000.0;
+
+		minima += minima_count;
+		lowest += max_weight / iterations;
+		updates.clear();
+	}
+	std::cout << pruned_average(timings.data(), iterations, 0.25) << " " << getPeakMemorySize()/1024 << " " << n << " " << k
+		<< " " << minima / (double) iterations << " " << pq.size() << " " << name
+		<< " # time per iteration [µs], peak memory [mb], n, k, avg. minima, final size, queue" << std::endl;
+}
+
+int main(int argc, char ** args) {
+	size_t iterations = 100;
+	size_t n = 0;
+	size_t k = 1000;
+
+	int c;
+	while( (c = getopt( argc, args, "c:n:k:") ) != -1  ){
+		switch(c){
+		case 'c':
+			iterations = atoi(optarg);
+			break;
+		case 'n':
+			n = atoi(optarg);
+			break;
+		case 'k':
+			k = atoi(optarg);
+			break;
+		case '?':
+            std::cout << "Unrecognized option: " <<  optopt << std::endl;
+		}
+	}
+
+	// The labels are not relaxed, so a graph without edges suffices
+	Graph graph;
+	for (unsigned int i = 0; i < node_count; ++i) {
+		graph.addNode();
+	}
+	graph.finalize();
+
+	std::vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+	if (n != 0) {
+		sizes = {n};
+	}
+	for (const size_t size : sizes) {
+		timeParetoQueue<BTreeParetoQueue>("BTreeParetoQueue", graph, size, k, iterations);
+		timeParetoQueue<PSTParetoQueue>("PSTParetoQueue", graph, size, k, iterations);
+		if (size <= 100000 || n != 0) {
+			timeParetoQueue<VectorParetoQueue>("VectorParetoQueue", graph, size, k, iterations);
+		}
+	}
+	return 0;
+}
@@ -4,9 +4,14 @@
 #include <sstream>
 #include <algorithm>
 #include <utility>
+#include <numeric>
+#include <memory>
 
 #include "BiCritShortestPathAlgorithm.hpp"
+#include "AlgorithmSelector.hpp"
 #include "GraphGenerator.hpp"
+#include "msp_pareto/ContractionHierarchy.hpp"
+#include "msp_pareto/GraphCompression.hpp"
 
 #include "utility/timing.h"
 #include "utility/memory.h"
@@ -15,16 +20,23 @@
 #include "tbb/tick_count.h"
 
 
-static void time(const Graph& graph, NodeID start_node, NodeID end, int total_num, int num, std::string label, bool verbose, int iterations, int p) {
+static void time(const Graph& graph, NodeID start_node, NodeID end, int total_num, int num, std::string label, bool verbose, bool one_to_one, bool goal_directed, bool worker_team, double epsilon, int iterations, int p) {
 	double timings[iterations];
 	double label_count[iterations];
 	double memory[iterations];
 
 	for (int i = 0; i < iterations; ++i) {
-		LabelSettingAlgorithm algo(graph, p);
+		LabelSettingAlgorithm algo(graph, p, worker_team);
+		algo.setEpsilon(epsilon);
 
 		tbb::tick_count start = tbb::tick_count::now();
-		algo.run(start_node);
+		if (goal_directed) {
+			algo.runGoalDirected(start_node, end);
+		} else if (one_to_one) {
+			algo.run(start_node, end);
+		} else {
+			algo.run(start_node);
+		}
 		tbb::tick_count stop = tbb::tick_count::now();
 
 		timings[i] = (stop-start).seconds();
@@ -40,6 +52,130 @@ static void time(const Graph& graph, NodeID start_node, NodeID end, int total_nu
 		<< getPeakMemorySize()/1024 << " " << p << "  # time in [s], target node label count, memory [mb], peak memory [mb], p " << std::endl;
 }
 
+/** Same as time(), but using an algorithm variant selected at runtime */
+static void time_engine(const Graph& graph, const AlgorithmRegistry::Variant& variant, NodeID start_node, NodeID end, int total_num, int num, std::string label, bool verbose, bool one_to_one, bool goal_directed, bool worker_team, double epsilon, int iterations, int p) {
+	double timings[iterations];
+	double label_count[iterations];
+	double memory[iterations];
+
+	for (int i = 0; i < iterations; ++i) {
+		std::unique_ptr<ShortestPathEngine> algo(variant.create(graph, p, worker_team));
+		algo->setEpsilon(epsilon);
+
+		tbb::tick_count start = tbb::tick_count::now();
+		if (goal_directed) {
+			algo->runGoalDirected(start_node, end);
+		} else if (one_to_one) {
+			algo->run(start_node, end);
+		} else {
+			algo->run(start_node);
+		}
+		tbb::tick_count stop = tbb::tick_count::now();
+
+		timings[i] = (stop-start).seconds();
+		memory[i] = getCurrentMemorySize();
+
+		label_count[i] = algo->size(end);
+		if (verbose && i == 0) {
+			algo->printStatistics();
+		}
+	}
+	std::cout << total_num << " " << variant.name << ":" << label << num << " " << pruned_average(timings, iterations, 0) << " " 
+		<< pruned_average(label_count, iterations, 0) <<  " " << pruned_average(memory, iterations, 0)/1024 << " " 
+		<< getPeakMemorySize()/1024 << " " << p << "  # time in [s], target node label count, memory [mb], peak memory [mb], p " << std::endl;
+}
+
+/** Queries on a graph that has been preprocessed once (e.g., a ContractionHierarchy) */
+template<typename Query, typename Preprocessing>
+static void time_preprocessed(const Preprocessing& preprocessing, NodeID start_node, NodeID end, int total_num, int num, std::string label, bool verbose, bool worker_team, int iterations, int p) {
+	double timings[iterations];
+	double label_count[iterations];
+	double memory[iterations];
+
+	for (int i = 0; i < iterations; ++i) {
+		Query algo(preprocessing, p, worker_team);
+
+		tbb::tick_count start = tbb::tick_count::now();
+		algo.run(start_node, end);
+		tbb::tick_count stop = tbb::tick_count::now();
+
+		timings[i] = (stop-start).seconds();
+		memory[i] = getCurrentMemorySize();
+
+		label_count[i] = algo.size(end);
+		if (verbose && i == 0) {
+			algo.printStatistics();
+		}
+	}
+	std::cout << total_num << " " << label << num << " " << pruned_average(timings, iterations, 0) << " " 
+		<< pruned_average(label_count, iterations, 0) <<  " " << pruned_average(memory, iterations, 0)/1024 << " " 
+		<< getPeakMemorySize()/1024 << " " << p << "  # time in [s], target node label count, memory [mb], peak memory [mb], p " << std::endl;
+}
+
+#ifndef PARALLEL_BUILD
+static void time_bidirectional(const Graph& graph, NodeID start_node, NodeID end, int total_num, int num, std::string label, bool verbose, int iterations) {
+	double timings[iterations];
+	double label_count[iterations];
+	double memory[iterations];
+
+	for (int i = 0; i < iterations; ++i) {
+		BidirectionalParetoSearch<> algo(graph);
+
+		tbb::tick_count start = tbb::tick_count::now();
+		algo.run(start_node, end);
+		tbb::tick_count stop = tbb::tick_count::now();
+
+		timings[i] = (stop-start).seconds();
+		memory[i] = getCurrentMemorySize();
+
+		label_count[i] = algo.size(end);
+		if (verbose && i == 0) {
+			algo.printStatistics();
+			std::cout << "# Explored labels: " << algo.exploredLabels() << std::endl;
+		}
+	}
+	std::cout << total_num << " " << label << num << " " << pruned_average(timings, iterations, 0) << " " 
+		<< pruned_average(label_count, iterations, 0) <<  " " << pruned_average(memory, iterations, 0)/1024 << " " 
+		<< getPeakMemorySize()/1024 << " " << 0 << "  # time in [s], target node label count, memory [mb], peak memory [mb], p " << std::endl;
+}
+#endif
+
+#ifdef PARALLEL_BUILD
+static void time_batch(const Graph& graph, const std::vector<std::pair<NodeID, NodeID>>& queries, std::string label, bool one_to_one, bool goal_directed, double epsilon, int iterations, int p, int arenas) {
+	double timings[iterations];
+	std::vector<size_t> label_count(queries.size());
+	ParetoSearchBatch<> batch(graph, p, arenas);
+
+	const auto query = [&](ParetoSearchBatch<>::Search& algo, const size_t q) {
+		const NodeID start_node = queries[q].first;
+		algo.setEpsilon(epsilon);
+		const NodeID end = queries[q].second;
+		if (goal_directed) {
+			algo.runGoalDirected(start_node, end);
+		} else if (one_to_one) {
+			algo.run(start_node, end);
+		} else {
+			algo.run(start_node);
+		}
+		label_count[q] = algo.size(end);
+	};
+	if (arenas == 0) {
+		batch.calibrate(queries.size(), query); // not part of the timings
+	}
+
+	for (int i = 0; i < iterations; ++i) {
+		tbb::tick_count start = tbb::tick_count::now();
+		batch.run(queries.size(), query);
+		tbb::tick_count stop = tbb::tick_count::now();
+		timings[i] = (stop-start).seconds();
+	}
+	const double batch_time = pruned_average(timings, iterations, 0);
+	std::cout << label << " " << queries.size() << " " << batch_time << " " << queries.size() / batch_time << " " 
+		<< std::accumulate(label_count.begin(), label_count.end(), size_t(0)) << " " << getPeakMemorySize()/1024 << " " << p << " " 
+		<< batch.arenaCount(queries.size()) << "  # queries, time in [s], queries per second, total target node label count, peak memory [mb], p, concurrent queries" << std::endl;
+}
+#endif
+
 static void readGraphFromFile(Graph& graph, std::ifstream& in) {
 	std::string line;
 	char c_line[256];
@@ -67,14 +203,25 @@ static void readGraphFromFile(Graph& graph, std::ifstream& in) {
 	GraphGenerator<Graph> generator;
 	generator.buildGraphFromEdges(graph, edges);
 	std::cout << "# Nodes " << graph.numberOfNodes() <<  " Edges " << graph.numberOfEdges() << std::endl;
+	checkWeightRange(graph);
 }
 
 int main(int argc, char ** args) {
 	std::cout << "# " << currentConfig() << std::endl;
 	bool verbose = false;
+	bool one_to_one = false;
+	bool goal_directed = false;
+	bool worker_team = false;
+	bool bidirectional = false;
+	bool hierarchy = false;
+	bool compress = false;
+	double epsilon = 0;
+	int batch_arenas = -1; // no batch
 	int iterations = 1;
 	int total_instance = 1;
 	int p = tbb::task_scheduler_init::default_num_threads();
+	std::vector<const AlgorithmRegistry::Variant*> engines;
+	bool auto_select = false;
 
 	std::string graphname;
 	std::string directory;
@@ -82,7 +229,7 @@ int main(int argc, char ** args) {
 	std::ifstream problems_in;
 
 	int c;
-	while( (c = getopt( argc, args, "c:g:d:n:p:v") ) != -1  ){
+	while( (c = getopt( argc, args, "c:g:d:n:p:l:vtaixswb:e:") ) != -1  ){
 		switch(c){
 		case 'd':
 			directory = optarg;
@@ -102,6 +249,49 @@ int main(int argc, char ** args) {
 		case 'v':
 			verbose = true;
 			break;
+		case 't':
+			one_to_one = true;
+			break;
+		case 'a':
+			goal_directed = true;
+			break;
+		case 'i':
+			bidirectional = true;
+			break;
+		case 'x':
+			hierarchy = true;
+			break;
+		case 's':
+			compress = true;
+			break;
+		case 'w':
+			worker_team = true;
+			break;
+		case 'e':
+			epsilon = atof(optarg);
+			break;
+		case 'b':
+			batch_arenas = atoi(optarg);
+			break;
+		case 'l': {
+			std::istringstream names(optarg);
+			std::string name;
+			while (std::getline(names, name, ',')) {
+				if (name == "auto") {
+					auto_select = true;
+					continue;
+				}
+				const AlgorithmRegistry::Variant* variant = AlgorithmRegistry::find(name);
+				if (variant == nullptr) {
+					std::cout << "# Unknown algorithm '" << name << "'. Available algorithms:" << std::endl;
+					AlgorithmRegistry::printVariants(std::cout);
+					std::cout << "#   auto: choose per query, see AlgorithmSelector.hpp" << std::endl;
+					return 1;
+				}
+				engines.push_back(variant);
+			}
+			break;
+		}
 		case '?':
 			std::cout << "Unrecognized option: " <<  optopt << std::endl;
 			break;
@@ -123,6 +313,30 @@ int main(int argc, char ** args) {
 	readGraphFromFile(graph, graph_in);
 	graph_in.close();
 
+	std::unique_ptr<ContractionHierarchy> contraction_hierarchy;
+	if (hierarchy) {
+		tbb::tick_count start = tbb::tick_count::now();
+		contraction_hierarchy.reset(new ContractionHierarchy(graph));
+		tbb::tick_count stop = tbb::tick_count::now();
+		std::cout << "# Contraction hierarchy: " << (stop-start).seconds() << " [s], " << contraction_hierarchy->shortcutCount() 
+			<< " shortcuts, " << contraction_hierarchy->coreSize() << " core nodes" << std::endl;
+	}
+	std::unique_ptr<GraphCompression> compression;
+	if (compress) {
+		tbb::tick_count start = tbb::tick_count::now();
+		compression.reset(new GraphCompression(graph));
+		tbb::tick_count stop = tbb::tick_count::now();
+		std::cout << "# Compression: " << (stop-start).seconds() << " [s], " << compression->removedNodes() << " nodes removed, " 
+			<< compression->graph().numberOfEdges() << " edges" << std::endl;
+	}
+
+	std::unique_ptr<AlgorithmSelector> selector;
+	if (auto_select) {
+		selector.reset(new AlgorithmSelector(graph, p));
+		std::cout << "# Graph features: " << selector->features().toString() << std::endl;
+	}
+
+	std::vector<std::pair<NodeID, NodeID>> batch_queries;
 	std::string line;
 	while (std::getline(problems_in, line)) {
 		int start, end;
@@ -134,9 +348,54 @@ int main(int argc, char ** args) {
 		start_stream >> start;
 		end_stream >> end;
 
-		time(graph, NodeID(start), NodeID(end), total_instance++, instance++, graphname, verbose, iterations, p);
+		if (batch_arenas >= 0) {
+			batch_queries.emplace_back(NodeID(start), NodeID(end));
+			continue;
+		}
+		if (hierarchy) {
+			time_preprocessed<ContractionHierarchyQuery<LabelSettingAlgorithm>>(*contraction_hierarchy, NodeID(start), NodeID(end), 
+				total_instance++, instance++, graphname, verbose, worker_team, iterations, p);
+			continue;
+		}
+		if (compress) {
+			time_preprocessed<CompressedGraphQuery<LabelSettingAlgorithm>>(*compression, NodeID(start), NodeID(end), 
+				total_instance++, instance++, graphname, verbose, worker_team, iterations, p);
+			continue;
+		}
+		if (bidirectional) {
+			#ifndef PARALLEL_BUILD
+				time_bidirectional(graph, NodeID(start), NodeID(end), total_instance++, instance++, graphname, verbose, iterations);
+			#else
+				std::cout << "# Bidirectional search requires a sequential build" << std::endl;
+			#endif
+			continue;
+		}
+		if (auto_select || !engines.empty()) {
+			if (auto_select) {
+				tbb::tick_count select_start = tbb::tick_count::now();
+				const AlgorithmSelection selection = selector->select(NodeID(start));
+				tbb::tick_count select_stop = tbb::tick_count::now();
+				std::cout << "# Selected " << selection.toString() << " in " << (select_stop-select_start).seconds() << " [s]" << std::endl;
+				time_engine(graph, *selection.variant, NodeID(start), NodeID(end), total_instance, instance, graphname, verbose, one_to_one, goal_directed, worker_team, epsilon, iterations, selection.num_threads);
+			}
+			for (const AlgorithmRegistry::Variant* variant : engines) {
+				time_engine(graph, *variant, NodeID(start), NodeID(end), total_instance, instance, graphname, verbose, one_to_one, goal_directed, worker_team, epsilon, iterations, p);
+			}
+			total_instance++;
+			instance++;
+			continue;
+		}
+		time(graph, NodeID(start), NodeID(end), total_instance++, instance++, graphname, verbose, one_to_one, goal_directed, worker_team, epsilon, iterations, p);
 	}
 	problems_in.close();
+
+	if (batch_arenas >= 0) {
+		#ifdef PARALLEL_BUILD
+			time_batch(graph, batch_queries, graphname, one_to_one, goal_directed, epsilon, iterations, p, batch_arenas);
+		#else
+			std::cout << "# Batch mode requires a parallel build" << std::endl;
+		#endif
+	}
 	return 0;
 }
 
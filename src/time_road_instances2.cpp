@@ -4,6 +4,8 @@
 #include <sstream>
 #include <algorithm>
 #include <utility>
+#include <numeric>
+#include <memory>
 
 #include "BiCritShortestPathAlgorithm.hpp"
 #include "GraphGenerator.hpp"
@@ -18,16 +20,24 @@ typedef utility::datastructure::DirectedIntegerWeightedEdge TempEdge;
 typedef utility::datastructure::KGraph<TempEdge> TempGraph;
 
 
-static void time(const Graph& graph, NodeID start_node, NodeID end, int total_num, int num, std::string label, bool verbose, int iterations, int p, bool subcomponent_timings) {
+static void time(const Graph& graph, LabelSettingAlgorithm* reused_algo, NodeID start_node, NodeID end, int total_num, int num, std::string label, bool verbose, bool one_to_one, bool goal_directed, bool worker_team, double epsilon, int iterations, int p, bool subcomponent_timings) {
 	double timings[iterations];
 	double label_count[iterations];
 	double memory[iterations];
 
 	for (int i = 0; i < iterations; ++i) {
-		LabelSettingAlgorithm algo(graph, p);
+		std::unique_ptr<LabelSettingAlgorithm> own_algo(reused_algo ? NULL : new LabelSettingAlgorithm(graph, p, worker_team));
+		LabelSettingAlgorithm& algo = reused_algo ? *reused_algo : *own_algo;
+		algo.setEpsilon(epsilon);
 
 		tbb::tick_count start = tbb::tick_count::now();
-		algo.run(start_node);
+		if (goal_directed) {
+			algo.runGoalDirected(start_node, end);
+		} else if (one_to_one) {
+			algo.run(start_node, end);
+		} else {
+			algo.run(start_node);
+		}
 		tbb::tick_count stop = tbb::tick_count::now();
 
 		timings[i] = (stop-start).seconds();
@@ -43,12 +53,51 @@ static void time(const Graph& graph, NodeID start_node, NodeID end, int total_nu
 			std::cout << " " << timings[i] << std::endl;
 			std::cout << " # ";
 		}
+		if (reused_algo) {
+			algo.reset();
+		}
 	}
 	std::cout << total_num << " " << label << num << " " << pruned_average(timings, iterations, 0) << " " 
 		<< pruned_average(label_count, iterations, 0) <<  " " << pruned_average(memory, iterations, 0)/1024 << " " 
 		<< getPeakMemorySize()/1024 << " " << p << "  # time in [s], target node label count, memory [mb], peak memory [mb], p" << std::endl;
 }
 
+#ifdef PARALLEL_BUILD
+static void time_batch(const Graph& graph, const std::vector<std::pair<NodeID, NodeID>>& queries, std::string label, bool one_to_one, bool goal_directed, double epsilon, int iterations, int p, int arenas) {
+	double timings[iterations];
+	std::vector<size_t> label_count(queries.size());
+	ParetoSearchBatch<> batch(graph, p, arenas);
+
+	const auto query = [&](ParetoSearchBatch<>::Search& algo, const size_t q) {
+		const NodeID start_node = queries[q].first;
+		algo.setEpsilon(epsilon);
+		const NodeID end = queries[q].second;
+		if (goal_directed) {
+			algo.runGoalDirected(start_node, end);
+		} else if (one_to_one) {
+			algo.run(start_node, end);
+		} else {
+			algo.run(start_node);
+		}
+		label_count[q] = algo.size(end);
+	};
+	if (arenas == 0) {
+		batch.calibrate(queries.size(), query); // not part of the timings
+	}
+
+	for (int i = 0; i < iterations; ++i) {
+		tbb::tick_count start = tbb::tick_count::now();
+		batch.run(queries.size(), query);
+		tbb::tick_count stop = tbb::tick_count::now();
+		timings[i] = (stop-start).seconds();
+	}
+	const double batch_time = pruned_average(timings, iterations, 0);
+	std::cout << label << " " << queries.size() << " " << batch_time << " " << queries.size() / batch_time << " " 
+		<< std::accumulate(label_count.begin(), label_count.end(), size_t(0)) << " " << getPeakMemorySize()/1024 << " " << p << " " 
+		<< batch.arenaCount(queries.size()) << "  # queries, time in [s], queries per second, total target node label count, peak memory [mb], p, concurrent queries" << std::endl;
+}
+#endif
+
 static TempEdge::weight_type getWeightOf(TempGraph& graph, unsigned int start, unsigned int end) {
 	FORALL_EDGES(graph, NodeID(start), eid) {
 		const TempEdge& edge = graph.getEdge(eid);
@@ -109,17 +158,24 @@ static void readGraphFromFile(Graph& graph, std::ifstream& timings, std::ifstrea
 	GraphGenerator<Graph> generator;
 	generator.buildGraphFromEdges(graph, edges);
 	std::cout << "# Nodes " << graph.numberOfNodes() <<  " Edges " << graph.numberOfEdges() << std::endl;
+	checkWeightRange(graph);
 
 }
 
 int main(int argc, char ** args) {
 	std::cout << "# " << currentConfig() << std::endl;
 	bool verbose = false;
+	bool one_to_one = false;
+	bool goal_directed = false;
+	bool worker_team = false;
+	double epsilon = 0;
+	int batch_arenas = -1; // no batch
 	int iterations = 1;
 	int total_instance = 1;
 	int p = tbb::task_scheduler_init::default_num_threads();
 	int road_instance_number = 0;
 	bool subcomponent_timings = false;
+	bool reuse = false;
 
 	std::string graphname;
 	std::string directory;
@@ -128,7 +184,7 @@ int main(int argc, char ** args) {
 	std::ifstream problems_in;
 
 	int c;
-	while( (c = getopt( argc, args, "c:g:d:n:p:r:vs") ) != -1  ){
+	while( (c = getopt( argc, args, "c:g:d:n:p:r:vstawub:e:") ) != -1  ){
 		switch(c){
 		case 'd':
 			directory = optarg;
@@ -154,6 +210,24 @@ int main(int argc, char ** args) {
 		case 'v':
 			verbose = true;
 			break;
+		case 't':
+			one_to_one = true;
+			break;
+		case 'a':
+			goal_directed = true;
+			break;
+		case 'w':
+			worker_team = true;
+			break;
+		case 'e':
+			epsilon = atof(optarg);
+			break;
+		case 'b':
+			batch_arenas = atoi(optarg);
+			break;
+		case 'u':
+			reuse = true;
+			break;
 		case '?':
 			std::cout << "Unrecognized option: " <<  optopt << std::endl;
 			break;
@@ -180,6 +254,10 @@ int main(int argc, char ** args) {
 	timings_in.close();
 	ecomonics_in.close();
 
+	// Serve all queries with a single instance instead of constructing one per query
+	std::unique_ptr<LabelSettingAlgorithm> reused_algo(reuse ? new LabelSettingAlgorithm(graph, p, worker_team) : NULL);
+
+	std::vector<std::pair<NodeID, NodeID>> batch_queries;
 	std::string line;
 	while (std::getline(problems_in, line)) {
 		int start, end;
@@ -190,8 +268,10 @@ int main(int argc, char ** args) {
 
 		start_stream >> start;
 		end_stream >> end;
-		if (road_instance_number == 0 || road_instance_number == total_instance) {
-			time(graph, NodeID(start), NodeID(end), total_instance, instance, graphname, verbose, iterations, p, subcomponent_timings);
+		if (batch_arenas >= 0 && (road_instance_number == 0 || road_instance_number == total_instance)) {
+			batch_queries.emplace_back(NodeID(start), NodeID(end));
+		} else if (road_instance_number == 0 || road_instance_number == total_instance) {
+			time(graph, reused_algo.get(), NodeID(start), NodeID(end), total_instance, instance, graphname, verbose, one_to_one, goal_directed, worker_team, epsilon, iterations, p, subcomponent_timings);
 
 			if (road_instance_number != 0) {
 				break;
@@ -201,6 +281,14 @@ int main(int argc, char ** args) {
 		instance++;
 	}
 	problems_in.close();
+
+	if (batch_arenas >= 0) {
+		#ifdef PARALLEL_BUILD
+			time_batch(graph, batch_queries, graphname, one_to_one, goal_directed, epsilon, iterations, p, batch_arenas);
+		#else
+			std::cout << "# Batch mode requires a parallel build" << std::endl;
+		#endif
+	}
 	return 0;
 }
 
@@ -4,6 +4,7 @@
 #include <sstream>
 #include <algorithm>
 #include <utility>
+#include <memory>
 
 #include "BiCritShortestPathAlgorithm.hpp"
 #include "GraphGenerator.hpp"
@@ -23,15 +24,19 @@ typedef utility::datastructure::KGraph<TempEdge> TempGraph;
 // Mersenne Twister random number genrator
 boost::mt19937 gen;
 
-static void time(const Graph& graph, int nodecount, int degree, bool verbose, int iterations, int p) {
+static void time(const Graph& graph, int nodecount, int degree, bool verbose, bool reuse, int iterations, int p) {
 	double timings[iterations];
 	double label_count[iterations];
 	double memory[iterations];
 
 	boost::uniform_int<> dist(0, graph.numberOfNodes()-1);
 
+	// Serve all queries with a single instance instead of constructing one per query
+	std::unique_ptr<LabelSettingAlgorithm> reused_algo(reuse ? new LabelSettingAlgorithm(graph, p) : NULL);
+
 	for (int i = 0; i < iterations; ++i) {
-		LabelSettingAlgorithm algo(graph, p);
+		std::unique_ptr<LabelSettingAlgorithm> own_algo(reuse ? NULL : new LabelSettingAlgorithm(graph, p));
+		LabelSettingAlgorithm& algo = reuse ? *reused_algo : *own_algo;
 
 		NodeID start_node = (NodeID) dist(gen);
 		NodeID end_node = (NodeID) dist(gen);
@@ -47,6 +52,9 @@ static void time(const Graph& graph, int nodecount, int degree, bool verbose, in
 		if (verbose && i == 0) {
 			algo.printStatistics();
 		}
+		if (reuse) {
+			algo.reset();
+		}
 	}
 	std::cout << nodecount << " " << degree << " " << pruned_average(timings, iterations, 0) << " " 
 		<< pruned_average(label_count, iterations, 0) <<  " " << pruned_average(memory, iterations, 0)/1024 << " " 
@@ -65,11 +73,13 @@ static void translate_to_biweight_graph(TempGraph& temp_graph, Graph& graph) {
 	GraphGenerator<Graph> generator;
 	generator.buildGraphFromEdges(graph, edges);
 	std::cout << "# Nodes " << graph.numberOfNodes() <<  " Edges " << graph.numberOfEdges() << std::endl;
+	checkWeightRange(graph);
 }
 
 int main(int argc, char ** args) {
 	std::cout << "# " << currentConfig() << std::endl;
 	bool verbose = false;
+	bool reuse = false;
 	int iterations = 1;
 	int p = tbb::task_scheduler_init::default_num_threads();
 
@@ -77,7 +87,7 @@ int main(int argc, char ** args) {
 	std::string directory;
 
 	int c;
-	while( (c = getopt( argc, args, "c:g:d:p:v") ) != -1  ){
+	while( (c = getopt( argc, args, "c:g:d:p:vu") ) != -1  ){
 		switch(c){
 		case 'd':
 			directory = optarg;
@@ -94,6 +104,9 @@ int main(int argc, char ** args) {
 		case 'v':
 			verbose = true;
 			break;
+		case 'u':
+			reuse = true;
+			break;
 		case '?':
 			std::cout << "Unrecognized option: " <<  optopt << std::endl;
 			break;
@@ -122,6 +135,6 @@ int main(int argc, char ** args) {
 	int n;
 	int d;
 	sscanf(graphname.c_str(), "n%d_d%d", &n, &d);
-	time(graph, n, d, verbose, iterations, p);
+	time(graph, n, d, verbose, reuse, iterations, p);
 	return 0;
 }